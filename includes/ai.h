@@ -4,12 +4,99 @@
 #include "constants.h"
 #include "gameLogic.h"
 #include "board.h"
+#include "bitboard.h"
+#include "moveGen.h"
+#include "transposition.h"
+#include "solver.h"
+#include "threadPool.h"
+#include "ybwc.h"
+#include "evaluator.h"
+#include "book.h"
+#include "positionIndex.h"
+#include "rng.h"
+
+#define ORDER_MIN_DEPTH 3   // Remaining depth from which killer moves and history reorder the moves
+#define AI_DEFAULT_SEED 1   // Seed of the AI's move shuffle until aiSetSeed() is called
+
+typedef struct {
+    TranspositionTable *table;
+    const Evaluator *evaluator;             // Leaf evaluation, see aiSetEvaluator()
+    struct timespec start;
+    struct timespec deadline;   // Time at which a timed search stops
+    bool timed;                 // True if the deadline applies
+    bool stopped;               // Set once the deadline has passed, the running iteration is then discarded
+    bool root_threads;          // Searches the root on the threads of aiSetThreads()/aiSetYbwcThreads()
+    int max_depth;              // Depth of an untimed aiSearchMove(), MAX_DEPTH by default
+    Rng *rng;                   // Generator of aiSearchMove()'s move shuffle, NULL for the AI's own one
+    uint64_t nodes;             // Positions visited
+    int killers[ROWS * COLS][2];            // Per ply, the last two moves that caused a cutoff (-1 if none)
+    uint32_t history[2][ROWS * COLS];       // Per side and cell, how often (and how deep) a move caused a cutoff
+    uint64_t cutoffs;                       // Nodes cut off by a move
+    uint64_t first_cutoffs;                 // Nodes cut off by the first move searched
+    uint64_t ply_cutoffs[ROWS * COLS];      // Cutoffs per ply
+    uint64_t leaves;                        // Positions evaluated at the horizon or at the end of the game
+    uint64_t tt_probes;                     // Transposition table lookups
+    uint64_t tt_hits;                       // Lookups that found the position
+    int max_ply;                            // Deepest ply reached
+    uint64_t iteration_nodes[2];            // Nodes of the two last completed iterations
+    const char *source;                     // How aiSearchMove() chose: "search", "solution", "book" or "forced"
+    int score;                              // Score of the best move of the last completed iteration, 0 if none
+} SearchContext;
+
+// What a search did to choose a move, see searchStatsFill()
+typedef struct {
+    const char *source;                     // "search", "solution", "book", "forced" or "none"
+    int row;                                // The move chosen, -1 if there was none
+    int col;
+    int depth;                              // Last completed iteration, 0 without a search
+    int score;                              // Score of the move for the side to move, 0 without a search
+    int max_ply;                            // Deepest ply reached
+    uint64_t nodes;
+    uint64_t leaves;
+    uint64_t tt_probes;
+    uint64_t tt_hits;
+    uint64_t cutoffs;
+    uint64_t first_cutoffs;
+    uint64_t ply_cutoffs[ROWS * COLS];
+    double branching;                       // Effective branching factor, 0 before two iterations are completed
+    int elapsed_ms;                         // Wall time since the context was initialized
+} SearchStats;
 
 bool destroySquares(int board[ROWS][COLS], int row, int col);
 int evaluateBoard(int board[ROWS][COLS]);
+int evaluateBitboard(Bitboard board);
 int minimax(int board[ROWS][COLS], int depth, bool isMaximizing, int alpha, int beta);
+int minimaxBitboard(Bitboard board, int depth, bool isMaximizing, int alpha, int beta);
+int minimaxContext(SearchContext *ctx, Bitboard board, int depth, bool isMaximizing, int alpha, int beta);
+TranspositionTable *aiTranspositionTable(void);
+bool aiSetHashSize(int size_mb);
+int aiHashBits(void);
+bool aiSetEvaluator(const char *name);
+const Evaluator *aiEvaluator(void);
+void initSearchContext(SearchContext *ctx, TranspositionTable *table, int budget_ms);
+int searchElapsedMs(SearchContext *ctx);
+double searchFirstCutoffRate(SearchContext *ctx);
+void searchStatsFill(SearchContext *ctx, int depth, int row, int col, SearchStats *stats);
+void searchStatsPrintJson(const SearchStats *stats, FILE *file);
+const SearchStats *aiLastStats(void);
+void aiSetStatsOutput(bool enabled);
+void aiReportStats(const SearchStats *stats);
+bool aiSetThreads(int num_threads);
+bool aiSetYbwcThreads(int num_threads);
+int iterativeDeepening(SearchContext *ctx, Bitboard board, int moves[][2], int num_moves, int max_depth);
 void shuffleMoves(int moves[][2], int num_moves);
+void shuffleMovesSeeded(int moves[][2], int num_moves, Rng *rng);
+void sortMovesByPrior(const PositionIndex *index, Bitboard board, int moves[][2], int num_moves);
+void aiSetSeed(uint64_t seed);
+uint64_t aiSeed(void);
+bool aiLoadSolution(const char *path);
+bool aiLoadBook(const char *path);
+bool aiLoadPositionIndex(const char *path);
+void aiSetTimeBudget(int budget_ms);
+int aiTimeBudget(void);
 void aiChooseMove(int board[ROWS][COLS], int *best_row, int *best_col);
+void aiChooseMoveTimed(int board[ROWS][COLS], int budget_ms, int *best_row, int *best_col);
+int aiSearchMove(SearchContext *ctx, Bitboard board, int *best_row, int *best_col);
 void executeMove(int board[ROWS][COLS], int row, int col);
 void receiveOpponentMove(int board[ROWS][COLS], int row, int col);
 
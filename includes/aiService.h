@@ -0,0 +1,52 @@
+#ifndef AISERVICE_H
+#define AISERVICE_H
+
+#include "constants.h"
+#include "ai.h"
+
+#define AI_SERVICE_QUEUE 256        // Requests waiting for a search thread, see aiServiceSubmit()
+#define AI_SERVICE_MIN_BITS 16      // Smallest table of a search thread (1 MiB)
+
+// A move to compute, then its result
+typedef struct AiRequest {
+    void *tag;                      // Caller's data, returned with the result
+    Bitboard board;
+    int budget_ms;                  // Time budget, 0 for the fixed MAX_DEPTH
+    uint64_t stream;                // Random stream of the move shuffle, numbered in submission order
+    int row;                        // Move chosen, -1 if there is none
+    int col;
+    SearchStats stats;              // What the search did, see searchStatsFill()
+    struct AiRequest *next;         // Next completed request
+} AiRequest;
+
+typedef struct {
+    void *tag;
+    int row;
+    int col;
+    SearchStats stats;              // Reported with aiReportStats() by the thread that collects it
+} AiResult;
+
+// Searches moves on a pool of threads and reports them through an eventfd, for an event loop
+typedef struct {
+    ThreadPool pool;
+    int num_threads;
+    int capacity;
+    int pending;                    // Requests submitted and not collected yet
+    int event_fd;                   // Readable while completed requests wait to be collected
+    pthread_mutex_t lock;
+    AiRequest *done_head;           // Completed requests, oldest first
+    AiRequest *done_tail;
+    TranspositionTable *tables;     // One table per search thread
+    TranspositionTable **free_tables;
+    int num_free;
+    uint64_t seed;                  // Seed of the move shuffles, the AI's one (see aiSetSeed()) when started
+    uint64_t next_stream;
+} AiService;
+
+bool aiServiceInit(AiService *service, int num_threads, int capacity, int table_bits);
+bool aiServiceSubmit(AiService *service, Bitboard board, int budget_ms, void *tag);
+int aiServiceCollect(AiService *service, AiResult *results, int max_results);
+int aiServiceFd(AiService *service);
+void aiServiceDestroy(AiService *service);
+
+#endif //AISERVICE_H
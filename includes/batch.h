@@ -0,0 +1,42 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "constants.h"
+#include "ai.h"
+#include "threadPool.h"
+
+#define BATCH_TABLE_BITS 16     // Table of each thread, cleared before every position
+
+// One position to analyse, and what the search found
+typedef struct {
+    Bitboard board;             // The position, the side to move being the maximizing player
+    int row;                    // The best move, -1 if the position has no move
+    int col;
+    int score;                  // Score of the best move, 0 if it was forced
+    int depth;                  // Depth of the last completed iteration
+    uint64_t nodes;             // Positions visited
+} BatchPosition;
+
+typedef struct {
+    int num_threads;
+    int depth;                  // Depth of every search, used without a time budget
+    int budget_ms;              // Time budget per position, 0 to search to the depth
+    const Evaluator *evaluator; // Leaf evaluation, NULL for the AI's one
+    uint64_t seed;              // Seed of the move shuffles, combined with the index of each position
+} BatchOptions;
+
+// A set of search threads, each with its own transposition table, analysing arrays of positions
+typedef struct {
+    BatchOptions options;
+    ThreadPool pool;
+    TranspositionTable *tables;
+    BatchPosition *positions;   // Array of the running batchEvaluate() call
+    int count;
+    atomic_int next;            // Next position to search
+} BatchEvaluator;
+
+bool batchInit(BatchEvaluator *batch, const BatchOptions *options);
+void batchEvaluate(BatchEvaluator *batch, BatchPosition *positions, int count);
+void batchDestroy(BatchEvaluator *batch);
+
+#endif //BATCH_H
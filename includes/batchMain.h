@@ -0,0 +1,13 @@
+#ifndef BATCHMAIN_H
+#define BATCHMAIN_H
+
+#include "batch.h"
+#include "staircase.h"
+
+#define BATCH_DEPTH 8           // Depth of the searches by default
+#define BATCH_CHUNK 4096        // Lines read before a batch is searched and its results written
+#define BATCH_LINE_SIZE 256
+
+int main(int argc, char *argv[]);
+
+#endif //BATCHMAIN_H
@@ -0,0 +1,24 @@
+#ifndef BENCHMAIN_H
+#define BENCHMAIN_H
+
+#include "ai.h"
+#include "gameLogic.h"
+#include "sizedBoard.h"
+
+#define BENCH_REPEATS 5         // Measurements per benchmark, the median is reported
+#define BENCH_MIN_NS 20000000L  // Minimum duration of one measurement (20 ms)
+#define BENCH_TABLE_BITS 14     // The AI's table is shrunk so that clearing it between calls stays cheap
+#define BENCH_SIZED_DEPTH 4     // Depth of the runtime-size searches
+
+// Result of one benchmark, one JSON object in the output
+typedef struct {
+    char name[64];
+    uint64_t iterations;        // Operations in the median measurement
+    double ns_per_op;
+    double nodes_per_sec;       // 0 for operations that do not search
+    double allocs_per_op;
+} BenchResult;
+
+int main(int argc, char *argv[]);
+
+#endif //BENCHMAIN_H
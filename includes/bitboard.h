@@ -0,0 +1,25 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "constants.h"
+
+// One bit per square, bit (row * COLS + col) is set while the square is still present
+typedef uint64_t Bitboard;
+
+#define BB_INDEX(row, col) ((row) * COLS + (col))
+#define BB_CELL(row, col) ((Bitboard) 1 << BB_INDEX(row, col))
+#define BB_FULL ((((Bitboard) 1) << (ROWS * COLS)) - 1)
+
+Bitboard boardToBitboard(int board[ROWS][COLS]);
+void bitboardToBoard(Bitboard bb, int board[ROWS][COLS]);
+Bitboard bitboardQuadrant(int row, int col);
+int bitboardCount(Bitboard bb);
+bool bitboardCanDestroy(Bitboard bb, int row, int col);
+int bitboardCountSquares(Bitboard bb, int row, int col);
+bool bitboardIsLegalMove(Bitboard bb, int row, int col);
+bool bitboardDestroySquares(Bitboard *bb, int row, int col);
+Bitboard bitboardRowMoves(const uint8_t lengths[ROWS], int row);
+Bitboard bitboardLegalMoves(Bitboard bb);
+int bitboardRowLength(Bitboard bb, int row);
+
+#endif //BITBOARD_H
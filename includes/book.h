@@ -0,0 +1,47 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include "constants.h"
+#include "bitboard.h"
+#include "staircase.h"
+
+#define BOOK_MAGIC "CHBK"
+#define BOOK_VERSION 1
+#define BOOK_MAX_MOVES 8        // Moves kept per position, all with the best score
+
+typedef struct {
+    char magic[4];
+    uint8_t version;            // BOOK_VERSION
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t move_limit;
+    uint8_t plies;              // Positions up to this many moves from the start are covered
+    uint8_t depth;              // Depth of the searches that scored them
+    uint16_t reserved;
+    uint32_t count;             // Number of entries
+} BookHeader;
+
+// A move of a book position, entries being sorted by position then move
+typedef struct {
+    uint32_t rank;              // staircaseRank() of the position
+    int16_t score;              // Score of the move for the player to move, see evaluator.h
+    uint8_t cell;               // Cell index of the move (row * COLS + col)
+    uint8_t reserved;
+} BookEntry;
+
+typedef struct {
+    const BookEntry *entries;   // Point into the mapping of the file
+    uint32_t count;
+    void *map;
+    size_t map_size;
+} OpeningBook;
+
+int bookPositions(int plies, Bitboard **positions);
+int compareBookEntries(const void *a, const void *b);
+bool saveBook(const BookEntry *entries, uint32_t count, int plies, int depth, const char *path);
+bool loadBook(OpeningBook *book, const char *path);
+void freeBook(OpeningBook *book);
+int bookLookup(const OpeningBook *book, Bitboard board, const BookEntry **first);
+bool bookBestMove(const OpeningBook *book, Bitboard board, int *best_row, int *best_col);
+
+#endif //BOOK_H
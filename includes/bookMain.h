@@ -0,0 +1,24 @@
+#ifndef BOOKMAIN_H
+#define BOOKMAIN_H
+
+#include "ai.h"
+#include "book.h"
+
+#define BOOK_PLIES 4            // Moves from the start covered by default
+#define BOOK_DEPTH 14           // Depth of the searches by default
+#define BOOK_TABLE_BITS 20      // Table of each thread, kept from one position to the next
+#define BOOK_OUT "chomp.book"
+
+// Positions shared by the threads of the generator
+typedef struct {
+    Bitboard *positions;
+    int num_positions;
+    int depth;
+    BookEntry *entries;         // BOOK_MAX_MOVES entries per position
+    int *counts;                // Entries filled for each position
+    atomic_int next;            // Next position to search
+} BookJob;
+
+int main(int argc, char *argv[]);
+
+#endif //BOOKMAIN_H
@@ -4,9 +4,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <ctype.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <errno.h>
 
 #ifdef USE_GUI
 #include <gtk/gtk.h>
@@ -18,11 +26,17 @@
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <poll.h>
 
 
 #define ROWS 7
 #define COLS 9
 #define MAX_DEPTH 5
+#define MOVE_LIMIT 5
 #define INF 1000 
 
 #endif //CONSTANTS_H
@@ -0,0 +1,26 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "constants.h"
+#include "bitboard.h"
+
+#define EVAL_WIN 500        // Score of a game won at the root, a win found n plies deeper scores EVAL_WIN - n
+#define EVAL_MATE 400       // Scores beyond +/- EVAL_MATE are wins or losses at a known distance
+#define EVAL_KNOWN 300      // Score of a position known to be won, at an unknown distance
+#define EVAL_TEMPO 10       // Bonus of the player to move in an unknown position
+#define EVAL_DEFAULT "staircase"
+
+// A leaf evaluation. Scores are given from the maximizing player's point of view; 'terminal' is set
+// when the game is over, in which case the search must not go deeper.
+typedef struct {
+    const char *name;
+    const char *description;
+    int (*evaluate)(Bitboard board, bool isMaximizing, int ply, bool *terminal);
+} Evaluator;
+
+const Evaluator *evaluatorByName(const char *name);
+const Evaluator *evaluatorAt(int index);
+int evalScoreToTable(int score, int ply);
+int evalScoreFromTable(int score, int ply);
+
+#endif //EVALUATOR_H
@@ -4,8 +4,14 @@
 #include "localMain.h"
 #include "clientMain.h"
 #include "serverMain.h"
+#include "lobby.h"
 
 bool checkIa(int argc, char *argv[]);
+bool checkFlag(int argc, char *argv[], char *name);
+bool optionTakesValue(char *arg);
+char *extractOption(int argc, char *argv[], char *name);
+bool extractIpPort(int argc, char *argv[], char *ip, int *port);
+bool extractPort(int argc, char *argv[], int *port);
 void printUsage(char *prog_name);
 int main(int argc, char *argv[]);
 
@@ -0,0 +1,82 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include "constants.h"
+#include "sizedBoard.h"
+#include "positionIndex.h"
+#include "threadPool.h"
+
+#define RECORD_MAGIC "CHGR"
+#define RECORD_VERSION 1
+#define RECORD_FILE_HEADER_SIZE 8       // Magic, version and 3 reserved bytes
+#define RECORD_GAME_HEADER_SIZE 6       // Rows, columns, loser, a reserved byte and the 16-bit move count
+#define RECORD_MAX_MOVES (BOARD_MAX_ROWS * BOARD_MAX_COLS)
+#define RECORD_FIRST_LOSES 0            // The player who moved first lost
+#define RECORD_SECOND_LOSES 1
+#define RECORD_UNFINISHED 0xFF          // The game stopped before anyone lost (disconnection, quit)
+#define RECORD_SNAPSHOT_INTERVAL 16     // Plies between two boards kept by a replay
+
+// A game being played, one byte per move: its cell index row * cols + col
+typedef struct {
+    int rows;
+    int cols;
+    int num_moves;
+    uint8_t moves[RECORD_MAX_MOVES];
+} GameRecord;
+
+// A record file mapped in memory, with the offset of every game to reach any of them at once
+typedef struct {
+    uint64_t count;             // Number of complete games
+    uint64_t *offsets;          // Offset of each game's header
+    void *map;
+    size_t map_size;
+} RecordFile;
+
+// A game of a record file, its moves pointing into the mapping
+typedef struct {
+    int rows;
+    int cols;
+    int loser;                  // RECORD_FIRST_LOSES, RECORD_SECOND_LOSES or RECORD_UNFINISHED
+    int num_moves;
+    const uint8_t *moves;
+} RecordGame;
+
+// A game checked once, with its board every RECORD_SNAPSHOT_INTERVAL plies so that any ply is
+// reached by replaying fewer than RECORD_SNAPSHOT_INTERVAL moves
+typedef struct {
+    RecordGame game;
+    int num_snapshots;
+    SizedBoard snapshots[RECORD_MAX_MOVES / RECORD_SNAPSHOT_INTERVAL + 1];
+} RecordReplay;
+
+// The games of every record file counted by one thread of recordIndexPositions()
+typedef struct {
+    const RecordFile *files;
+    int num_files;
+    int slice;                  // Games slice * count / num_slices to (slice + 1) * count / num_slices of each file
+    int num_slices;
+    PositionEntry *counts;      // One entry per staircase rank
+    uint32_t games;
+    uint64_t positions;
+} CountTask;
+
+void gameRecordInit(GameRecord *record, int rows, int cols);
+bool gameRecordAddMove(GameRecord *record, int row, int col);
+bool recordOpen(const char *path);
+bool recordAppend(const GameRecord *record, int loser);
+void recordClose(void);
+void recordStartGame(int rows, int cols);
+void recordMove(int row, int col);
+void recordEndGame(int loser);
+bool loadRecords(RecordFile *file, const char *path);
+void freeRecords(RecordFile *file);
+bool recordGameAt(const RecordFile *file, uint64_t index, RecordGame *game);
+bool replayInit(RecordReplay *replay, const RecordGame *game);
+bool replaySeek(const RecordReplay *replay, int ply, SizedBoard *board);
+void recordApplyMove(SizedBoard *board, int cell);
+uint32_t recordCountPositions(const RecordFile *file, uint64_t first, uint64_t end, PositionEntry *counts,
+                              uint64_t *positions);
+bool recordIndexPositions(const RecordFile *files, int num_files, int num_threads, PositionEntry *counts,
+                          uint32_t *games, uint64_t *positions);
+
+#endif //GAMERECORD_H
@@ -2,10 +2,14 @@
 #define GUI_H
 
 #include <gtk/gtk.h>
+#include <glib-unix.h>
 
 #include "client.h"
 #include "server.h"
+#include "protocol.h"
 #include "ai.h"
+#include "aiService.h"
+#include "gameRecord.h"
 
 typedef struct {
     int board[ROWS][COLS];
@@ -16,8 +20,8 @@ typedef struct {
     bool first_turn_done;
     bool serverMode;
     bool clientMode;
-    int sock;
-    int new_socket;
+    Channel *channel;   // Connection to the opponent, NULL in a local game
+    AiService ai_service;   // Searches the AI's moves off the GTK main loop
     GtkWidget *player_label;
     GtkWidget *timer_label;
     guint timer_id;
@@ -41,9 +45,13 @@ void onButtonClicked(GtkWidget *widget, gpointer data);
 
 gboolean aiPlayMove(gpointer data);
 
+gboolean onAiMoveReady(gint fd, GIOCondition condition, gpointer data);
+
 void activate(GtkApplication *app, gpointer user_data);
 
-int mainGui(bool ai, bool serverMode, bool clientMode, int sock, int new_socket);
+int mainGui(bool ai, bool serverMode, bool clientMode, Channel *channel);
+
+bool receiveMoveGUI(GameData *game, int *row, int *col);
 
 void updatePlayerLabel(GtkWidget *label, int player, bool ai);
 
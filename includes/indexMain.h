@@ -0,0 +1,11 @@
+#ifndef INDEXMAIN_H
+#define INDEXMAIN_H
+
+#include "gameRecord.h"
+#include "positionIndex.h"
+
+#define INDEX_DEFAULT_OUT "positions.chpi"   // Index written without -out
+
+int main(int argc, char *argv[]);
+
+#endif //INDEXMAIN_H
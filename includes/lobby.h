@@ -0,0 +1,83 @@
+#ifndef LOBBY_H
+#define LOBBY_H
+
+#include "constants.h"
+#include "bitboard.h"
+#include "ai.h"
+#include "protocol.h"
+#include "aiService.h"
+#include "gameRecord.h"
+
+#define LOBBY_MAX_EVENTS 256        // Events handled per call to epoll_wait()
+#define LOBBY_BACKLOG 1024          // Pending connections of the listening socket
+#define LOBBY_PAIR_TIMEOUT_MS 3000  // A client left alone this long plays against the AI
+#define LOBBY_TICK_MS 250           // Longest sleep of the event loop, to check the waiting clients
+#define LOBBY_OUT_SIZE 256          // Bytes waiting to be sent to one client
+#define LOBBY_AI_RESULTS 64         // AI moves collected per wake-up of the event loop
+
+typedef enum {
+    CONN_HELLO,     // Connected, its hello not received yet
+    CONN_WAITING,   // Said hello, waits for an opponent
+    CONN_PLAYING,   // Seated in a game
+    CONN_CLOSING    // Game over: closed once its last messages are sent
+} ConnectionState;
+
+struct LobbyGame;
+
+// One client connection and its state machine
+typedef struct LobbyConnection {
+    int fd;
+    ConnectionState state;
+    struct LobbyGame *game;
+    int seat;                           // 0 moves first, 1 second
+    uint8_t in[PROTOCOL_BUFFER_SIZE];   // Frames being received
+    int in_len;
+    uint8_t out[LOBBY_OUT_SIZE];        // Frames not sent yet
+    int out_len;
+    uint32_t next_seq;                  // Sequence number of the next frame sent
+    bool writable;                      // False while the kernel buffer is full (EPOLLOUT armed)
+    struct timespec since;              // Time the connection started waiting for an opponent
+    struct LobbyConnection *next;       // Next waiting connection, or next closed one
+    struct LobbyConnection *prev;
+    struct LobbyConnection *all_next;   // Every open connection, to close them with the lobby
+    struct LobbyConnection *all_prev;
+} LobbyConnection;
+
+// A game between two seats; a NULL player is the AI
+typedef struct LobbyGame {
+    Bitboard board;
+    LobbyConnection *players[2];
+    int turn;                           // Seat to move
+    bool over;
+    GameRecord record;                  // Moves played, appended to the record file when the game ends
+    bool thinking;                      // The AI service searches its move; the game is kept until it answers
+    bool backlogged;                    // Waits for room in the AI service's queue
+    struct LobbyGame *next_ai;          // Next game waiting for room in the AI service's queue
+    struct LobbyGame *next_dead;        // Next game freed at the end of the loop iteration
+} LobbyGame;
+
+typedef struct {
+    int listen_fd;
+    int epoll_fd;
+    bool ai_only;                       // Every client plays the AI at once
+    int pair_timeout_ms;
+    atomic_bool running;
+    LobbyConnection *waiting_head;      // Clients waiting for an opponent, oldest first
+    LobbyConnection *waiting_tail;
+    LobbyConnection *all;               // Every open connection
+    LobbyConnection *graveyard;         // Closed during the current loop iteration, freed at its end
+    LobbyGame *dead_games;              // Games whose clients are all closed, freed with the graveyard
+    AiService ai;                       // Searches the AI's moves off the event loop
+    LobbyGame *ai_backlog;              // Games whose AI move could not be queued yet
+    uint64_t connections;               // Open client connections
+    uint64_t games_started;
+    uint64_t games_finished;
+} Lobby;
+
+bool lobbyInit(Lobby *lobby, int port, bool ai_only);
+void lobbyRun(Lobby *lobby);
+void lobbyStop(Lobby *lobby);
+void lobbyDestroy(Lobby *lobby);
+void lobbyMain(int port, bool ai);
+
+#endif //LOBBY_H
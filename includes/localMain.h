@@ -2,7 +2,8 @@
 #define LOCALMAIN_H
 
 #include "gui.h"
+#include "sizedBoard.h"
 
-void localMain(bool ai, bool gui);
+void localMain(bool ai, bool gui, int rows, int cols);
 
 #endif //LOCALMAIN_H
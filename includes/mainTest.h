@@ -5,5 +5,20 @@
 #include "testBoard.h"
 #include "testGameLogic.h"
 #include "testAI.h"
+#include "testBitboard.h"
+#include "testMoveGen.h"
+#include "testRng.h"
+#include "testTransposition.h"
+#include "testStaircase.h"
+#include "testSolver.h"
+#include "testBook.h"
+#include "testBatch.h"
+#include "testGameRecord.h"
+#include "testPositionIndex.h"
+#include "testEvaluator.h"
+#include "testSizedBoard.h"
+#include "testAiService.h"
+#include "testProtocol.h"
+#include "testLobby.h"
 
 #endif //MAINTEST_H
@@ -0,0 +1,41 @@
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "constants.h"
+#include "bitboard.h"
+#include "transposition.h"
+
+#define POSITION_MAX_MOVES (ROWS * COLS)  // Depth of the undo stack: a game never lasts more moves than squares
+
+// A position with its legal moves, kept up to date move after move from the staircase frontier
+typedef struct {
+    Bitboard board;             // Squares still present
+    Bitboard legal;             // Legal moves of the position
+    uint8_t lengths[ROWS];      // Squares left on each row, the frontier the legal moves are read from
+} MoveGen;
+
+// What moveGenUnmake() needs to take a move back
+typedef struct {
+    Bitboard removed;           // Squares destroyed by the move
+    Bitboard legal;             // Legal moves before the move
+    uint8_t row;                // First row shortened by the move
+    uint8_t end;                // Row after the last row shortened by the move
+} MoveUndo;
+
+// The one board a search thread plays on: makeMove() and unmakeMove() update it in place,
+// with an undo record per move played, so no position is ever copied from node to node
+typedef struct {
+    MoveGen gen;
+    uint64_t hash;                          // Zobrist hash of the board and of the player to move
+    int num_moves;                          // Moves on the undo stack
+    MoveUndo undo[POSITION_MAX_MOVES];
+} Position;
+
+void moveGenInit(MoveGen *gen, Bitboard board);
+void moveGenMake(MoveGen *gen, int cell, MoveUndo *undo);
+void moveGenUnmake(MoveGen *gen, const MoveUndo *undo);
+void positionInit(Position *pos, Bitboard board, bool isMaximizing);
+void makeMove(Position *pos, int cell);
+void unmakeMove(Position *pos);
+
+#endif //MOVEGEN_H
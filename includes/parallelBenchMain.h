@@ -0,0 +1,11 @@
+#ifndef PARALLELBENCHMAIN_H
+#define PARALLELBENCHMAIN_H
+
+#include "ai.h"
+#include "ybwc.h"
+
+#define PARALLEL_BENCH_MIN_SECONDS 1.0  // Without a depth given, each position is searched deep enough to take this long
+
+int main(int argc, char *argv[]);
+
+#endif //PARALLELBENCHMAIN_H
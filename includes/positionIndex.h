@@ -0,0 +1,44 @@
+#ifndef POSITIONINDEX_H
+#define POSITIONINDEX_H
+
+#include "constants.h"
+#include "bitboard.h"
+#include "staircase.h"
+
+#define POSITION_INDEX_MAGIC "CHPI"
+#define POSITION_INDEX_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint8_t version;            // POSITION_INDEX_VERSION
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t reserved;
+    uint32_t count;             // Number of entries
+    uint32_t games;             // Number of games indexed
+} PositionIndexHeader;
+
+// A position met in the recorded games, entries being sorted by rank
+typedef struct {
+    uint32_t rank;              // staircaseRank() of the position
+    uint32_t count;             // Times the position was reached, one per game at most
+    uint32_t wins;              // Games won by the player to move in the position
+    uint32_t losses;            // Games lost by that player, the others were not finished
+} PositionEntry;
+
+typedef struct {
+    const PositionEntry *entries;   // Point into the mapping of the file
+    uint32_t count;
+    uint32_t games;
+    void *map;
+    size_t map_size;
+} PositionIndex;
+
+uint32_t buildPositionIndex(PositionEntry *counts);
+bool savePositionIndex(const PositionEntry *entries, uint32_t count, uint32_t games, const char *path);
+bool loadPositionIndex(PositionIndex *index, const char *path);
+void freePositionIndex(PositionIndex *index);
+const PositionEntry *positionIndexLookup(const PositionIndex *index, Bitboard board);
+double positionIndexWinRate(const PositionIndex *index, Bitboard board);
+
+#endif //POSITIONINDEX_H
@@ -0,0 +1,69 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "constants.h"
+
+#define PROTOCOL_VERSION 1              // Version byte of every frame, frames of other versions are rejected
+#define PROTOCOL_HEADER_SIZE 8          // Length (2 bytes) + version (1) + type (1) + sequence number (4)
+#define PROTOCOL_MAX_PAYLOAD 4          // Largest payload of a message type
+#define PROTOCOL_MAX_FRAME (PROTOCOL_HEADER_SIZE + PROTOCOL_MAX_PAYLOAD)
+#define PROTOCOL_BUFFER_SIZE 256        // Bytes buffered by a channel in each direction
+#define PROTOCOL_ANY_SEAT 0xFF          // Seat asked for by a client's hello: the server chooses
+
+typedef enum {
+    MSG_HELLO = 1,      // Handshake: a client says hello, the server answers with the client's seat
+    MSG_MOVE,           // A move (row and column indices)
+    MSG_ACK,            // A move or a ping was received and accepted
+    MSG_RESIGN,         // The sender gives up the game
+    MSG_GAME_OVER,      // Sent by the server when a game ends, for any reason
+    MSG_PING            // Liveness check, answered with an ack
+} MessageType;
+
+typedef enum {
+    OVER_A1_EATEN,      // The loser ate A1
+    OVER_RESIGNED,      // The loser resigned
+    OVER_ILLEGAL_MOVE,  // The loser sent an illegal or out-of-turn move
+    OVER_DISCONNECTED   // The loser closed its connection or broke the protocol
+} GameOverReason;
+
+// A decoded message; only the payload of its type is meaningful
+typedef struct {
+    uint8_t version;
+    uint8_t type;
+    uint32_t seq;                       // Sequence number, counted per sender and connection
+    union {
+        struct { uint8_t seat, rows, cols; } hello;   // Seat 0 moves first, 1 second
+        struct { uint8_t row, col; } move;
+        struct { uint32_t seq; } ack;                 // Sequence number of the acknowledged message
+        struct { uint8_t loser, reason; } over;       // Seat of the loser and a GameOverReason
+    };
+} Message;
+
+// Blocking side of a connection: numbers the messages sent, batches them and reassembles received frames
+typedef struct {
+    int fd;
+    uint32_t next_seq;
+    uint8_t in[PROTOCOL_BUFFER_SIZE];
+    size_t in_len;
+    uint8_t out[PROTOCOL_BUFFER_SIZE];
+    size_t out_len;
+} Channel;
+
+int protocolPayloadSize(int type);
+int protocolEncode(const Message *msg, uint8_t *buffer, size_t size);
+int protocolDecode(const uint8_t *buffer, size_t length, Message *msg);
+const char *protocolReasonName(int reason);
+
+void channelInit(Channel *channel, int fd);
+bool channelQueue(Channel *channel, Message *msg);
+bool channelFlush(Channel *channel);
+bool channelSend(Channel *channel, Message *msg);
+bool channelReceive(Channel *channel, Message *msg);
+bool channelSendHello(Channel *channel, int seat);
+bool channelSendMove(Channel *channel, int row, int col);
+bool channelSendGameOver(Channel *channel, int loser, int reason);
+bool channelAck(Channel *channel, uint32_t seq);
+int channelReceiveMove(Channel *channel, int *row, int *col, Message *msg);
+int channelWaitFor(Channel *channel, int fd, Message *msg);
+
+#endif //PROTOCOL_H
@@ -0,0 +1,8 @@
+#ifndef REPLAYMAIN_H
+#define REPLAYMAIN_H
+
+#include "gameRecord.h"
+
+int main(int argc, char *argv[]);
+
+#endif //REPLAYMAIN_H
@@ -0,0 +1,17 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include "constants.h"
+
+// State of a xoshiro256** generator, owned by one thread: no lock, no shared state
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+void rngSeed(Rng *rng, uint64_t seed);
+void rngSeedStream(Rng *rng, uint64_t seed, uint64_t stream);
+uint64_t rngNext(Rng *rng);
+uint32_t rngBelow(Rng *rng, uint32_t bound);
+uint64_t rngClockSeed(void);
+
+#endif //RNG_H
@@ -0,0 +1,37 @@
+#ifndef SELFPLAYMAIN_H
+#define SELFPLAYMAIN_H
+
+#include "ai.h"
+#include "board.h"
+
+#define SELFPLAY_GAMES 100          // Games played by default
+#define SELFPLAY_TABLE_BITS 16      // Table of each side on each thread, cleared before every game
+#define SELFPLAY_OUT "selfplay.csv" // Default CSV output
+
+// Settings of one side of the tournament
+typedef struct {
+    int depth;                      // Search depth
+    const Evaluator *evaluator;
+    uint64_t seed;                  // Base seed of the move shuffle, combined with the game number
+} SideConfig;
+
+// One game, one CSV row; sides are 0 (A) and 1 (B)
+typedef struct {
+    int first;                      // Side moving first, A in even games and B in odd ones
+    int winner;
+    int plies;
+    int moves[2];                   // Moves played by each side
+    uint64_t nodes[2];              // Positions searched by each side
+    double seconds[2];              // Thinking time of each side
+} GameResult;
+
+typedef struct {
+    SideConfig sides[2];
+    int num_games;
+    GameResult *results;
+    atomic_int next_game;           // Next game to be played by a thread
+} Tournament;
+
+int main(int argc, char *argv[]);
+
+#endif //SELFPLAYMAIN_H
@@ -0,0 +1,36 @@
+#ifndef SIZEDBOARD_H
+#define SIZEDBOARD_H
+
+#include "constants.h"
+#include "staircase.h"
+#include "ai.h"
+
+#define BOARD_MAX_ROWS 16   // Largest board chosen at runtime, columns are labelled A to P
+#define BOARD_MAX_COLS 16
+#define PACKED_MAX_ROWS 8   // Boards of up to 8 rows are searched with one row length per byte of a word
+#define PACKED_LANES 0x0101010101010101ULL  // 1 in every byte of a packed board
+
+// A board whose size is chosen at runtime, stored as the number of squares left on each row
+// (every Chomp position is a staircase, see StaircaseState). Only the first 'rows' lengths are used.
+typedef struct {
+    int rows;
+    int cols;
+    uint8_t lengths[BOARD_MAX_ROWS];
+} SizedBoard;
+
+bool sizedBoardInit(SizedBoard *board, int rows, int cols);
+bool sizedBoardParseSize(const char *text, int *rows, int *cols);
+bool sizedBoardIsDefault(const SizedBoard *board);
+StaircaseState sizedBoardToStaircase(const SizedBoard *board);
+void sizedBoardDisplay(const SizedBoard *board);
+int sizedBoardSquares(const SizedBoard *board);
+bool sizedBoardCanDestroy(const SizedBoard *board, int row, int col);
+int sizedBoardCountSquares(const SizedBoard *board, int row, int col);
+bool sizedBoardDestroySquares(SizedBoard *board, int row, int col);
+int sizedBoardLegalMoves(const SizedBoard *board, int moves[][2]);
+int sizedBoardNegamax(const SizedBoard *board, int depth, uint64_t *nodes);
+int sizedBoardNegamaxGeneric(const SizedBoard *board, int depth, uint64_t *nodes);
+int sizedBoardSearchMove(SearchContext *ctx, const SizedBoard *board, int *best_row, int *best_col);
+void sizedBoardChooseMove(const SizedBoard *board, int *best_row, int *best_col);
+
+#endif //SIZEDBOARD_H
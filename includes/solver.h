@@ -0,0 +1,39 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "constants.h"
+#include "bitboard.h"
+#include "staircase.h"
+
+#define SOLUTION_MAGIC "CHMP"
+#define SOLUTION_VERSION 2      // Version 1 files had no version byte nor checksum
+#define SOLUTION_WIN 0x80       // Set when the player to move wins with perfect play
+#define SOLUTION_DISTANCE 0x7f  // Number of moves left until the board is empty with perfect play
+
+typedef struct {
+    char magic[4];
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t move_limit;
+    uint8_t version;    // SOLUTION_VERSION
+    uint32_t count;     // Number of positions, one result byte each
+    uint32_t checksum;  // FNV-1a of the results, see solutionChecksum()
+} SolutionHeader;
+
+typedef struct {
+    uint8_t *results;   // Indexed by staircaseRank() of the position, read-only when mapped
+    uint32_t count;
+    void *map;          // Mapping of the whole file when loaded by loadSolution(), NULL when solved in memory
+    size_t map_size;
+} SolutionTable;
+
+bool solveChomp(SolutionTable *table);
+bool saveSolution(const SolutionTable *table, const char *path);
+bool loadSolution(SolutionTable *table, const char *path);
+uint32_t solutionChecksum(const uint8_t *results, uint32_t count);
+bool verifySolution(const SolutionTable *table);
+void freeSolution(SolutionTable *table);
+bool lookupSolution(const SolutionTable *table, Bitboard board, bool *win, int *distance);
+bool solutionBestMove(const SolutionTable *table, Bitboard board, int *best_row, int *best_col);
+
+#endif //SOLVER_H
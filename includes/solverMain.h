@@ -0,0 +1,8 @@
+#ifndef SOLVERMAIN_H
+#define SOLVERMAIN_H
+
+#include "solver.h"
+
+int main(int argc, char *argv[]);
+
+#endif //SOLVERMAIN_H
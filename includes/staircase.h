@@ -0,0 +1,27 @@
+#ifndef STAIRCASE_H
+#define STAIRCASE_H
+
+#include "constants.h"
+#include "bitboard.h"
+
+// A position described by the number of squares left on each row. Moves always remove a
+// bottom-right block, so the lengths never increase from the top row to the bottom row.
+typedef struct {
+    uint8_t lengths[ROWS];
+} StaircaseState;
+
+uint32_t staircaseCount(void);
+StaircaseState staircaseFromBoard(int board[ROWS][COLS]);
+void staircaseToBoard(StaircaseState state, int board[ROWS][COLS]);
+StaircaseState staircaseFromBitboard(Bitboard board);
+Bitboard staircaseToBitboard(StaircaseState state);
+uint32_t staircaseRank(StaircaseState state);
+StaircaseState staircaseUnrank(uint32_t rank);
+bool staircaseIsValid(StaircaseState state);
+int staircaseSquares(StaircaseState state);
+bool staircaseCanDestroy(StaircaseState state, int row, int col);
+int staircaseCountSquares(StaircaseState state, int row, int col);
+bool staircaseDestroySquares(StaircaseState *state, int row, int col);
+int staircaseLegalMoves(StaircaseState state, int moves[][2]);
+
+#endif //STAIRCASE_H
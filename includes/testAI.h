@@ -8,5 +8,11 @@ void testDestroySquares();
 void testEvaluateBoard();
 void testMinimax();
 void testAiChooseMove();
+void testAiChooseMoveTimed();
+void testParallelRootSearch();
+void testYbwcSearch();
+void testMoveOrdering();
+void testSeededSearch();
+void testSearchStats();
 
 #endif //TESTAI_H
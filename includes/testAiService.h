@@ -0,0 +1,11 @@
+#ifndef TESTAISERVICE_H
+#define TESTAISERVICE_H
+
+#include "testsMacro.h"
+#include "aiService.h"
+
+void testAiServiceMoves();
+void testAiServiceBoundedQueue();
+void testAiServiceStats();
+
+#endif //TESTAISERVICE_H
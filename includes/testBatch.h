@@ -0,0 +1,9 @@
+#ifndef TESTBATCH_H
+#define TESTBATCH_H
+
+#include "testsMacro.h"
+#include "batch.h"
+
+void testBatchEvaluate();
+
+#endif //TESTBATCH_H
@@ -0,0 +1,14 @@
+#ifndef TESTBITBOARD_H
+#define TESTBITBOARD_H
+
+#include "testsMacro.h"
+#include "bitboard.h"
+#include "gameLogic.h"
+#include "board.h"
+
+void testBoardToBitboard();
+void testBitboardCountSquares();
+void testBitboardDestroySquares();
+void testBitboardLegalMoves();
+
+#endif //TESTBITBOARD_H
@@ -0,0 +1,10 @@
+#ifndef TESTBOOK_H
+#define TESTBOOK_H
+
+#include "testsMacro.h"
+#include "book.h"
+
+void testBookPositions();
+void testSaveLoadBook();
+
+#endif //TESTBOOK_H
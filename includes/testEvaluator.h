@@ -0,0 +1,12 @@
+#ifndef TESTEVALUATOR_H
+#define TESTEVALUATOR_H
+
+#include "testsMacro.h"
+#include "ai.h"
+#include "evaluator.h"
+
+void testEvaluatorByName();
+void testWinLossMateDistance();
+void testStaircaseEndgames();
+
+#endif //TESTEVALUATOR_H
@@ -0,0 +1,11 @@
+#ifndef TESTGAMERECORD_H
+#define TESTGAMERECORD_H
+
+#include "testsMacro.h"
+#include "gameRecord.h"
+#include "rng.h"
+
+void testGameRecordRoundTrip();
+void testReplaySeek();
+
+#endif //TESTGAMERECORD_H
@@ -0,0 +1,11 @@
+#ifndef TESTLOBBY_H
+#define TESTLOBBY_H
+
+#include "testsMacro.h"
+#include "lobby.h"
+#include "client.h"
+
+void testLobbyPairsClients();
+void testLobbyAiOpponent();
+
+#endif //TESTLOBBY_H
@@ -0,0 +1,13 @@
+#ifndef TESTMOVEGEN_H
+#define TESTMOVEGEN_H
+
+#include "testsMacro.h"
+#include "moveGen.h"
+#include "staircase.h"
+#include "rng.h"
+
+void testMoveGenLegalMoves();
+void testMoveGenMakeUnmake();
+void testPositionUndoStack();
+
+#endif //TESTMOVEGEN_H
@@ -0,0 +1,11 @@
+#ifndef TESTPOSITIONINDEX_H
+#define TESTPOSITIONINDEX_H
+
+#include "testsMacro.h"
+#include "positionIndex.h"
+#include "gameRecord.h"
+
+void testPositionIndexBuild();
+void testSortMovesByPrior();
+
+#endif //TESTPOSITIONINDEX_H
@@ -0,0 +1,12 @@
+#ifndef TESTPROTOCOL_H
+#define TESTPROTOCOL_H
+
+#include "testsMacro.h"
+#include "protocol.h"
+
+void testProtocolRoundTrip();
+void testProtocolPartialFrames();
+void testProtocolRejectsMalformed();
+void testChannelBatching();
+
+#endif //TESTPROTOCOL_H
@@ -0,0 +1,10 @@
+#ifndef TESTRNG_H
+#define TESTRNG_H
+
+#include "testsMacro.h"
+#include "rng.h"
+
+void testRngSeed();
+void testRngBelow();
+
+#endif //TESTRNG_H
@@ -0,0 +1,12 @@
+#ifndef TESTSIZEDBOARD_H
+#define TESTSIZEDBOARD_H
+
+#include "testsMacro.h"
+#include "sizedBoard.h"
+
+void testSizedBoardInit();
+void testSizedBoardDestroySquares();
+void testSizedBoardLegalMoves();
+void testSizedBoardSearch();
+
+#endif //TESTSIZEDBOARD_H
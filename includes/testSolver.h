@@ -0,0 +1,11 @@
+#ifndef TESTSOLVER_H
+#define TESTSOLVER_H
+
+#include "testsMacro.h"
+#include "solver.h"
+
+void testSolveChomp();
+void testSolutionBestMove();
+void testSaveLoadSolution();
+
+#endif //TESTSOLVER_H
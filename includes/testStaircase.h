@@ -0,0 +1,14 @@
+#ifndef TESTSTAIRCASE_H
+#define TESTSTAIRCASE_H
+
+#include "testsMacro.h"
+#include "staircase.h"
+#include "gameLogic.h"
+#include "board.h"
+
+void testStaircaseRank();
+void testStaircaseBoardConversion();
+void testStaircaseDestroySquares();
+void testStaircaseLegalMoves();
+
+#endif //TESTSTAIRCASE_H
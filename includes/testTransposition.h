@@ -0,0 +1,14 @@
+#ifndef TESTTRANSPOSITION_H
+#define TESTTRANSPOSITION_H
+
+#include "testsMacro.h"
+#include "transposition.h"
+#include "ai.h"
+
+void testZobristHash();
+void testTranspositionStoreProbe();
+void testTranspositionAging();
+void testTranspositionConcurrent();
+void testMinimaxWithTable();
+
+#endif //TESTTRANSPOSITION_H
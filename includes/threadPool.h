@@ -0,0 +1,33 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "constants.h"
+
+typedef void (*TaskFunction)(void *arg);
+
+typedef struct {
+    TaskFunction function;
+    void *arg;
+} PoolTask;
+
+typedef struct {
+    pthread_t *threads;
+    int num_threads;
+    PoolTask *queue;            // Circular buffer of pending tasks
+    int capacity;
+    int head;                   // Index of the oldest pending task
+    int count;                  // Number of pending tasks
+    int active;                 // Number of tasks being run
+    bool shutdown;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;   // Signaled when a task is queued or the pool shuts down
+    pthread_cond_t not_full;    // Signaled when a task is taken from the queue
+    pthread_cond_t idle;        // Signaled when the last running task completes
+} ThreadPool;
+
+bool threadPoolInit(ThreadPool *pool, int num_threads, int capacity);
+void threadPoolSubmit(ThreadPool *pool, TaskFunction function, void *arg);
+void threadPoolWait(ThreadPool *pool);
+void threadPoolDestroy(ThreadPool *pool);
+
+#endif //THREADPOOL_H
@@ -0,0 +1,58 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include "constants.h"
+#include "bitboard.h"
+
+#define TT_DEFAULT_BITS 20 // 2^20 entries of 16 bytes (16 MiB)
+#define TT_BUCKET_SLOTS 4  // Entries per bucket, one cache line; a position may sit in any entry of its bucket
+#define TT_AGE_WEIGHT 8    // Depth an entry loses, for replacement, per search since it was stored
+#define TT_MAX_SIZE_MB 4096
+
+typedef enum {
+    TT_EXACT,  // The score is the exact minimax value
+    TT_LOWER,  // The search failed high, the value is at least the score
+    TT_UPPER   // The search failed low, the value is at most the score
+} BoundType;
+
+// An entry as returned by ttProbe(), decoded from its slot
+typedef struct {
+    uint64_t key;       // Full hash of the position, to detect index collisions
+    int16_t score;
+    int8_t depth;       // Remaining depth the score was searched to
+    uint8_t bound;      // One of BoundType
+    int8_t best_move;   // Cell index of the best move, -1 if none
+    uint8_t generation; // Search that stored the entry, see ttNewSearch()
+    uint8_t used;
+} TTEntry;
+
+// An entry as stored: the packed fields, and the key XORed with them. Threads read and write both words
+// without locks; a slot torn by two concurrent stores no longer XORs back to its key and is a miss.
+typedef struct {
+    atomic_uint_fast64_t check; // key ^ data
+    atomic_uint_fast64_t data;  // Packed TTEntry fields, 0 for an empty slot
+} TTSlot;
+
+// A table shared by any number of threads. Probes only read it: the hits and misses are counted by
+// each search in its SearchContext, not here, so that threads do not write a shared cache line.
+typedef struct {
+    TTSlot *slots;
+    uint64_t mask;      // Number of buckets - 1 (the size is a power of two)
+    atomic_uint generation;
+} TranspositionTable;
+
+uint64_t zobristCell(int cell);
+uint64_t zobristSide(void);
+uint64_t zobristSquares(Bitboard squares);
+uint64_t zobristHash(Bitboard board, bool isMaximizing);
+
+int ttBitsForSize(int size_mb);
+bool ttInit(TranspositionTable *table, int size_bits);
+void ttFree(TranspositionTable *table);
+void ttClear(TranspositionTable *table);
+void ttNewSearch(TranspositionTable *table);
+bool ttProbe(TranspositionTable *table, uint64_t key, TTEntry *entry);
+void ttStore(TranspositionTable *table, uint64_t key, int depth, BoundType bound, int score, int best_move);
+void ttPrintStats(TranspositionTable *table);
+
+#endif //TRANSPOSITION_H
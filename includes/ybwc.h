@@ -0,0 +1,73 @@
+#ifndef YBWC_H
+#define YBWC_H
+
+#include "constants.h"
+#include "bitboard.h"
+#include "transposition.h"
+#include "moveGen.h"
+#include "evaluator.h"
+#include "ai.h"
+
+#define YBWC_DEQUE_SIZE 4096    // Pending tasks per worker (at most ROWS * COLS per nested split point)
+#define YBWC_MIN_SPLIT_DEPTH 3  // Shallower nodes are not worth the cost of a split point
+
+// A node whose eldest child has been searched and whose younger brothers are searched in parallel
+typedef struct SplitPoint {
+    struct SplitPoint *parent;  // Enclosing split point, a cutoff there aborts this one too
+    Bitboard board;
+    int depth;
+    int ply;                    // Distance from the root, for the win/loss scores
+    bool isMaximizing;
+    bool root;                  // Root moves are searched with alpha - 1 to get reproducible ties
+    int moves[ROWS * COLS];     // Cell index of every move, in search order
+    int values[ROWS * COLS];    // Score of every move (root split point only)
+    pthread_mutex_t lock;       // Protects alpha, beta, bestValue and bestMove
+    int alpha;
+    int beta;
+    int bestValue;
+    int bestMove;
+    atomic_int pending;         // Tasks not completed yet
+    atomic_bool cutoff;         // Set on a beta cutoff, the remaining tasks are skipped
+} SplitPoint;
+
+typedef struct {
+    SplitPoint *sp;
+    int index;                  // Index of the move in sp->moves
+} YbwcTask;
+
+struct YbwcSearch;
+
+typedef struct {
+    struct YbwcSearch *search;
+    int id;
+    pthread_t thread;
+    pthread_mutex_t lock;       // Protects the deque
+    YbwcTask deque[YBWC_DEQUE_SIZE];
+    int top;                    // Oldest task, taken by thieves
+    int bottom;                 // One past the newest task, pushed and popped by the owner
+    uint64_t nodes;
+    uint64_t steals;
+} YbwcWorker;
+
+typedef struct YbwcSearch {
+    YbwcWorker *workers;        // Worker 0 is the thread calling the search functions
+    int num_workers;
+    const Evaluator *evaluator; // Leaf evaluation, the AI's one when the search is initialized
+    TranspositionTable table;   // Shared by every worker, without locks
+    atomic_bool active;         // True while a search runs, helpers sleep otherwise
+    atomic_bool quit;
+    atomic_bool stopped;        // Set when the deadline passed
+    bool timed;
+    struct timespec deadline;
+    pthread_mutex_t idle_lock;
+    pthread_cond_t wake;
+} YbwcSearch;
+
+bool ybwcInit(YbwcSearch *search, int num_workers, int table_bits);
+void ybwcDestroy(YbwcSearch *search);
+void ybwcSetDeadline(YbwcSearch *search, bool timed, struct timespec deadline);
+int ybwcMinimax(YbwcSearch *search, Bitboard board, int depth, bool isMaximizing, int alpha, int beta);
+int ybwcSearchRoot(YbwcSearch *search, Bitboard board, int moves[][2], int num_moves, int depth, int *best_index);
+uint64_t ybwcNodes(YbwcSearch *search);
+
+#endif //YBWC_H
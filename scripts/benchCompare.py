@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Compares two result files of `make bench` and reports the benchmarks that got slower.
+
+Usage: scripts/benchCompare.py <baseline.json> <current.json> [--threshold PERCENT]
+
+Exits with status 1 if a benchmark is slower than the baseline by more than the threshold
+(ns/op), or if it allocates more, so it can gate a change in a script or CI job.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """Returns the benchmarks of a result file, indexed by name."""
+    with open(path) as f:
+        return {bench["name"]: bench for bench in json.load(f)["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two `make bench` result files.")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="slowdown in percent reported as a regression (default: 10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+
+    print(f"{'benchmark':<36} {'baseline ns/op':>15} {'current ns/op':>15} {'change':>9}")
+    for name, bench in current.items():
+        if name not in baseline:
+            print(f"{name:<36} {'-':>15} {bench['ns_per_op']:>15.1f} {'new':>9}")
+            continue
+        old = baseline[name]
+        flag = ""
+        # bench clamps to 0 the operations faster than its clock overhead: no ratio to compare
+        if old["ns_per_op"] <= 0.0:
+            change_text = "n/a"
+        else:
+            change = 100.0 * (bench["ns_per_op"] - old["ns_per_op"]) / old["ns_per_op"]
+            change_text = f"{change:+.1f}%"
+        if old["ns_per_op"] > 0.0 and change > args.threshold:
+            flag = "  SLOWER"
+            regressions += 1
+        if bench["allocs_per_op"] > old["allocs_per_op"]:
+            flag += "  MORE ALLOCATIONS"
+            regressions += 1
+        print(f"{name:<36} {old['ns_per_op']:>15.1f} {bench['ns_per_op']:>15.1f} {change_text:>9}{flag}")
+
+    for name in baseline.keys() - current.keys():
+        print(f"{name:<36} missing from {args.current}")
+
+    print(f"{regressions} regression(s) above {args.threshold:.0f}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
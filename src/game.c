@@ -1,5 +1,9 @@
 #include "../includes/game.h"
 
+// Options followed by a value, which must not be mistaken for a port or an address
+static const char *VALUE_OPTIONS[] = {"-solution", "-time", "-threads", "-eval", "-size", "-hash", "-book", "-seed",
+                                      "-record", "-index", NULL};
+
 /**
  * Checks if the '-ia' flag is present in the command-line arguments.
  *
@@ -16,6 +20,55 @@ bool checkIa(int argc, char *argv[]) {
     return false;
 }
 
+/**
+ * Checks if a flag without value is present in the command-line arguments.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments.
+ * @param name The name of the flag, including its dash.
+ * @return True if the flag is present, false otherwise.
+ */
+bool checkFlag(int argc, char *argv[], char *name) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Checks if a command-line argument is an option that takes a value.
+ *
+ * @param arg The command-line argument to check.
+ * @return True if the next argument is the value of this option, false otherwise.
+ */
+bool optionTakesValue(char *arg) {
+    for (int i = 0; VALUE_OPTIONS[i] != NULL; i++) {
+        if (strcmp(arg, VALUE_OPTIONS[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Extracts the value of an option from the command-line arguments (e.g. '-solution chomp.sol').
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments.
+ * @param name The name of the option, including its dash.
+ * @return The value following the option, or NULL if the option is absent.
+ */
+char *extractOption(int argc, char *argv[], char *name) {
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return NULL;
+}
+
 /**
  * Extracts the IP address and port number from the command-line arguments.
  *
@@ -27,6 +80,10 @@ bool checkIa(int argc, char *argv[]) {
  */
 bool extractIpPort(int argc, char *argv[], char *ip, int *port) {
     for (int i = 1; i < argc; i++) {
+        if (optionTakesValue(argv[i])) {
+            i++;
+            continue;
+        }
         if (sscanf(argv[i], "%15[^:]:%d", ip, port) == 2) {
             return true;
         }
@@ -44,6 +101,10 @@ bool extractIpPort(int argc, char *argv[], char *ip, int *port) {
  */
 bool extractPort(int argc, char *argv[], int *port) {
     for (int i = 1; i < argc; i++) {
+        if (optionTakesValue(argv[i])) {
+            i++;
+            continue;
+        }
         int extracted_port = atoi(argv[i]);
         if (extracted_port > 0) {
             *port = extracted_port;
@@ -63,6 +124,27 @@ void printUsage(char *prog_name) {
     printf("  - Server: %s -s [-ia] <port>\n", prog_name);
     printf("  - Client: %s -c [-ia] <ip>:<port>\n", prog_name);
     printf("  - Local : %s -l [-ia]\n", prog_name);
+    printf("Options:\n");
+    printf("  -g                 Play in the console instead of the GUI\n");
+    printf("  -size <r>x<c>      Local: play on a board of <r> rows and <c> columns, up to %dx%d (default: %dx%d)\n",
+           BOARD_MAX_ROWS, BOARD_MAX_COLS, ROWS, COLS);
+    printf("  -m                 Server: host any number of games, pairing clients with each other or the AI\n");
+    printf("                     Client: join such a server\n");
+    printf("  -solution <file>   Let the AI play perfectly with a table built by ./build/solver\n");
+    printf("  -book <file>       Let the AI play its first moves from a book built by ./build/book\n");
+    printf("  -index <file>      Let the AI try first the moves that won the games indexed by ./build/index\n");
+    printf("  -time <ms>         Let the AI search as deep as possible within <ms> per move (default: depth %d)\n", MAX_DEPTH);
+    printf("  -hash <MB>         Size of the AI's transposition table, shared by its threads (default: %d MB)\n",
+           (int) ((sizeof(TTSlot) << TT_DEFAULT_BITS) >> 20));
+    printf("  -threads <n>       Search the AI's candidate moves on <n> threads\n");
+    printf("  -ybwc              With -threads, share the whole search tree between the threads (work stealing)\n");
+    printf("  -stats             Print the AI's search statistics as one JSON line per move\n");
+    printf("  -seed <n>          Seed of the AI's choice between equal moves, to replay a game (default: from the clock)\n");
+    printf("  -record <file>     Append every game played to <file>, to replay with ./build/replay\n");
+    printf("  -eval <name>       Choose the AI's evaluation (default: %s):\n", EVAL_DEFAULT);
+    for (int i = 0; evaluatorAt(i) != NULL; i++) {
+        printf("                       %-10s %s\n", evaluatorAt(i)->name, evaluatorAt(i)->description);
+    }
 }
 
 /**
@@ -95,9 +177,82 @@ int main(int argc, char *argv[]) {
             }
         }
 
+        // Load the perfect-play table if one was given
+        char *solution_path = extractOption(argc, argv, "-solution");
+        if (solution_path != NULL && !aiLoadSolution(solution_path)) {
+            printf("Continuing with the Minimax AI.\n");
+        }
+
+        // Load the opening book if one was given
+        char *book_path = extractOption(argc, argv, "-book");
+        if (book_path != NULL && !aiLoadBook(book_path)) {
+            printf("Continuing without opening book.\n");
+        }
+
+        // Order the AI's moves by the recorded games if an index was given
+        char *index_path = extractOption(argc, argv, "-index");
+        if (index_path != NULL && !aiLoadPositionIndex(index_path)) {
+            printf("Continuing without position index.\n");
+        }
+
+        // Select the AI's evaluation
+        char *eval = extractOption(argc, argv, "-eval");
+        if (eval != NULL && !aiSetEvaluator(eval)) {
+            printf("Unknown evaluation '%s', the AI uses '%s'.\n", eval, aiEvaluator()->name);
+        }
+
+        // Give the AI a time budget per move instead of the fixed depth
+        char *time_budget = extractOption(argc, argv, "-time");
+        if (time_budget != NULL) {
+            aiSetTimeBudget(atoi(time_budget));
+        }
+
+        // Size the AI's transposition table, before the threads that share it are started
+        char *hash = extractOption(argc, argv, "-hash");
+        if (hash != NULL && !aiSetHashSize(atoi(hash))) {
+            printf("Invalid hash size '%s' (1 to %d MB), the AI keeps its default table.\n", hash, TT_MAX_SIZE_MB);
+        }
+
+        // Spread the AI's root moves over several cores
+        char *threads = extractOption(argc, argv, "-threads");
+        if (threads != NULL && checkFlag(argc, argv, "-ybwc")) {
+            if (!aiSetYbwcThreads(atoi(threads))) {
+                printf("Could not start the search threads, the AI stays single-threaded.\n");
+            }
+        } else if (threads != NULL && !aiSetThreads(atoi(threads))) {
+            printf("Could not start the search threads, the AI stays single-threaded.\n");
+        }
+
+        // Seed the AI's choice between equal moves, and log the seed so that the game can be replayed
+        char *seed = extractOption(argc, argv, "-seed");
+        aiSetSeed(seed != NULL ? strtoull(seed, NULL, 10) : rngClockSeed());
+        printf("AI seed: %llu\n", (unsigned long long) aiSeed());
+
+        // Report what every AI search did
+        if (checkFlag(argc, argv, "-stats")) {
+            aiSetStatsOutput(true);
+        }
+
+        // Choose the size of a local game's board
+        int rows = ROWS, cols = COLS;
+        char *size = extractOption(argc, argv, "-size");
+        if (size != NULL && !sizedBoardParseSize(size, &rows, &cols)) {
+            printf("Invalid board size '%s'.\n", size);
+            printUsage(argv[0]);
+            return -1;
+        }
+
+        // Append the games to a record file
+        char *record_path = extractOption(argc, argv, "-record");
+        if (record_path != NULL && !recordOpen(record_path)) {
+            printf("Continuing without recording the games.\n");
+        }
+
         // Launch the appropriate mode
         if (localMode) {
-            localMain(aiMode, guiMode);
+            localMain(aiMode, guiMode, rows, cols);
+        } else if (serverMode && checkFlag(argc, argv, "-m") && extractPort(argc, argv, &port)) {
+            lobbyMain(port, aiMode);
         } else if (serverMode && extractPort(argc, argv, &port)) {
             printf("Starting server on port: %d\n", port);
             serverMain(port, aiMode, guiMode, serverMode, clientMode);
@@ -106,8 +261,10 @@ int main(int argc, char *argv[]) {
             clientMain(ip, port, aiMode, guiMode, serverMode, clientMode);
         } else {
             printUsage(argv[0]);
+            recordClose();
             return -1;
         }
+        recordClose();
     } else {
         printUsage(argv[0]);
         return -1;
@@ -1,8 +1,44 @@
 #include "../../includes/ai.h"
 
+static TranspositionTable searchTable; // Shared by every search, see aiTranspositionTable()
+static SolutionTable solution;          // Perfect-play table, empty until aiLoadSolution() succeeds
+static OpeningBook book;                // Best moves of the first positions, empty until aiLoadBook() succeeds
+static PositionIndex positionIndex;     // Outcomes of the recorded games, empty until aiLoadPositionIndex() succeeds
+static int timeBudget = 0;              // Milliseconds per move for aiChooseMove(), 0 for the fixed MAX_DEPTH
+static int searchThreads = 1;           // Threads searching the root moves, see aiSetThreads()
+static ThreadPool searchPool;           // Root search workers, only started with more than one thread
+static SearchContext *workerContexts;   // One context per worker, all sharing the table of the search
+static int hashBits = TT_DEFAULT_BITS;  // Size of the AI's tables, see aiSetHashSize()
+static YbwcSearch ybwcSearch;           // Work-stealing search, see aiSetYbwcThreads()
+static bool ybwcEnabled = false;
+static const Evaluator *searchEvaluator;  // Leaf evaluation of every search, see aiSetEvaluator()
+static SearchStats lastStats;           // Statistics of the last move reported, see aiReportStats()
+static bool statsOutput = false;        // Print lastStats as a JSON line after every move, see aiSetStatsOutput()
+static uint64_t searchSeed = AI_DEFAULT_SEED;  // Seed of searchRng, see aiSetSeed()
+static Rng searchRng;                   // Move shuffle of the searches without their own generator
+static bool searchRngSeeded = false;
+
+// Root moves shared by the workers of a parallel root search
+typedef struct {
+    Bitboard board;
+    int (*moves)[2];
+    int num_moves;
+    int depth;
+    atomic_int next;            // Index of the next root move to search
+    atomic_int alpha;           // Best score found so far by any worker
+    atomic_bool stopped;        // Set when a worker hit the deadline
+    int values[ROWS * COLS];    // Score of every root move
+} RootSplit;
+
+typedef struct {
+    RootSplit *split;
+    SearchContext *ctx;
+} RootTask;
+
 /**
  * Destroys squares on the board starting from the given square, according to a specific pattern.
  * The destruction pattern extends from the starting square until a maximum of 5 contiguous squares are destroyed.
+ * The move itself is applied on the bitboard representation, the array is only used as input and output.
  *
  * @param board A 2D array representing the game board with dimensions defined by ROWS and COLS constants.
  * @param row The starting row index for destruction.
@@ -10,16 +46,11 @@
  * @return True if the squares were successfully destroyed, otherwise false. If more than 5 squares are to be destroyed, false is returned.
  */
 bool destroySquares(int board[ROWS][COLS], int row, int col) {
-    if (countSquares(board, row, col) > 5) {
+    Bitboard bb = boardToBitboard(board);
+    if (!bitboardDestroySquares(&bb, row, col)) {
         return false;
     }
-    for (int i = row; i < ROWS; i++) {
-        for (int j = col; j < COLS; j++) {
-            if (board[i][j] == 1 && countSquares(board, i, j) <= 5) {
-                board[i][j] = 0;
-            }
-        }
-    }
+    bitboardToBoard(bb, board);
     return true;
 }
 
@@ -30,20 +61,23 @@ bool destroySquares(int board[ROWS][COLS], int row, int col) {
  * @return The total number of squares on the board that are still present (i.e., not destroyed).
  */
 int evaluateBoard(int board[ROWS][COLS]) {
-    int score = 0;
-    for (int i = 0; i < ROWS; i++) {
-        for (int j = 0; j < COLS; j++) {
-            if (board[i][j] == 1) {
-                score++;
-            }
-        }
-    }
-    return score;
+    return evaluateBitboard(boardToBitboard(board));
+}
+
+/**
+ * Evaluates a bitboard by counting the number of squares that are still present.
+ *
+ * @param board The bitboard of the position to evaluate.
+ * @return The total number of squares still present on the bitboard.
+ */
+int evaluateBitboard(Bitboard board) {
+    return bitboardCount(board);
 }
 
 /**
  * Performs the Minimax algorithm with Alpha-Beta pruning to determine the best move.
  * The algorithm recursively explores all possible moves up to a specified depth and selects the move with the best evaluation score.
+ * The board is converted once to a bitboard and the search itself runs in minimaxBitboard().
  *
  * @param board A 2D array representing the game board with dimensions defined by ROWS and COLS constants.
  * @param depth The maximum depth of the search tree.
@@ -53,51 +87,738 @@ int evaluateBoard(int board[ROWS][COLS]) {
  * @return The best score for the current player.
  */
 int minimax(int board[ROWS][COLS], int depth, bool isMaximizing, int alpha, int beta) {
-    if (depth == 0 || evaluateBoard(board) <= 0) {
-        return evaluateBoard(board);
+    return minimaxBitboard(boardToBitboard(board), depth, isMaximizing, alpha, beta);
+}
+
+/**
+ * Returns the transposition table shared by the AI searches, allocating it on first use.
+ * The table is kept between moves, so positions searched for a previous move are reused.
+ *
+ * @return A pointer to the AI's transposition table.
+ */
+TranspositionTable *aiTranspositionTable(void) {
+    if (searchTable.slots == NULL) {
+        ttInit(&searchTable, hashBits);
+    }
+    return &searchTable;
+}
+
+/**
+ * Sets the memory of the AI's transposition table, and of the work-stealing search's table if it is started
+ * afterwards. The table is reallocated, so it must not be in use.
+ *
+ * @param size_mb The size in MiB, from 1 to TT_MAX_SIZE_MB.
+ * @return True on success, false if the size is out of range or could not be allocated (the table keeps its size).
+ */
+bool aiSetHashSize(int size_mb) {
+    if (size_mb < 1 || size_mb > TT_MAX_SIZE_MB) {
+        return false;
+    }
+    TranspositionTable table;
+    if (!ttInit(&table, ttBitsForSize(size_mb))) {
+        return false;
+    }
+    ttFree(&searchTable);
+    searchTable = table;
+    hashBits = ttBitsForSize(size_mb);
+    return true;
+}
+
+/**
+ * Returns the size of the AI's transposition table set by aiSetHashSize(), for the searches that
+ * run with tables of their own (see aiServiceInit()).
+ *
+ * @return The base-2 logarithm of the number of entries, TT_DEFAULT_BITS if no size was set.
+ */
+int aiHashBits(void) {
+    return hashBits;
+}
+
+/**
+ * Returns the leaf evaluation used by the AI searches, EVAL_DEFAULT until aiSetEvaluator() is called.
+ *
+ * @return A pointer to the evaluator.
+ */
+const Evaluator *aiEvaluator(void) {
+    if (searchEvaluator == NULL) {
+        searchEvaluator = evaluatorByName(EVAL_DEFAULT);
+    }
+    return searchEvaluator;
+}
+
+/**
+ * Selects the leaf evaluation of the AI searches. The transposition tables are cleared,
+ * as the scores they hold were computed with the previous evaluation.
+ *
+ * @param name The name of the evaluator (see evaluator.c).
+ * @return True on success, false if no evaluator has this name (the current one is kept).
+ */
+bool aiSetEvaluator(const char *name) {
+    const Evaluator *evaluator = evaluatorByName(name);
+    if (evaluator == NULL) {
+        return false;
+    }
+    searchEvaluator = evaluator;
+    ttClear(&searchTable);
+    if (ybwcEnabled) {
+        ttClear(&ybwcSearch.table);
+    }
+    return true;
+}
+
+/**
+ * Clears the counters of a search context, which the statistics of a search are read from.
+ *
+ * @param ctx The search context.
+ */
+static void resetSearchCounters(SearchContext *ctx) {
+    ctx->nodes = 0;
+    ctx->cutoffs = 0;
+    ctx->first_cutoffs = 0;
+    ctx->leaves = 0;
+    ctx->tt_probes = 0;
+    ctx->tt_hits = 0;
+    ctx->max_ply = 0;
+    memset(ctx->ply_cutoffs, 0, sizeof(ctx->ply_cutoffs));
+}
+
+/**
+ * Adds the counters of a root search worker to those of the search it works for.
+ *
+ * @param ctx The search context receiving the counters.
+ * @param worker The context of the worker.
+ */
+static void mergeSearchCounters(SearchContext *ctx, const SearchContext *worker) {
+    ctx->nodes += worker->nodes;
+    ctx->cutoffs += worker->cutoffs;
+    ctx->first_cutoffs += worker->first_cutoffs;
+    ctx->leaves += worker->leaves;
+    ctx->tt_probes += worker->tt_probes;
+    ctx->tt_hits += worker->tt_hits;
+    ctx->max_ply = (ctx->max_ply > worker->max_ply) ? ctx->max_ply : worker->max_ply;
+    for (int i = 0; i < ROWS * COLS; i++) {
+        ctx->ply_cutoffs[i] += worker->ply_cutoffs[i];
+    }
+}
+
+/**
+ * Prepares a search context. With a positive budget the search stops once the budget has elapsed,
+ * otherwise it runs until the requested depth is completed. The root is searched on the threads set by
+ * aiSetThreads() or aiSetYbwcThreads(); clear root_threads for a search that must not share them.
+ *
+ * @param ctx The context to initialize.
+ * @param table The transposition table used by the search.
+ * @param budget_ms The time budget in milliseconds, 0 for no limit.
+ */
+void initSearchContext(SearchContext *ctx, TranspositionTable *table, int budget_ms) {
+    ctx->table = table;
+    ctx->evaluator = aiEvaluator();
+    ctx->timed = budget_ms > 0;
+    ctx->stopped = false;
+    ctx->root_threads = true;
+    ctx->max_depth = MAX_DEPTH;
+    ctx->rng = NULL;
+    ctx->source = "none";
+    ctx->score = 0;
+    resetSearchCounters(ctx);
+    ctx->iteration_nodes[0] = 0;
+    ctx->iteration_nodes[1] = 0;
+    memset(ctx->killers, -1, sizeof(ctx->killers));
+    memset(ctx->history, 0, sizeof(ctx->history));
+    clock_gettime(CLOCK_MONOTONIC, &ctx->start);
+    ctx->deadline = ctx->start;
+    ctx->deadline.tv_sec += budget_ms / 1000;
+    ctx->deadline.tv_nsec += (long) (budget_ms % 1000) * 1000000L;
+    if (ctx->deadline.tv_nsec >= 1000000000L) {
+        ctx->deadline.tv_sec++;
+        ctx->deadline.tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * Returns the time elapsed since a search context was initialized.
+ *
+ * @param ctx The search context.
+ * @return The elapsed time in milliseconds.
+ */
+int searchElapsedMs(SearchContext *ctx) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int) ((now.tv_sec - ctx->start.tv_sec) * 1000 + (now.tv_nsec - ctx->start.tv_nsec) / 1000000L);
+}
+
+/**
+ * Returns the share of the cutoffs produced by the first move searched, the usual measure of move ordering
+ * quality: with perfect ordering every cutoff happens on the first move.
+ *
+ * @param ctx The search context.
+ * @return The ratio of first-move cutoffs to all cutoffs, 0 if there was no cutoff.
+ */
+double searchFirstCutoffRate(SearchContext *ctx) {
+    return ctx->cutoffs > 0 ? (double) ctx->first_cutoffs / (double) ctx->cutoffs : 0.0;
+}
+
+/**
+ * Gathers the statistics of a search once it is over. The effective branching factor is the ratio
+ * of the nodes of the last completed iteration to those of the one before.
+ * The work-stealing search of aiSetYbwcThreads() only counts its nodes.
+ *
+ * @param ctx The search context.
+ * @param depth The depth of the last completed iteration, as returned by aiSearchMove().
+ * @param row The row index of the move chosen, -1 if none.
+ * @param col The column index of the move chosen, -1 if none.
+ * @param stats Receives the statistics.
+ */
+void searchStatsFill(SearchContext *ctx, int depth, int row, int col, SearchStats *stats) {
+    stats->source = ctx->source;
+    stats->row = row;
+    stats->col = col;
+    stats->depth = depth;
+    stats->score = ctx->score;
+    stats->max_ply = ctx->max_ply;
+    stats->nodes = ctx->nodes;
+    stats->leaves = ctx->leaves;
+    stats->tt_probes = ctx->tt_probes;
+    stats->tt_hits = ctx->tt_hits;
+    stats->cutoffs = ctx->cutoffs;
+    stats->first_cutoffs = ctx->first_cutoffs;
+    memcpy(stats->ply_cutoffs, ctx->ply_cutoffs, sizeof(stats->ply_cutoffs));
+    stats->branching = ctx->iteration_nodes[0] > 0
+                       ? (double) ctx->iteration_nodes[1] / (double) ctx->iteration_nodes[0] : 0.0;
+    stats->elapsed_ms = searchElapsedMs(ctx);
+}
+
+/**
+ * Writes the statistics of a search as one line of JSON, the cutoffs per ply listed up to the deepest ply.
+ *
+ * @param stats The statistics.
+ * @param file The stream to write to.
+ */
+void searchStatsPrintJson(const SearchStats *stats, FILE *file) {
+    fprintf(file, "{\"move\": \"");
+    if (stats->row >= 0) {
+        fprintf(file, "%c%d", stats->col + 'A', stats->row + 1);
     }
+    fprintf(file, "\", \"source\": \"%s\", \"depth\": %d, \"score\": %d, \"max_ply\": %d, \"nodes\": %llu, "
+                  "\"leaves\": %llu, "
+                  "\"tt_probes\": %llu, \"tt_hits\": %llu, \"cutoffs\": %llu, \"first_cutoffs\": %llu, "
+                  "\"cutoffs_by_ply\": [",
+            stats->source, stats->depth, stats->score, stats->max_ply, (unsigned long long) stats->nodes,
+            (unsigned long long) stats->leaves, (unsigned long long) stats->tt_probes,
+            (unsigned long long) stats->tt_hits, (unsigned long long) stats->cutoffs,
+            (unsigned long long) stats->first_cutoffs);
+    for (int i = 0; i < stats->max_ply; i++) {
+        fprintf(file, "%s%llu", i > 0 ? ", " : "", (unsigned long long) stats->ply_cutoffs[i]);
+    }
+    fprintf(file, "], \"branching\": %.2f, \"ms\": %d}\n", stats->branching, stats->elapsed_ms);
+    fflush(file);
+}
+
+/**
+ * Returns the statistics of the last move reported by aiReportStats(): the last move chosen by aiChooseMove(),
+ * aiChooseMoveTimed() or sizedBoardChooseMove(), or collected from an AI service.
+ *
+ * @return The statistics, all zero before the first move.
+ */
+const SearchStats *aiLastStats(void) {
+    return &lastStats;
+}
+
+/**
+ * Makes aiReportStats() print the statistics of every move as a JSON line on the standard output.
+ *
+ * @param enabled True to print the statistics, false to stop.
+ */
+void aiSetStatsOutput(bool enabled) {
+    statsOutput = enabled;
+}
+
+/**
+ * Keeps the statistics of a move the AI is about to play as the last ones, and prints them as a JSON
+ * line if aiSetStatsOutput() is on. Called by the thread that plays the move, not by search threads.
+ *
+ * @param stats The statistics, see searchStatsFill().
+ */
+void aiReportStats(const SearchStats *stats) {
+    lastStats = *stats;
+    if (statsOutput) {
+        searchStatsPrintJson(&lastStats, stdout);
+    }
+}
+
+/**
+ * Checks the clock every 1024 nodes and raises the stop flag once the deadline has passed.
+ *
+ * @param ctx The search context.
+ * @return True if the search must stop, false otherwise.
+ */
+static bool searchShouldStop(SearchContext *ctx) {
+    if (ctx->timed && !ctx->stopped && (ctx->nodes & 1023) == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > ctx->deadline.tv_sec ||
+            (now.tv_sec == ctx->deadline.tv_sec && now.tv_nsec >= ctx->deadline.tv_nsec)) {
+            ctx->stopped = true;
+        }
+    }
+    return ctx->stopped;
+}
+
+/**
+ * Lists the legal moves of a position in search order: the best move stored in the transposition table
+ * (the principal variation of the previous iteration) first, then the killer moves of the ply, then the
+ * others by decreasing history score, ties in row-major order.
+ * Close to the leaves the killers and the history are skipped: a fixed row-major order makes sibling
+ * subtrees reach the same positions with the same windows, which the transposition table then cuts.
+ *
+ * @param ctx The search context holding the killer moves and the history table.
+ * @param legal The legal moves of the position.
+ * @param tt_move The cell index of the transposition table move, -1 if none.
+ * @param ply The distance from the root of the search.
+ * @param side 1 if the maximizing player is to move, 0 otherwise.
+ * @param depth The remaining depth of the node.
+ * @param order Receives the cell index of every legal move.
+ * @return The number of legal moves.
+ */
+static int orderMoves(SearchContext *ctx, Bitboard legal, int tt_move, int ply, int side, int depth,
+                      int order[ROWS * COLS]) {
+    int num_moves = 0;
+    Bitboard moves = legal;
+    bool heuristics = depth >= ORDER_MIN_DEPTH;
+
+    if (tt_move >= 0 && (moves & (((Bitboard) 1) << tt_move))) {
+        order[num_moves++] = tt_move;
+        moves &= ~(((Bitboard) 1) << tt_move);
+    }
+    for (int k = 0; heuristics && k < 2; k++) {
+        int killer = ctx->killers[ply][k];
+        if (killer >= 0 && (moves & (((Bitboard) 1) << killer))) {
+            order[num_moves++] = killer;
+            moves &= ~(((Bitboard) 1) << killer);
+        }
+    }
+
+    // Insertion sort of the quiet moves, stable so that equal scores stay in row-major order
+    int first = num_moves;
+    uint32_t *history = ctx->history[side];
+    while (moves) {
+        int cell = __builtin_ctzll(moves);
+        moves &= moves - 1;
+        int i = num_moves++;
+        while (heuristics && i > first && history[order[i - 1]] < history[cell]) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = cell;
+    }
+    return num_moves;
+}
+
+/**
+ * Records a move that caused a cutoff: it becomes the first killer of its ply and gains history
+ * in proportion to the square of the remaining depth, so cutoffs near the root weigh more.
+ *
+ * @param ctx The search context.
+ * @param cell The cell index of the move.
+ * @param ply The distance from the root of the search.
+ * @param side 1 if the maximizing player is to move, 0 otherwise.
+ * @param depth The remaining depth of the node.
+ * @param first True if the move was the first one searched.
+ */
+static void recordCutoff(SearchContext *ctx, int cell, int ply, int side, int depth, bool first) {
+    ctx->cutoffs++;
+    ctx->ply_cutoffs[ply]++;
+    if (first) {
+        ctx->first_cutoffs++;
+    }
+    if (ctx->killers[ply][0] != cell) {
+        ctx->killers[ply][1] = ctx->killers[ply][0];
+        ctx->killers[ply][0] = cell;
+    }
+    ctx->history[side][cell] += (uint32_t) (depth * depth);
+}
+
+/**
+ * Recursive Alpha-Beta search on bitboards, backed by the transposition table.
+ * Children are played and taken back in place on the thread's position, which keeps the legal moves
+ * and the Zobrist hash up to date.
+ * Table entries only cut the search when they were searched to the same remaining depth, so the
+ * returned values do not depend on what was searched before; their best move is still searched first.
+ * When the context's deadline passes, the search unwinds and its result must be discarded.
+ *
+ * @param ctx The search context (transposition table, deadline and node counter).
+ * @param pos The position to search, restored before returning.
+ * @param depth The remaining depth of the search tree.
+ * @param ply The distance from the root of the search, which indexes the killer moves.
+ * @param isMaximizing A boolean indicating whether the current player is maximizing (true) or minimizing (false).
+ * @param alpha The current best score for the maximizing player.
+ * @param beta The current best score for the minimizing player.
+ * @return The best score for the current player.
+ */
+static int alphaBeta(SearchContext *ctx, Position *pos, int depth, int ply, bool isMaximizing, int alpha, int beta) {
+    ctx->nodes++;
+    if (searchShouldStop(ctx)) {
+        return 0;
+    }
+
+    if (ply > ctx->max_ply) {
+        ctx->max_ply = ply;
+    }
+
+    bool terminal;
+    int score = ctx->evaluator->evaluate(pos->gen.board, isMaximizing, ply, &terminal);
+    if (depth == 0 || terminal) {
+        ctx->leaves++;
+        return score;
+    }
+
+    TTEntry entry;
+    int tt_move = -1;
+    ctx->tt_probes++;
+    if (ttProbe(ctx->table, pos->hash, &entry)) {
+        ctx->tt_hits++;
+        int tt_score = evalScoreFromTable(entry.score, ply);
+        if (entry.depth == depth &&
+            (entry.bound == TT_EXACT ||
+             (entry.bound == TT_LOWER && tt_score >= beta) ||
+             (entry.bound == TT_UPPER && tt_score <= alpha))) {
+            return tt_score;
+        }
+        tt_move = entry.best_move;
+    }
+
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int bestMove = -1;
+    int bestValue;
+    int order[ROWS * COLS];
+    int num_moves = orderMoves(ctx, pos->gen.legal, tt_move, ply, isMaximizing, depth, order);
 
     if (isMaximizing) {
-        int bestValue = -INF;
-        for (int r = 0; r < ROWS; r++) {
-            for (int c = 0; c < COLS; c++) {
-                if (canDestroy(board, r, c)) {
-                    int new_board[ROWS][COLS];
-                    memcpy(new_board, board, sizeof(int) * ROWS * COLS);
-                    if (destroySquares(new_board, r, c)) {
-                        int value = minimax(new_board, depth - 1, false, alpha, beta);
-                        bestValue = (value > bestValue) ? value : bestValue;
-                        alpha = (alpha > bestValue) ? alpha : bestValue;
-
-                        if (beta <= alpha) {
-                            return bestValue;
-                        }
-                    }
-                }
+        bestValue = -INF;
+        for (int i = 0; i < num_moves; i++) {
+            int cell = order[i];
+            makeMove(pos, cell);
+            int value = alphaBeta(ctx, pos, depth - 1, ply + 1, false, alpha, beta);
+            unmakeMove(pos);
+            if (ctx->stopped) {
+                return 0;
+            }
+            if (value > bestValue) {
+                bestValue = value;
+                bestMove = cell;
+            }
+            alpha = (alpha > bestValue) ? alpha : bestValue;
+
+            if (beta <= alpha) {
+                recordCutoff(ctx, cell, ply, 1, depth, i == 0);
+                break;
             }
         }
-        return bestValue;
     } else {
-        int bestValue = INF;
-        for (int r = 0; r < ROWS; r++) {
-            for (int c = 0; c < COLS; c++) {
-                if (canDestroy(board, r, c)) {
-                    int new_board[ROWS][COLS];
-                    memcpy(new_board, board, sizeof(int) * ROWS * COLS);
-                    if (destroySquares(new_board, r, c)) {
-                        int value = minimax(new_board, depth - 1, true, alpha, beta);
-                        bestValue = (value < bestValue) ? value : bestValue;
-                        beta = (beta < bestValue) ? beta : bestValue;
-
-                        if (beta <= alpha) {
-                            return bestValue;
-                        }
-                    }
-                }
+        bestValue = INF;
+        for (int i = 0; i < num_moves; i++) {
+            int cell = order[i];
+            makeMove(pos, cell);
+            int value = alphaBeta(ctx, pos, depth - 1, ply + 1, true, alpha, beta);
+            unmakeMove(pos);
+            if (ctx->stopped) {
+                return 0;
+            }
+            if (value < bestValue) {
+                bestValue = value;
+                bestMove = cell;
+            }
+            beta = (beta < bestValue) ? beta : bestValue;
+
+            if (beta <= alpha) {
+                recordCutoff(ctx, cell, ply, 0, depth, i == 0);
+                break;
             }
         }
-        return bestValue;
     }
+
+    BoundType bound = TT_EXACT;
+    if (bestValue <= alphaOrig) {
+        bound = TT_UPPER;
+    } else if (bestValue >= betaOrig) {
+        bound = TT_LOWER;
+    }
+    ttStore(ctx->table, pos->hash, depth, bound, evalScoreToTable(bestValue, ply), bestMove);
+    return bestValue;
+}
+
+/**
+ * Minimax search with Alpha-Beta pruning running on the bitboard representation.
+ * Children are played and taken back in place, so no board is ever copied or rescanned.
+ * Positions reached through different move orders are looked up in the AI's transposition table.
+ *
+ * @param board The bitboard of the position to search.
+ * @param depth The maximum depth of the search tree.
+ * @param isMaximizing A boolean indicating whether the current player is maximizing (true) or minimizing (false).
+ * @param alpha The current best score for the maximizing player.
+ * @param beta The current best score for the minimizing player.
+ * @return The best score for the current player.
+ */
+int minimaxBitboard(Bitboard board, int depth, bool isMaximizing, int alpha, int beta) {
+    SearchContext ctx;
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    return minimaxContext(&ctx, board, depth, isMaximizing, alpha, beta);
+}
+
+/**
+ * Same as minimaxBitboard() with a caller-provided search context, whose node counter is
+ * incremented by the search. This is the sequential reference of the parallel searches.
+ *
+ * @param ctx The search context (transposition table, deadline and node counter).
+ * @param board The bitboard of the position to search.
+ * @param depth The maximum depth of the search tree.
+ * @param isMaximizing A boolean indicating whether the current player is maximizing (true) or minimizing (false).
+ * @param alpha The current best score for the maximizing player.
+ * @param beta The current best score for the minimizing player.
+ * @return The best score for the current player.
+ */
+int minimaxContext(SearchContext *ctx, Bitboard board, int depth, bool isMaximizing, int alpha, int beta) {
+    Position pos;
+    positionInit(&pos, board, isMaximizing);
+    return alphaBeta(ctx, &pos, depth, 0, isMaximizing, alpha, beta);
+}
+
+/**
+ * Searches every root move to the given depth, the AI being the maximizing player.
+ * Each move after the first is searched with the best score so far as alpha, which can only
+ * prune moves that would not have been chosen anyway.
+ *
+ * @param ctx The search context.
+ * @param board The bitboard of the position.
+ * @param moves The root moves, in search order.
+ * @param num_moves The number of root moves.
+ * @param depth The depth of the search, the root move included.
+ * @param best_index Receives the index of the best move in the moves array.
+ * @return The score of the best move. Meaningless if the context was stopped during the search.
+ */
+static int searchRoot(SearchContext *ctx, Bitboard board, int moves[][2], int num_moves, int depth, int *best_index) {
+    int bestValue = -INF;
+    Position pos;
+    positionInit(&pos, board, true);
+    *best_index = 0;
+
+    for (int i = 0; i < num_moves; i++) {
+        makeMove(&pos, BB_INDEX(moves[i][0], moves[i][1]));
+        int value = alphaBeta(ctx, &pos, depth - 1, 1, false, bestValue, INF);
+        unmakeMove(&pos);
+        if (ctx->stopped) {
+            break;
+        }
+        if (value > bestValue) {
+            bestValue = value;
+            *best_index = i;
+        }
+    }
+    return bestValue;
+}
+
+/**
+ * Work of one thread of the parallel root search: takes the next unsearched root move until none is left.
+ * Each move is searched with alpha one below the shared best score. Any move at least as good as the best
+ * therefore gets its exact score, whatever the other threads have found, while worse moves still fail low
+ * quickly. The chosen move is then the same for any number of threads.
+ *
+ * @param arg A pointer to the RootTask of the thread.
+ */
+static void searchRootTask(void *arg) {
+    RootTask *task = (RootTask *) arg;
+    RootSplit *split = task->split;
+    SearchContext *ctx = task->ctx;
+    Position pos;
+    positionInit(&pos, split->board, true);
+
+    while (!atomic_load(&split->stopped)) {
+        int i = atomic_fetch_add(&split->next, 1);
+        if (i >= split->num_moves) {
+            break;
+        }
+
+        makeMove(&pos, BB_INDEX(split->moves[i][0], split->moves[i][1]));
+        int alpha = atomic_load(&split->alpha);
+        int value = alphaBeta(ctx, &pos, split->depth - 1, 1, false, alpha - 1, INF);
+        unmakeMove(&pos);
+        if (ctx->stopped) {
+            atomic_store(&split->stopped, true);
+            break;
+        }
+
+        split->values[i] = value;
+        while (value > alpha && !atomic_compare_exchange_weak(&split->alpha, &alpha, value)) {
+        }
+    }
+}
+
+/**
+ * Parallel version of searchRoot(): the root moves are spread over the worker pool started by aiSetThreads().
+ * Ties are broken by the position of the move in the moves array, as in the sequential search.
+ *
+ * @param ctx The search context, whose deadline applies to every worker and which receives their node count.
+ * @param board The bitboard of the position.
+ * @param moves The root moves, in search order.
+ * @param num_moves The number of root moves.
+ * @param depth The depth of the search, the root move included.
+ * @param best_index Receives the index of the best move in the moves array.
+ * @return The score of the best move. Meaningless if the context was stopped during the search.
+ */
+static int searchRootParallel(SearchContext *ctx, Bitboard board, int moves[][2], int num_moves, int depth,
+                              int *best_index) {
+    RootSplit split;
+    RootTask tasks[searchThreads];
+
+    split.board = board;
+    split.moves = moves;
+    split.num_moves = num_moves;
+    split.depth = depth;
+    atomic_init(&split.next, 0);
+    atomic_init(&split.alpha, -INF);
+    atomic_init(&split.stopped, false);
+
+    for (int w = 0; w < searchThreads; w++) {
+        SearchContext *worker = &workerContexts[w];
+        if (depth == 1) {
+            initSearchContext(worker, ctx->table, 0);
+        } else {
+            // Later iterations keep the killer moves and the history of the previous ones
+            worker->stopped = false;
+            resetSearchCounters(worker);
+        }
+        worker->evaluator = ctx->evaluator;
+        worker->start = ctx->start;
+        worker->deadline = ctx->deadline;
+        worker->timed = ctx->timed;
+        tasks[w].split = &split;
+        tasks[w].ctx = worker;
+        threadPoolSubmit(&searchPool, searchRootTask, &tasks[w]);
+    }
+    threadPoolWait(&searchPool);
+
+    for (int w = 0; w < searchThreads; w++) {
+        mergeSearchCounters(ctx, &workerContexts[w]);
+    }
+    if (atomic_load(&split.stopped)) {
+        ctx->stopped = true;
+        return -INF;
+    }
+
+    int bestValue = -INF;
+    *best_index = 0;
+    for (int i = 0; i < num_moves; i++) {
+        if (split.values[i] > bestValue) {
+            bestValue = split.values[i];
+            *best_index = i;
+        }
+    }
+    return bestValue;
+}
+
+/**
+ * Sets the number of threads searching the root moves. The workers share the transposition table of the
+ * search, whose entries are read and written without locks.
+ *
+ * @param num_threads The number of search threads, 1 for the sequential search.
+ * @return True on success, false if the workers could not be started (the search then stays sequential).
+ */
+bool aiSetThreads(int num_threads) {
+    if (searchThreads > 1) {
+        threadPoolDestroy(&searchPool);
+        free(workerContexts);
+        workerContexts = NULL;
+    }
+    searchThreads = 1;
+    if (num_threads <= 1) {
+        return true;
+    }
+
+    workerContexts = calloc(num_threads, sizeof(SearchContext));
+    if (workerContexts == NULL || !threadPoolInit(&searchPool, num_threads, num_threads)) {
+        free(workerContexts);
+        workerContexts = NULL;
+        return false;
+    }
+    searchThreads = num_threads;
+    return true;
+}
+
+/**
+ * Makes the AI search with Young Brothers Wait work stealing instead of splitting the root moves:
+ * every node's younger brothers are shared by all the workers, which also share one transposition table.
+ *
+ * @param num_threads The number of search threads, 1 or less to go back to the search set by aiSetThreads().
+ * @return True on success, false if the workers could not be started (the previous search mode is kept).
+ */
+bool aiSetYbwcThreads(int num_threads) {
+    if (ybwcEnabled) {
+        ybwcDestroy(&ybwcSearch);
+        ybwcEnabled = false;
+    }
+    if (num_threads <= 1) {
+        return true;
+    }
+    ybwcEnabled = ybwcInit(&ybwcSearch, num_threads, hashBits);
+    return ybwcEnabled;
+}
+
+/**
+ * Iterative deepening driver: searches the root moves to depth 1, 2, 3... up to max_depth.
+ * After each completed iteration the best move is moved to the front, so the next iteration searches
+ * it first, and the transposition table provides the principal variation below the root. An iteration
+ * interrupted by the deadline is discarded; the first iteration always completes, so a move is always found.
+ * With more than one thread (see aiSetThreads()) the root moves of every iteration are searched in parallel,
+ * and with aiSetYbwcThreads() the whole tree is.
+ *
+ * @param ctx The search context, which holds the deadline.
+ * @param board The bitboard of the position.
+ * @param moves The root moves. On return, moves[0] is the best move of the last completed iteration.
+ * @param num_moves The number of root moves.
+ * @param max_depth The deepest iteration to run.
+ * @return The depth of the last completed iteration.
+ */
+int iterativeDeepening(SearchContext *ctx, Bitboard board, int moves[][2], int num_moves, int max_depth) {
+    int completed = 0;
+    bool timed = ctx->timed;
+
+    for (int depth = 1; depth <= max_depth && num_moves > 1; depth++) {
+        ctx->timed = timed && completed > 0;
+        uint64_t nodes_before = ctx->nodes;
+        int best_index;
+        int value;
+        if (ybwcEnabled && ctx->root_threads) {
+            uint64_t nodes = ybwcNodes(&ybwcSearch);
+            ybwcSetDeadline(&ybwcSearch, ctx->timed, ctx->deadline);
+            ybwcSearch.evaluator = ctx->evaluator;
+            value = ybwcSearchRoot(&ybwcSearch, board, moves, num_moves, depth, &best_index);
+            ctx->stopped = atomic_load(&ybwcSearch.stopped);
+            ctx->nodes += ybwcNodes(&ybwcSearch) - nodes;
+        } else if (searchThreads > 1 && ctx->root_threads) {
+            value = searchRootParallel(ctx, board, moves, num_moves, depth, &best_index);
+        } else {
+            value = searchRoot(ctx, board, moves, num_moves, depth, &best_index);
+        }
+        if (ctx->stopped) {
+            break;
+        }
+
+        int best_row = moves[best_index][0];
+        int best_col = moves[best_index][1];
+        for (int i = best_index; i > 0; i--) {
+            moves[i][0] = moves[i - 1][0];
+            moves[i][1] = moves[i - 1][1];
+        }
+        moves[0][0] = best_row;
+        moves[0][1] = best_col;
+        completed = depth;
+        ctx->score = value;
+        ctx->iteration_nodes[0] = ctx->iteration_nodes[1];
+        ctx->iteration_nodes[1] = ctx->nodes - nodes_before;
+    }
+    ctx->timed = timed;
+    return completed;
 }
 
 /**
@@ -108,8 +829,26 @@ int minimax(int board[ROWS][COLS], int depth, bool isMaximizing, int alpha, int
  * @param num_moves The number of moves in the array.
  */
 void shuffleMoves(int moves[][2], int num_moves) {
+    shuffleMovesSeeded(moves, num_moves, NULL);
+}
+
+/**
+ * Shuffles an array of moves with a generator owned by the caller, so that a search with its own seed
+ * is repeatable and shares no random state with the other threads.
+ *
+ * @param moves A 2D array containing the moves to be shuffled.
+ * @param num_moves The number of moves in the array.
+ * @param rng The generator, NULL for the AI's own one (see aiSetSeed()), which only the game's thread may use.
+ */
+void shuffleMovesSeeded(int moves[][2], int num_moves, Rng *rng) {
+    if (rng == NULL) {
+        if (!searchRngSeeded) {
+            aiSetSeed(searchSeed);
+        }
+        rng = &searchRng;
+    }
     for (int i = num_moves - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
+        int j = (int) rngBelow(rng, (uint32_t) (i + 1));
         int temp_row = moves[i][0];
         int temp_col = moves[i][1];
         moves[i][0] = moves[j][0];
@@ -119,76 +858,235 @@ void shuffleMoves(int moves[][2], int num_moves) {
     }
 }
 
+/**
+ * Orders moves by how often they won the recorded games: the move whose resulting position was lost
+ * most often by the opponent comes first. The order is stable, so moves never reached keep the order
+ * they had, and the search still decides: the prior only breaks ties between equally scored moves
+ * and helps the first iterations cut off sooner.
+ *
+ * @param index The position index, see loadPositionIndex().
+ * @param board The bitboard of the position.
+ * @param moves The moves to reorder.
+ * @param num_moves The number of moves.
+ */
+void sortMovesByPrior(const PositionIndex *index, Bitboard board, int moves[][2], int num_moves) {
+    double priors[ROWS * COLS];
+    for (int i = 0; i < num_moves; i++) {
+        Bitboard child = board & ~bitboardQuadrant(moves[i][0], moves[i][1]);
+        priors[i] = 1.0 - positionIndexWinRate(index, child);
+    }
+
+    // Insertion sort: there are never more than ROWS * COLS moves
+    for (int i = 1; i < num_moves; i++) {
+        double prior = priors[i];
+        int row = moves[i][0];
+        int col = moves[i][1];
+        int j = i;
+        while (j > 0 && priors[j - 1] < prior) {
+            priors[j] = priors[j - 1];
+            moves[j][0] = moves[j - 1][0];
+            moves[j][1] = moves[j - 1][1];
+            j--;
+        }
+        priors[j] = prior;
+        moves[j][0] = row;
+        moves[j][1] = col;
+    }
+}
+
+/**
+ * Loads a solution table written by the solver. Once loaded, aiChooseMove() plays perfectly
+ * by looking up the result of every move instead of searching. The file is mapped, not read,
+ * so every process of a server shares the same copy.
+ *
+ * @param path The path of the solution table file.
+ * @return True if the table was loaded, false otherwise (the AI keeps using the Minimax search).
+ */
+bool aiLoadSolution(const char *path) {
+    freeSolution(&solution);
+    if (!loadSolution(&solution, path)) {
+        return false;
+    }
+    printf("Solution table mapped from %s (%u positions).\n", path, solution.count);
+    return true;
+}
+
+/**
+ * Loads an opening book written by ./build/book. Positions of the book are then played without searching,
+ * always with the same move, unless a solution table is loaded too (it is looked up first).
+ *
+ * @param path The path of the book file.
+ * @return True if the book was loaded, false otherwise (the AI searches every position).
+ */
+bool aiLoadBook(const char *path) {
+    freeBook(&book);
+    if (!loadBook(&book, path)) {
+        return false;
+    }
+    printf("Opening book mapped from %s (%u moves).\n", path, book.count);
+    return true;
+}
+
+/**
+ * Loads a position index written by ./build/index. The root moves of every search are then tried in
+ * the order of their results in the recorded games (see sortMovesByPrior()).
+ *
+ * @param path The path of the index file.
+ * @return True if the index was loaded, false otherwise (the root moves are only shuffled).
+ */
+bool aiLoadPositionIndex(const char *path) {
+    freePositionIndex(&positionIndex);
+    if (!loadPositionIndex(&positionIndex, path)) {
+        return false;
+    }
+    printf("Position index mapped from %s (%u positions from %u games).\n", path, positionIndex.count,
+           positionIndex.games);
+    return true;
+}
+
+/**
+ * Sets the time budget of every following aiChooseMove() call.
+ *
+ * @param budget_ms The time budget per move in milliseconds, 0 to search to the fixed MAX_DEPTH.
+ */
+void aiSetTimeBudget(int budget_ms) {
+    timeBudget = budget_ms > 0 ? budget_ms : 0;
+}
+
+/**
+ * Seeds the generator that shuffles the moves of aiChooseMove(), so that a game can be replayed:
+ * with the same seed and the same opponent moves, the AI plays the same moves.
+ *
+ * @param seed The seed.
+ */
+void aiSetSeed(uint64_t seed) {
+    searchSeed = seed;
+    rngSeed(&searchRng, seed);
+    searchRngSeeded = true;
+}
+
+/**
+ * Returns the seed set by aiSetSeed().
+ *
+ * @return The seed, AI_DEFAULT_SEED if none was set.
+ */
+uint64_t aiSeed(void) {
+    return searchSeed;
+}
+
+/**
+ * Returns the time budget set by aiSetTimeBudget().
+ *
+ * @return The time budget per move in milliseconds, 0 for the fixed MAX_DEPTH.
+ */
+int aiTimeBudget(void) {
+    return timeBudget;
+}
+
 /**
  * Chooses the best move for the AI using the Minimax algorithm.
  * The AI evaluates all possible moves and selects the one with the highest score.
  * If only the A1 square is left, the AI will choose it by default.
+ * When a solution table is loaded, the perfect-play move is looked up instead of searched.
+ * The search uses the time budget set by aiSetTimeBudget(), or the fixed MAX_DEPTH if there is none.
  *
  * @param board A 2D array representing the game board with dimensions defined by ROWS and COLS constants.
  * @param best_row A pointer to an integer where the selected row index will be stored.
  * @param best_col A pointer to an integer where the selected column index will be stored.
  */
 void aiChooseMove(int board[ROWS][COLS], int *best_row, int *best_col) {
-    int moves[ROWS * COLS][2];
-    int num_moves = 0;
-    int only_A1_left = 1;
-
-    for (int r = 0; r < ROWS; r++) {
-        for (int c = 0; c < COLS; c++) {
-            if (canDestroy(board, r, c)) {
-                moves[num_moves][0] = r;
-                moves[num_moves][1] = c;
-                num_moves++;
-                if (!(r == 0 && c == 0)) {
-                    only_A1_left = 0;
-                }
-            }
-        }
-    }
+    aiChooseMoveTimed(board, timeBudget, best_row, best_col);
+}
 
-    if (!only_A1_left) {
-        int valid_moves[ROWS * COLS][2];
-        int valid_moves_count = 0;
+/**
+ * Chooses the best move for the AI within a time budget, using iterative deepening.
+ * Without a budget the search goes to the fixed MAX_DEPTH; with a budget it goes as deep as the
+ * budget allows, up to the number of squares left, and plays the best move of the last completed depth.
+ * A1 is only considered when it is the last square left.
+ *
+ * @param board A 2D array representing the game board with dimensions defined by ROWS and COLS constants.
+ * @param budget_ms The time budget in milliseconds, 0 to search to the fixed MAX_DEPTH.
+ * @param best_row A pointer to an integer where the selected row index will be stored.
+ * @param best_col A pointer to an integer where the selected column index will be stored.
+ */
+void aiChooseMoveTimed(int board[ROWS][COLS], int budget_ms, int *best_row, int *best_col) {
+    SearchContext ctx;
+    initSearchContext(&ctx, aiTranspositionTable(), budget_ms);
+    SearchStats stats;
+    int depth = aiSearchMove(&ctx, boardToBitboard(board), best_row, best_col);
+    searchStatsFill(&ctx, depth, *best_row, *best_col, &stats);
+    aiReportStats(&stats);
 
-        for (int i = 0; i < num_moves; i++) {
-            if (!(moves[i][0] == 0 && moves[i][1] == 0)) {
-                valid_moves[valid_moves_count][0] = moves[i][0];
-                valid_moves[valid_moves_count][1] = moves[i][1];
-                valid_moves_count++;
-            }
-        }
-        memcpy(moves, valid_moves, sizeof(valid_moves));
-        num_moves = valid_moves_count;
+    if (*best_row == -1) {
+        printf("AI could not find a valid move.\n");
+        return;
+    }
+    if (budget_ms > 0 && depth > 0) {
+        printf("AI searched to depth %d in %d ms (%llu nodes, %.0f%% of cutoffs on the first move)\n", depth,
+               searchElapsedMs(&ctx), (unsigned long long) ctx.nodes, 100.0 * searchFirstCutoffRate(&ctx));
     }
+    printf("AI chooses move at %c%d\n", *best_col + 'A', *best_row + 1);
+}
 
-    shuffleMoves(moves, num_moves);
+/**
+ * Chooses a move with a search context owned by the caller, without printing anything. Searches with
+ * their own context and transposition table, and root_threads cleared, may run at the same time on
+ * different threads (see aiService.c). The solution table is looked up first, if one is loaded.
+ *
+ * @param ctx The search context, prepared with initSearchContext(); its budget, or its max_depth without
+ *            a budget, limits the search, and its generator (if set) makes the choice between equal moves repeatable.
+ * @param bb The bitboard of the position.
+ * @param best_row Set to the row index of the move, -1 if there is no move.
+ * @param best_col Set to the column index of the move, -1 if there is no move.
+ * @return The depth of the last completed iteration, 0 if the move was looked up or forced.
+ */
+int aiSearchMove(SearchContext *ctx, Bitboard bb, int *best_row, int *best_col) {
+    int moves[ROWS * COLS][2];
+    int num_moves = 0;
 
-    int bestValue = -INF;
     *best_row = -1;
     *best_col = -1;
 
-    for (int i = 0; i < num_moves; i++) {
-        int r = moves[i][0];
-        int c = moves[i][1];
-
-        int new_board[ROWS][COLS];
-        memcpy(new_board, board, sizeof(int) * ROWS * COLS);
-        if (destroySquares(new_board, r, c)) {
-            int moveValue = minimax(new_board, MAX_DEPTH - 1, false, -INF, INF);
-            if (moveValue > bestValue) {
-                bestValue = moveValue;
-                *best_row = r;
-                *best_col = c;
-            }
-        }
+    if (solutionBestMove(&solution, bb, best_row, best_col)) {
+        ctx->source = "solution";
+        return 0;
+    }
+    if (bookBestMove(&book, bb, best_row, best_col)) {
+        ctx->source = "book";
+        return 0;
     }
 
-    if (*best_row == -1 && *best_col == -1 && only_A1_left) {
-        *best_row = 0;
-        *best_col = 0;
+    Bitboard legal = bitboardLegalMoves(bb);
+    if (legal & ~BB_CELL(0, 0)) {
+        legal &= ~BB_CELL(0, 0);
+    }
+    while (legal) {
+        int cell = __builtin_ctzll(legal);
+        legal &= legal - 1;
+        moves[num_moves][0] = cell / COLS;
+        moves[num_moves][1] = cell % COLS;
+        num_moves++;
     }
 
-    printf("AI chooses move at %c%d\n", *best_col + 'A', *best_row + 1);
+    if (num_moves == 0) {
+        return 0;
+    }
+    ctx->source = num_moves == 1 ? "forced" : "search";
+
+    // Entries of the previous moves are kept, but replaced first
+    ttNewSearch(ctx->table);
+    if (ybwcEnabled && ctx->root_threads) {
+        ttNewSearch(&ybwcSearch.table);
+    }
+    shuffleMovesSeeded(moves, num_moves, ctx->rng);
+    if (positionIndex.count > 0) {
+        sortMovesByPrior(&positionIndex, bb, moves, num_moves);
+    }
+    int depth = iterativeDeepening(ctx, bb, moves, num_moves, ctx->timed ? bitboardCount(bb) : ctx->max_depth);
+
+    *best_row = moves[0][0];
+    *best_col = moves[0][1];
+    return depth;
 }
 
 /**
@@ -0,0 +1,201 @@
+#include "../../includes/aiService.h"
+
+typedef struct {
+    AiService *service;
+    AiRequest *request;
+} AiTask;
+
+/**
+ * Searches one request on a pool thread, with a transposition table no other running search uses and
+ * a random generator of its own, then queues the result and its statistics and wakes the event loop
+ * through the eventfd.
+ *
+ * @param arg The AiTask, freed here.
+ */
+static void aiServiceTask(void *arg) {
+    AiTask *task = (AiTask *) arg;
+    AiService *service = task->service;
+    AiRequest *request = task->request;
+    free(task);
+
+    // At most num_threads tasks run at once, so a table is always free
+    pthread_mutex_lock(&service->lock);
+    TranspositionTable *table = service->free_tables[--service->num_free];
+    pthread_mutex_unlock(&service->lock);
+
+    SearchContext ctx;
+    Rng rng;
+    rngSeedStream(&rng, service->seed, request->stream);
+    initSearchContext(&ctx, table, request->budget_ms);
+    ctx.root_threads = false;
+    ctx.rng = &rng;
+    int depth = aiSearchMove(&ctx, request->board, &request->row, &request->col);
+    searchStatsFill(&ctx, depth, request->row, request->col, &request->stats);
+
+    pthread_mutex_lock(&service->lock);
+    service->free_tables[service->num_free++] = table;
+    request->next = NULL;
+    if (service->done_tail != NULL) {
+        service->done_tail->next = request;
+    } else {
+        service->done_head = request;
+    }
+    service->done_tail = request;
+    pthread_mutex_unlock(&service->lock);
+
+    uint64_t one = 1;
+    while (write(service->event_fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+}
+
+/**
+ * Starts an AI service: a pool of search threads, each with its own transposition table, a bounded
+ * queue of requests, and an eventfd that becomes readable when results are ready.
+ * The threads share the memory of one table of table_bits (the size set with '-hash', see aiHashBits()),
+ * each table being no smaller than AI_SERVICE_MIN_BITS.
+ *
+ * @param service The service to initialize.
+ * @param num_threads The number of search threads.
+ * @param capacity The maximum number of requests submitted and not collected yet.
+ * @param table_bits The base-2 logarithm of the number of entries of all the tables together.
+ * @return True on success, false otherwise.
+ */
+bool aiServiceInit(AiService *service, int num_threads, int capacity, int table_bits) {
+    memset(service, 0, sizeof(AiService));
+    service->num_threads = num_threads;
+    service->capacity = capacity;
+    service->seed = aiSeed();
+    service->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    service->tables = calloc(num_threads, sizeof(TranspositionTable));
+    service->free_tables = calloc(num_threads, sizeof(TranspositionTable *));
+    if (service->event_fd < 0 || service->tables == NULL || service->free_tables == NULL) {
+        aiServiceDestroy(service);
+        return false;
+    }
+    int bits = table_bits;
+    for (int n = 1; n < num_threads && bits > AI_SERVICE_MIN_BITS; n *= 2) {
+        bits--;
+    }
+    for (int i = 0; i < num_threads; i++) {
+        if (!ttInit(&service->tables[i], bits)) {
+            aiServiceDestroy(service);
+            return false;
+        }
+        service->free_tables[service->num_free++] = &service->tables[i];
+    }
+    pthread_mutex_init(&service->lock, NULL);
+
+    // The pool queue holds every request the service accepts, so submitting never blocks
+    if (!threadPoolInit(&service->pool, num_threads, capacity)) {
+        pthread_mutex_destroy(&service->lock);
+        memset(&service->pool, 0, sizeof(ThreadPool));
+        aiServiceDestroy(service);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Submits a position to search. The call never blocks: when capacity requests are already pending,
+ * the request is refused and the caller submits it again after collecting results.
+ *
+ * @param service The service.
+ * @param board The position, the AI moving.
+ * @param budget_ms The time budget in milliseconds, 0 for the fixed MAX_DEPTH.
+ * @param tag The caller's data, returned with the result.
+ * @return True if the request was queued, false if the queue is full or memory ran out.
+ */
+bool aiServiceSubmit(AiService *service, Bitboard board, int budget_ms, void *tag) {
+    if (service->pending >= service->capacity) {
+        return false;
+    }
+    AiRequest *request = malloc(sizeof(AiRequest));
+    AiTask *task = malloc(sizeof(AiTask));
+    if (request == NULL || task == NULL) {
+        free(request);
+        free(task);
+        return false;
+    }
+    *request = (AiRequest) {.tag = tag, .board = board, .budget_ms = budget_ms, .stream = service->next_stream++,
+                            .row = -1, .col = -1};
+    *task = (AiTask) {service, request};
+    service->pending++;
+    threadPoolSubmit(&service->pool, aiServiceTask, task);
+    return true;
+}
+
+/**
+ * Collects the results of completed requests, oldest first. Call it when the eventfd is readable;
+ * the eventfd stays readable if more results are left than fit in the array.
+ *
+ * @param service The service.
+ * @param results Filled with the results.
+ * @param max_results The size of the results array.
+ * @return The number of results collected.
+ */
+int aiServiceCollect(AiService *service, AiResult *results, int max_results) {
+    uint64_t count;
+    while (read(service->event_fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+    }
+
+    int n = 0;
+    pthread_mutex_lock(&service->lock);
+    while (service->done_head != NULL && n < max_results) {
+        AiRequest *request = service->done_head;
+        service->done_head = request->next;
+        results[n++] = (AiResult) {request->tag, request->row, request->col, request->stats};
+        free(request);
+    }
+    if (service->done_head == NULL) {
+        service->done_tail = NULL;
+    }
+    bool more = service->done_head != NULL;
+    pthread_mutex_unlock(&service->lock);
+    service->pending -= n;
+
+    if (more) {
+        uint64_t one = 1;
+        while (write(service->event_fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+        }
+    }
+    return n;
+}
+
+/**
+ * Returns the eventfd of a service, to watch with epoll, poll or a GLib source.
+ *
+ * @param service The service.
+ * @return The file descriptor, readable while results wait to be collected.
+ */
+int aiServiceFd(AiService *service) {
+    return service->event_fd;
+}
+
+/**
+ * Waits for the running searches, then releases the service and the results never collected.
+ *
+ * @param service The service.
+ */
+void aiServiceDestroy(AiService *service) {
+    if (service->pool.threads != NULL) {
+        threadPoolDestroy(&service->pool);
+        pthread_mutex_destroy(&service->lock);
+    }
+    while (service->done_head != NULL) {
+        AiRequest *request = service->done_head;
+        service->done_head = request->next;
+        free(request);
+    }
+    if (service->tables != NULL) {
+        for (int i = 0; i < service->num_threads; i++) {
+            ttFree(&service->tables[i]);
+        }
+    }
+    free(service->tables);
+    free(service->free_tables);
+    if (service->event_fd >= 0) {
+        close(service->event_fd);
+    }
+    memset(service, 0, sizeof(AiService));
+    service->event_fd = -1;
+}
@@ -0,0 +1,110 @@
+#include "../../includes/batch.h"
+
+typedef struct {
+    BatchEvaluator *batch;
+    TranspositionTable *table;
+} BatchTask;
+
+/**
+ * Work of one thread: takes the next position until none is left. Each search starts from a cleared
+ * table, and its shuffle has its own generator seeded by the index of the position, so a result only depends on the
+ * position, its index and the options, whatever thread ran it.
+ *
+ * @param arg The BatchTask of the thread.
+ */
+static void batchTask(void *arg) {
+    BatchTask *task = (BatchTask *) arg;
+    BatchEvaluator *batch = task->batch;
+    SearchContext ctx;
+
+    while (true) {
+        int i = atomic_fetch_add(&batch->next, 1);
+        if (i >= batch->count) {
+            break;
+        }
+        BatchPosition *position = &batch->positions[i];
+        Rng rng;
+        rngSeedStream(&rng, batch->options.seed, (uint64_t) i);
+
+        ttClear(task->table);
+        initSearchContext(&ctx, task->table, batch->options.budget_ms);
+        ctx.root_threads = false;
+        ctx.max_depth = batch->options.depth;
+        ctx.rng = &rng;
+        if (batch->options.evaluator != NULL) {
+            ctx.evaluator = batch->options.evaluator;
+        }
+        position->depth = aiSearchMove(&ctx, position->board, &position->row, &position->col);
+        position->score = ctx.score;
+        position->nodes = ctx.nodes;
+    }
+}
+
+/**
+ * Starts the threads of a batch evaluator and allocates their tables. Nothing is shared with the
+ * AI of the game, so several evaluators may run at once, next to aiChooseMove().
+ *
+ * @param batch The evaluator to initialize.
+ * @param options The number of threads and the settings of every search.
+ * @return True on success, false if memory ran out or the threads could not be started.
+ */
+bool batchInit(BatchEvaluator *batch, const BatchOptions *options) {
+    memset(batch, 0, sizeof(BatchEvaluator));
+    batch->options = *options;
+    batch->tables = calloc(options->num_threads, sizeof(TranspositionTable));
+    if (batch->tables == NULL) {
+        return false;
+    }
+    for (int i = 0; i < options->num_threads; i++) {
+        if (!ttInit(&batch->tables[i], BATCH_TABLE_BITS)) {
+            batchDestroy(batch);
+            return false;
+        }
+    }
+    if (!threadPoolInit(&batch->pool, options->num_threads, options->num_threads)) {
+        memset(&batch->pool, 0, sizeof(ThreadPool));
+        batchDestroy(batch);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Searches every position of an array on the evaluator's threads and fills in the results.
+ * The call returns once the whole array is done; it must not be called from two threads at once
+ * on the same evaluator.
+ *
+ * @param batch The evaluator.
+ * @param positions The positions, whose results are filled in.
+ * @param count The number of positions.
+ */
+void batchEvaluate(BatchEvaluator *batch, BatchPosition *positions, int count) {
+    BatchTask tasks[batch->options.num_threads];
+    batch->positions = positions;
+    batch->count = count;
+    atomic_init(&batch->next, 0);
+
+    for (int t = 0; t < batch->options.num_threads; t++) {
+        tasks[t] = (BatchTask) {batch, &batch->tables[t]};
+        threadPoolSubmit(&batch->pool, batchTask, &tasks[t]);
+    }
+    threadPoolWait(&batch->pool);
+}
+
+/**
+ * Stops the threads of a batch evaluator and releases its tables.
+ *
+ * @param batch The evaluator.
+ */
+void batchDestroy(BatchEvaluator *batch) {
+    if (batch->pool.threads != NULL) {
+        threadPoolDestroy(&batch->pool);
+    }
+    if (batch->tables != NULL) {
+        for (int i = 0; i < batch->options.num_threads; i++) {
+            ttFree(&batch->tables[i]);
+        }
+    }
+    free(batch->tables);
+    memset(batch, 0, sizeof(BatchEvaluator));
+}
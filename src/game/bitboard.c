@@ -0,0 +1,183 @@
+#include "../../includes/bitboard.h"
+
+_Static_assert(ROWS * COLS < 64, "the board must fit in a 64-bit bitboard");
+
+// Bits of one full row, and the first square of every row (BB_FULL = ROW_MASK * ROW_STARTS)
+#define ROW_MASK ((((Bitboard) 1) << COLS) - 1)
+#define ROW_STARTS (BB_FULL / ROW_MASK)
+
+/**
+ * Converts a board stored as a 2D array into its bitboard representation.
+ *
+ * @param board A 2D array representing the game board with dimensions defined by ROWS and COLS constants.
+ * @return A bitboard with the bit of every square still present set.
+ */
+Bitboard boardToBitboard(int board[ROWS][COLS]) {
+    Bitboard bb = 0;
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            if (board[i][j] == 1) {
+                bb |= BB_CELL(i, j);
+            }
+        }
+    }
+    return bb;
+}
+
+/**
+ * Writes a bitboard back into a board stored as a 2D array, so the console, GUI and network code
+ * can keep working on their usual representation.
+ *
+ * @param bb The bitboard to convert.
+ * @param board A 2D array that receives 1 for every present square and 0 for every destroyed one.
+ */
+void bitboardToBoard(Bitboard bb, int board[ROWS][COLS]) {
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            board[i][j] = (bb & BB_CELL(i, j)) ? 1 : 0;
+        }
+    }
+}
+
+/**
+ * Computes the mask of the squares destroyed by a move, i.e. every square below and to the right of
+ * the given square, itself included. The mask is built without any loop: the column range of one row
+ * is replicated on every row by a multiplication, then the rows above the move are cleared.
+ *
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return The mask of the squares covered by the move.
+ */
+Bitboard bitboardQuadrant(int row, int col) {
+    Bitboard columns = ROW_STARTS * (ROW_MASK ^ ((((Bitboard) 1) << col) - 1));
+    Bitboard rows = BB_FULL ^ ((((Bitboard) 1) << BB_INDEX(row, 0)) - 1);
+    return columns & rows;
+}
+
+/**
+ * Counts the squares still present on a bitboard.
+ *
+ * @param bb The bitboard to count.
+ * @return The number of set bits.
+ */
+int bitboardCount(Bitboard bb) {
+    return __builtin_popcountll(bb);
+}
+
+/**
+ * Checks if a specific square of a bitboard can be destroyed, i.e. it is within bounds and still present.
+ *
+ * @param bb The bitboard to check.
+ * @param row The row index of the square to check.
+ * @param col The column index of the square to check.
+ * @return True if the square can be destroyed, false otherwise.
+ */
+bool bitboardCanDestroy(Bitboard bb, int row, int col) {
+    if (row < 0 || row >= ROWS || col < 0 || col >= COLS) {
+        return false;
+    }
+    return (bb & BB_CELL(row, col)) != 0;
+}
+
+/**
+ * Counts the squares that a move at the given square would destroy.
+ * On the staircase-shaped boards produced by the game this is the same value as countSquares().
+ *
+ * @param bb The bitboard to inspect.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return The number of present squares below and to the right of the given square, itself included.
+ */
+int bitboardCountSquares(Bitboard bb, int row, int col) {
+    return bitboardCount(bb & bitboardQuadrant(row, col));
+}
+
+/**
+ * Checks a move against the rules of the game: the square must be on the board and present, and the move
+ * may not destroy more than MOVE_LIMIT squares. Used to check the moves received from the network.
+ *
+ * @param bb The bitboard of the position.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return True if the move is legal, false otherwise.
+ */
+bool bitboardIsLegalMove(Bitboard bb, int row, int col) {
+    return row >= 0 && row < ROWS && col >= 0 && col < COLS &&
+           bitboardCanDestroy(bb, row, col) && bitboardCountSquares(bb, row, col) <= MOVE_LIMIT;
+}
+
+/**
+ * Destroys the squares covered by a move, if the move stays within the limit of MOVE_LIMIT squares.
+ *
+ * @param bb A pointer to the bitboard to update.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return True if the squares were destroyed, false if the move exceeds the limit (the bitboard is left untouched).
+ */
+bool bitboardDestroySquares(Bitboard *bb, int row, int col) {
+    Bitboard quadrant = *bb & bitboardQuadrant(row, col);
+    if (bitboardCount(quadrant) > MOVE_LIMIT) {
+        return false;
+    }
+    *bb &= ~quadrant;
+    return true;
+}
+
+/**
+ * Computes the legal moves of one row from the staircase frontier, i.e. the row lengths.
+ * Only the last squares of a row can stay within the limit: the scan starts at the end of the row and
+ * stops at the first square whose move destroys more than MOVE_LIMIT squares, as every square on its
+ * left destroys even more. Each count stops as soon as it exceeds the limit, so a row costs at most
+ * MOVE_LIMIT * MOVE_LIMIT steps whatever the size of the board.
+ *
+ * @param lengths The number of squares left on each row, non-increasing from the top row to the bottom row.
+ * @param row The row index.
+ * @return A bitboard with the bit of every legal move of the row set.
+ */
+Bitboard bitboardRowMoves(const uint8_t lengths[ROWS], int row) {
+    Bitboard moves = 0;
+    for (int col = lengths[row] - 1; col >= 0; col--) {
+        int count = 0;
+        for (int k = row; k < ROWS && lengths[k] > col && count <= MOVE_LIMIT; k++) {
+            count += lengths[k] - col;
+        }
+        if (count > MOVE_LIMIT) {
+            break;
+        }
+        moves |= BB_CELL(row, col);
+    }
+    return moves;
+}
+
+/**
+ * Computes the set of legal moves of a position: every present square whose move destroys
+ * at most MOVE_LIMIT squares. The moves are read from the staircase frontier rather than by counting
+ * the squares covered by every present square, so the board must be staircase-shaped, as every
+ * position reached from the full board is.
+ *
+ * @param bb The bitboard of the position.
+ * @return A bitboard with the bit of every legal move set.
+ */
+Bitboard bitboardLegalMoves(Bitboard bb) {
+    uint8_t lengths[ROWS];
+    Bitboard legal = 0;
+    for (int i = 0; i < ROWS; i++) {
+        lengths[i] = (uint8_t) bitboardRowLength(bb, i);
+    }
+    for (int i = 0; i < ROWS && lengths[i] > 0; i++) {
+        legal |= bitboardRowMoves(lengths, i);
+    }
+    return legal;
+}
+
+/**
+ * Returns the number of squares still present on a row. Rows of the staircase-shaped boards
+ * produced by the game are always a prefix, so this is also the index of the first destroyed column.
+ *
+ * @param bb The bitboard to inspect.
+ * @param row The row index.
+ * @return The number of present squares on the row.
+ */
+int bitboardRowLength(Bitboard bb, int row) {
+    return bitboardCount((bb >> BB_INDEX(row, 0)) & ROW_MASK);
+}
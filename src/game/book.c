@@ -0,0 +1,232 @@
+#include "../../includes/book.h"
+
+/**
+ * Compares two bitboards by staircase rank, for qsort().
+ *
+ * @param a A pointer to the first bitboard.
+ * @param b A pointer to the second bitboard.
+ * @return A negative, zero or positive value as the first rank is lower, equal or higher.
+ */
+static int compareRanks(const void *a, const void *b) {
+    uint32_t rank_a = staircaseRank(staircaseFromBitboard(*(const Bitboard *) a));
+    uint32_t rank_b = staircaseRank(staircaseFromBitboard(*(const Bitboard *) b));
+    return (rank_a > rank_b) - (rank_a < rank_b);
+}
+
+/**
+ * Lists the positions reached in fewer than 'plies' moves from the full board, each once, whatever the
+ * move order. A1 is never eaten, as the AI only eats it when forced.
+ *
+ * @param plies The number of moves covered, 1 for the starting position only.
+ * @param positions Receives an array of the positions, sorted by staircase rank, to free by the caller.
+ * @return The number of positions, -1 if the memory could not be allocated.
+ */
+int bookPositions(int plies, Bitboard **positions) {
+    uint32_t count = staircaseCount();
+    uint8_t *seen = calloc(count, 1);
+    Bitboard *list = malloc(count * sizeof(Bitboard));
+    if (seen == NULL || list == NULL) {
+        free(seen);
+        free(list);
+        return -1;
+    }
+
+    int num_positions = 0;
+    int level_start = 0;
+    list[num_positions++] = BB_FULL;
+    seen[staircaseRank(staircaseFromBitboard(BB_FULL))] = 1;
+
+    // Breadth-first: the positions of each ply are the children of the previous ply's positions
+    for (int ply = 1; ply < plies; ply++) {
+        int level_end = num_positions;
+        for (int p = level_start; p < level_end; p++) {
+            Bitboard legal = bitboardLegalMoves(list[p]) & ~BB_CELL(0, 0);
+            while (legal) {
+                int cell = __builtin_ctzll(legal);
+                legal &= legal - 1;
+                Bitboard child = list[p] & ~bitboardQuadrant(cell / COLS, cell % COLS);
+                uint32_t rank = staircaseRank(staircaseFromBitboard(child));
+                if (child != BB_CELL(0, 0) && !seen[rank]) {
+                    seen[rank] = 1;
+                    list[num_positions++] = child;
+                }
+            }
+        }
+        level_start = level_end;
+    }
+
+    free(seen);
+    qsort(list, num_positions, sizeof(Bitboard), compareRanks);
+    *positions = list;
+    return num_positions;
+}
+
+/**
+ * Orders book entries by position, then by move, for qsort() and the binary search of bookLookup().
+ *
+ * @param a A pointer to the first BookEntry.
+ * @param b A pointer to the second BookEntry.
+ * @return A negative, zero or positive value as the first entry sorts before, with or after the second.
+ */
+int compareBookEntries(const void *a, const void *b) {
+    const BookEntry *entry_a = (const BookEntry *) a;
+    const BookEntry *entry_b = (const BookEntry *) b;
+    if (entry_a->rank != entry_b->rank) {
+        return (entry_a->rank > entry_b->rank) - (entry_a->rank < entry_b->rank);
+    }
+    return (int) entry_a->cell - (int) entry_b->cell;
+}
+
+/**
+ * Writes an opening book: a BookHeader followed by the entries, which must be sorted with compareBookEntries().
+ *
+ * @param entries The entries.
+ * @param count The number of entries.
+ * @param plies The number of moves from the start covered by the book.
+ * @param depth The depth of the searches that scored the moves.
+ * @param path The path of the file to create.
+ * @return True on success, false otherwise.
+ */
+bool saveBook(const BookEntry *entries, uint32_t count, int plies, int depth, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("fopen");
+        return false;
+    }
+
+    BookHeader header = {0};
+    memcpy(header.magic, BOOK_MAGIC, sizeof(header.magic));
+    header.version = BOOK_VERSION;
+    header.rows = ROWS;
+    header.cols = COLS;
+    header.move_limit = MOVE_LIMIT;
+    header.plies = (uint8_t) plies;
+    header.depth = (uint8_t) depth;
+    header.count = count;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(entries, sizeof(BookEntry), count, file) == count;
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ * Maps an opening book written by saveBook() read-only, as loadSolution() does for solution tables.
+ * The book is rejected if it was built for another board size, move limit or format version.
+ *
+ * @param book The book to fill. Its entries point into the mapping until freeBook() is called.
+ * @param path The path of the file to map.
+ * @return True on success, false if the file is missing, truncated or does not match this board.
+ */
+bool loadBook(OpeningBook *book, const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("open");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(BookHeader)) {
+        printf("%s is not an opening book.\n", path);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    const BookHeader *header = (const BookHeader *) map;
+    const char *error = NULL;
+    if (memcmp(header->magic, BOOK_MAGIC, sizeof(header->magic)) != 0) {
+        error = "is not an opening book";
+    } else if (header->version != BOOK_VERSION) {
+        error = "was written by another version of the book generator";
+    } else if (header->rows != ROWS || header->cols != COLS || header->move_limit != MOVE_LIMIT) {
+        error = "is not an opening book for this board";
+    } else if ((size_t) st.st_size != sizeof(BookHeader) + (size_t) header->count * sizeof(BookEntry)) {
+        error = "is truncated";
+    }
+    if (error != NULL) {
+        printf("%s %s.\n", path, error);
+        munmap(map, (size_t) st.st_size);
+        return false;
+    }
+
+    book->map = map;
+    book->map_size = (size_t) st.st_size;
+    book->count = header->count;
+    book->entries = (const BookEntry *) ((const uint8_t *) map + sizeof(BookHeader));
+    return true;
+}
+
+/**
+ * Unmaps an opening book.
+ *
+ * @param book The book to release.
+ */
+void freeBook(OpeningBook *book) {
+    if (book->map != NULL) {
+        munmap(book->map, book->map_size);
+    }
+    memset(book, 0, sizeof(OpeningBook));
+}
+
+/**
+ * Finds the moves of a position in the book, by binary search on the staircase rank.
+ *
+ * @param book The opening book.
+ * @param board The bitboard of the position.
+ * @param first Receives the first entry of the position.
+ * @return The number of entries of the position, 0 if it is not in the book (or no book is loaded).
+ */
+int bookLookup(const OpeningBook *book, Bitboard board, const BookEntry **first) {
+    if (book->entries == NULL) {
+        return 0;
+    }
+    uint32_t rank = staircaseRank(staircaseFromBitboard(board));
+    uint32_t low = 0, high = book->count;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (book->entries[mid].rank < rank) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    int count = 0;
+    while (low + count < book->count && book->entries[low + count].rank == rank) {
+        count++;
+    }
+    *first = &book->entries[low];
+    return count;
+}
+
+/**
+ * Chooses the book move of a position: its best-scoring move, the first one in row-major order on ties,
+ * so the same position always gets the same move.
+ *
+ * @param book The opening book.
+ * @param board The bitboard of the position.
+ * @param best_row Receives the row index of the move.
+ * @param best_col Receives the column index of the move.
+ * @return True if the position is in the book, false otherwise.
+ */
+bool bookBestMove(const OpeningBook *book, Bitboard board, int *best_row, int *best_col) {
+    const BookEntry *entries;
+    int count = bookLookup(book, board, &entries);
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        if (best == -1 || entries[i].score > entries[best].score) {
+            best = i;
+        }
+    }
+    if (best == -1) {
+        return false;
+    }
+    *best_row = entries[best].cell / COLS;
+    *best_col = entries[best].cell % COLS;
+    return true;
+}
@@ -0,0 +1,135 @@
+#include "../../includes/evaluator.h"
+
+/**
+ * Material evaluation, the original one of the AI: the number of squares still present,
+ * whoever is to move. The game is over once the board is empty.
+ *
+ * @param board The bitboard of the position.
+ * @param isMaximizing A boolean indicating whether the maximizing player is to move (unused).
+ * @param ply The distance from the root of the search (unused).
+ * @param terminal Set to true if the game is over.
+ * @return The number of squares still present.
+ */
+static int evaluateMaterial(Bitboard board, bool isMaximizing, int ply, bool *terminal) {
+    (void) isMaximizing;
+    (void) ply;
+    *terminal = board == 0;
+    return bitboardCount(board);
+}
+
+/**
+ * Win/loss evaluation: an empty board means the previous player ate A1, so the player to move has won.
+ * Wins found closer to the root score higher, so the AI takes the shortest win and delays a loss.
+ * Any other position is unknown and scores 0.
+ *
+ * @param board The bitboard of the position.
+ * @param isMaximizing A boolean indicating whether the maximizing player is to move.
+ * @param ply The distance from the root of the search.
+ * @param terminal Set to true if the game is over.
+ * @return EVAL_WIN - ply for a maximizing win, its opposite for a minimizing win, 0 otherwise.
+ */
+static int evaluateWinLoss(Bitboard board, bool isMaximizing, int ply, bool *terminal) {
+    *terminal = board == 0;
+    if (!*terminal) {
+        return 0;
+    }
+    return isMaximizing ? EVAL_WIN - ply : ply - EVAL_WIN;
+}
+
+/**
+ * Staircase evaluation: win/loss scoring, plus the exact outcome of L-shaped positions and a tempo bonus.
+ * When only the first row and the first column are left, the two arms are independent subtraction games
+ * (take 1 to MOVE_LIMIT squares from the end of an arm) whose Grundy values are their lengths modulo
+ * MOVE_LIMIT + 1: the player to move loses exactly when both arms have the same value.
+ * In any other position the player to move is slightly favoured, as in most Chomp positions.
+ *
+ * @param board The bitboard of the position.
+ * @param isMaximizing A boolean indicating whether the maximizing player is to move.
+ * @param ply The distance from the root of the search.
+ * @param terminal Set to true if the game is over.
+ * @return The score of the position for the maximizing player.
+ */
+static int evaluateStaircase(Bitboard board, bool isMaximizing, int ply, bool *terminal) {
+    if (board == 0) {
+        return evaluateWinLoss(board, isMaximizing, ply, terminal);
+    }
+    *terminal = false;
+
+    int score = EVAL_TEMPO;
+    if ((board & bitboardQuadrant(1, 1)) == 0) {
+        int row_arm = bitboardCount(board & ~bitboardQuadrant(1, 0)) - 1;
+        int col_arm = bitboardCount(board & ~bitboardQuadrant(0, 1)) - 1;
+        score = (row_arm % (MOVE_LIMIT + 1) == col_arm % (MOVE_LIMIT + 1)) ? -EVAL_KNOWN : EVAL_KNOWN;
+    }
+    return isMaximizing ? score : -score;
+}
+
+// Every evaluator, selectable by name
+static const Evaluator EVALUATORS[] = {
+    {"material", "Number of squares left (the original evaluation)", evaluateMaterial},
+    {"winloss", "Wins and losses only, shortest win first", evaluateWinLoss},
+    {"staircase", "Wins and losses, exact L-shaped endgames and a tempo bonus", evaluateStaircase},
+};
+
+/**
+ * Finds an evaluator by name.
+ *
+ * @param name The name of the evaluator.
+ * @return The evaluator, or NULL if no evaluator has this name.
+ */
+const Evaluator *evaluatorByName(const char *name) {
+    for (size_t i = 0; i < sizeof(EVALUATORS) / sizeof(EVALUATORS[0]); i++) {
+        if (strcmp(EVALUATORS[i].name, name) == 0) {
+            return &EVALUATORS[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Returns an evaluator by index, to list the available evaluators.
+ *
+ * @param index The index of the evaluator, from 0.
+ * @return The evaluator, or NULL past the last one.
+ */
+const Evaluator *evaluatorAt(int index) {
+    if (index < 0 || (size_t) index >= sizeof(EVALUATORS) / sizeof(EVALUATORS[0])) {
+        return NULL;
+    }
+    return &EVALUATORS[index];
+}
+
+/**
+ * Converts a score before storing it in a transposition table. Win and loss scores count the plies
+ * from the root, while the entry may be reached at another ply: they are stored relative to the node.
+ *
+ * @param score The score returned by the search of the node.
+ * @param ply The distance of the node from the root.
+ * @return The score to store.
+ */
+int evalScoreToTable(int score, int ply) {
+    if (score > EVAL_MATE) {
+        return score + ply;
+    }
+    if (score < -EVAL_MATE) {
+        return score - ply;
+    }
+    return score;
+}
+
+/**
+ * Converts a score read from a transposition table back to the ply of the node, see evalScoreToTable().
+ *
+ * @param score The stored score.
+ * @param ply The distance of the node from the root.
+ * @return The score of the node.
+ */
+int evalScoreFromTable(int score, int ply) {
+    if (score > EVAL_MATE) {
+        return score - ply;
+    }
+    if (score < -EVAL_MATE) {
+        return score + ply;
+    }
+    return score;
+}
@@ -0,0 +1,458 @@
+#include "../../includes/gameRecord.h"
+
+static FILE *recordOut = NULL;          // File the finished games are appended to, NULL if none
+static GameRecord currentGame;          // Game of the single-game modes, see recordStartGame()
+static bool gameInProgress = false;
+
+/**
+ * Starts recording a game on an empty board.
+ *
+ * @param record The record to initialize.
+ * @param rows The number of rows of the board, up to BOARD_MAX_ROWS.
+ * @param cols The number of columns of the board, up to BOARD_MAX_COLS.
+ */
+void gameRecordInit(GameRecord *record, int rows, int cols) {
+    record->rows = rows;
+    record->cols = cols;
+    record->num_moves = 0;
+}
+
+/**
+ * Adds a move to a record. The move is not checked against the board: the modes record the moves
+ * they have already played.
+ *
+ * @param record The record.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return True if the move was added, false if it is off the board or the record is full.
+ */
+bool gameRecordAddMove(GameRecord *record, int row, int col) {
+    if (row < 0 || row >= record->rows || col < 0 || col >= record->cols || record->num_moves == RECORD_MAX_MOVES) {
+        return false;
+    }
+    record->moves[record->num_moves++] = (uint8_t) (row * record->cols + col);
+    return true;
+}
+
+/**
+ * Opens the file the games are appended to, creating it with its header if it is empty.
+ * Games already in the file are kept.
+ *
+ * @param path The path of the record file.
+ * @return True if the file is ready, false if it could not be opened or is not a record file.
+ */
+bool recordOpen(const char *path) {
+    recordClose();
+    FILE *file = fopen(path, "a+b");
+    if (file == NULL) {
+        perror("fopen");
+        return false;
+    }
+
+    // Writes always go to the end of the file in append mode, reads start where we seek
+    uint8_t header[RECORD_FILE_HEADER_SIZE] = {0};
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        memcpy(header, RECORD_MAGIC, 4);
+        header[4] = RECORD_VERSION;
+        if (fwrite(header, 1, sizeof(header), file) != sizeof(header) || fflush(file) != 0) {
+            perror("fwrite");
+            fclose(file);
+            return false;
+        }
+    } else {
+        fseek(file, 0, SEEK_SET);
+        if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+            memcmp(header, RECORD_MAGIC, 4) != 0 || header[4] != RECORD_VERSION) {
+            printf("%s is not a game record file.\n", path);
+            fclose(file);
+            return false;
+        }
+        // A write may only follow a read after a positioning call
+        fseek(file, 0, SEEK_END);
+    }
+    recordOut = file;
+    return true;
+}
+
+/**
+ * Appends a game to the record file with a single write, so that the games of several processes
+ * appending to the same file do not interleave.
+ *
+ * @param record The moves of the game.
+ * @param loser RECORD_FIRST_LOSES, RECORD_SECOND_LOSES or RECORD_UNFINISHED.
+ * @return True if the game was written, false if no file is open or the write failed.
+ */
+bool recordAppend(const GameRecord *record, int loser) {
+    if (recordOut == NULL) {
+        return false;
+    }
+    uint8_t buffer[RECORD_GAME_HEADER_SIZE + RECORD_MAX_MOVES];
+    buffer[0] = (uint8_t) record->rows;
+    buffer[1] = (uint8_t) record->cols;
+    buffer[2] = (uint8_t) loser;
+    buffer[3] = 0;
+    buffer[4] = (uint8_t) (record->num_moves & 0xFF);
+    buffer[5] = (uint8_t) (record->num_moves >> 8);
+    memcpy(buffer + RECORD_GAME_HEADER_SIZE, record->moves, (size_t) record->num_moves);
+
+    size_t size = RECORD_GAME_HEADER_SIZE + (size_t) record->num_moves;
+    if (fwrite(buffer, 1, size, recordOut) != size || fflush(recordOut) != 0) {
+        perror("fwrite");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Closes the record file, keeping the game in progress as unfinished.
+ */
+void recordClose(void) {
+    if (recordOut == NULL) {
+        return;
+    }
+    recordEndGame(RECORD_UNFINISHED);
+    fclose(recordOut);
+    recordOut = NULL;
+}
+
+/**
+ * Starts recording the game of a single-game mode (local, server or client), if a record file is open.
+ * A game still in progress is kept as unfinished.
+ *
+ * @param rows The number of rows of the board.
+ * @param cols The number of columns of the board.
+ */
+void recordStartGame(int rows, int cols) {
+    recordEndGame(RECORD_UNFINISHED);
+    gameRecordInit(&currentGame, rows, cols);
+    gameInProgress = recordOut != NULL;
+}
+
+/**
+ * Records a move of the current game. Eating A1 ends the game, the player who ate it losing.
+ *
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ */
+void recordMove(int row, int col) {
+    if (!gameInProgress || !gameRecordAddMove(&currentGame, row, col)) {
+        return;
+    }
+    if (row == 0 && col == 0) {
+        recordEndGame((currentGame.num_moves - 1) % 2);
+    }
+}
+
+/**
+ * Ends the current game and appends it to the record file. Does nothing if no game is in progress.
+ *
+ * @param loser RECORD_FIRST_LOSES, RECORD_SECOND_LOSES or RECORD_UNFINISHED.
+ */
+void recordEndGame(int loser) {
+    if (!gameInProgress) {
+        return;
+    }
+    gameInProgress = false;
+    recordAppend(&currentGame, loser);
+}
+
+/**
+ * Reads the header of the game at an offset of a record file.
+ *
+ * @param data The content of the file.
+ * @param offset The offset of the game's header.
+ * @param game Receives the game.
+ * @return True if the header describes a game, false if it is corrupted.
+ */
+static bool readGameHeader(const uint8_t *data, size_t offset, RecordGame *game) {
+    const uint8_t *header = data + offset;
+    game->rows = header[0];
+    game->cols = header[1];
+    game->loser = header[2];
+    game->num_moves = header[4] | (header[5] << 8);
+    game->moves = header + RECORD_GAME_HEADER_SIZE;
+    return game->rows >= 1 && game->rows <= BOARD_MAX_ROWS && game->cols >= 1 && game->cols <= BOARD_MAX_COLS &&
+           game->num_moves <= game->rows * game->cols &&
+           (game->loser == RECORD_FIRST_LOSES || game->loser == RECORD_SECOND_LOSES ||
+            game->loser == RECORD_UNFINISHED);
+}
+
+/**
+ * Maps a record file in memory and indexes its games. A game cut short at the end of the file
+ * (the writer was killed) is left out.
+ *
+ * @param file Receives the file, to release with freeRecords().
+ * @param path The path of the record file.
+ * @return True if the file was loaded, false if it could not be read or is not a record file.
+ */
+bool loadRecords(RecordFile *file, const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("open");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < RECORD_FILE_HEADER_SIZE) {
+        printf("%s is not a game record file.\n", path);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    // Count the games, then note where each one starts
+    const uint8_t *data = (const uint8_t *) map;
+    size_t size = (size_t) st.st_size;
+    const char *error = NULL;
+    uint64_t count = 0;
+    size_t offset = RECORD_FILE_HEADER_SIZE;
+    RecordGame game;
+    if (memcmp(data, RECORD_MAGIC, 4) != 0) {
+        error = "is not a game record file";
+    } else if (data[4] != RECORD_VERSION) {
+        error = "was written by another version of the game";
+    }
+    while (error == NULL && offset + RECORD_GAME_HEADER_SIZE <= size) {
+        if (!readGameHeader(data, offset, &game)) {
+            error = "is corrupted";
+        } else if (offset + RECORD_GAME_HEADER_SIZE + (size_t) game.num_moves > size) {
+            break;
+        } else {
+            offset += RECORD_GAME_HEADER_SIZE + (size_t) game.num_moves;
+            count++;
+        }
+    }
+    uint64_t *offsets = error == NULL ? malloc((count > 0 ? count : 1) * sizeof(uint64_t)) : NULL;
+    if (error == NULL && offsets == NULL) {
+        error = "could not be indexed";
+    }
+    if (error != NULL) {
+        printf("%s %s.\n", path, error);
+        munmap(map, size);
+        return false;
+    }
+    if (offset != size) {
+        printf("%s ends with an incomplete game, it is skipped.\n", path);
+    }
+
+    offset = RECORD_FILE_HEADER_SIZE;
+    for (uint64_t i = 0; i < count; i++) {
+        offsets[i] = offset;
+        offset += RECORD_GAME_HEADER_SIZE + (size_t) (data[offset + 4] | (data[offset + 5] << 8));
+    }
+
+    file->count = count;
+    file->offsets = offsets;
+    file->map = map;
+    file->map_size = size;
+    return true;
+}
+
+/**
+ * Releases a record file loaded by loadRecords().
+ *
+ * @param file The record file.
+ */
+void freeRecords(RecordFile *file) {
+    if (file->map != NULL) {
+        munmap(file->map, file->map_size);
+    }
+    free(file->offsets);
+    memset(file, 0, sizeof(RecordFile));
+}
+
+/**
+ * Gets a game of a record file, without copying its moves.
+ *
+ * @param file The record file.
+ * @param index The index of the game, from 0 in the order they were written.
+ * @param game Receives the game, valid until the file is freed.
+ * @return True if the game exists, false otherwise.
+ */
+bool recordGameAt(const RecordFile *file, uint64_t index, RecordGame *game) {
+    if (index >= file->count) {
+        return false;
+    }
+    return readGameHeader((const uint8_t *) file->map, file->offsets[index], game);
+}
+
+/**
+ * Plays a move on a board without checking it: every row from the move's row down is cut at its column.
+ * The move must have been checked by replayInit().
+ *
+ * @param board The board.
+ * @param cell The cell index of the move (row * cols + col).
+ */
+void recordApplyMove(SizedBoard *board, int cell) {
+    int row = cell / board->cols;
+    int col = cell % board->cols;
+    for (int i = row; i < board->rows && board->lengths[i] > col; i++) {
+        board->lengths[i] = (uint8_t) col;
+    }
+}
+
+/**
+ * Checks every move of a game once and keeps its board every RECORD_SNAPSHOT_INTERVAL plies,
+ * so that replaySeek() can reach any ply without checking the moves again.
+ *
+ * @param replay Receives the replay.
+ * @param game The game.
+ * @return True if the game is valid, false if a move eats a square that is gone (or follows A1).
+ */
+bool replayInit(RecordReplay *replay, const RecordGame *game) {
+    SizedBoard board;
+    if (!sizedBoardInit(&board, game->rows, game->cols)) {
+        return false;
+    }
+
+    for (int ply = 0; ply <= game->num_moves; ply++) {
+        if (ply % RECORD_SNAPSHOT_INTERVAL == 0) {
+            replay->snapshots[ply / RECORD_SNAPSHOT_INTERVAL] = board;
+        }
+        if (ply == game->num_moves) {
+            break;
+        }
+        int row = game->moves[ply] / game->cols;
+        int col = game->moves[ply] % game->cols;
+        if (row >= game->rows || col >= board.lengths[row]) {
+            return false;
+        }
+        recordApplyMove(&board, game->moves[ply]);
+    }
+
+    replay->game = *game;
+    replay->num_snapshots = game->num_moves / RECORD_SNAPSHOT_INTERVAL + 1;
+    return true;
+}
+
+/**
+ * Gets the board of a replayed game after a number of moves, from the closest snapshot before it.
+ *
+ * @param replay The replay.
+ * @param ply The number of moves played, from 0 (the full board) to the length of the game.
+ * @param board Receives the board.
+ * @return True if the game has that many moves, false otherwise.
+ */
+bool replaySeek(const RecordReplay *replay, int ply, SizedBoard *board) {
+    if (ply < 0 || ply > replay->game.num_moves) {
+        return false;
+    }
+    *board = replay->snapshots[ply / RECORD_SNAPSHOT_INTERVAL];
+    for (int i = ply - ply % RECORD_SNAPSHOT_INTERVAL; i < ply; i++) {
+        recordApplyMove(board, replay->game.moves[i]);
+    }
+    return true;
+}
+
+/**
+ * Counts the positions of a range of games of a record file: each position of a valid ROWS x COLS game
+ * adds one to the entry of its staircase rank, and to its wins or losses for the player to move.
+ * Games on other boards are skipped.
+ *
+ * @param file The record file.
+ * @param first The index of the first game.
+ * @param end The index after the last game.
+ * @param counts One entry per staircase rank, staircaseCount() of them, updated.
+ * @param positions Incremented for each position counted.
+ * @return The number of games counted.
+ */
+uint32_t recordCountPositions(const RecordFile *file, uint64_t first, uint64_t end, PositionEntry *counts,
+                              uint64_t *positions) {
+    uint32_t games = 0;
+    RecordGame game;
+    RecordReplay replay;
+    SizedBoard board;
+
+    for (uint64_t i = first; i < end; i++) {
+        recordGameAt(file, i, &game);
+        if (game.rows != ROWS || game.cols != COLS || !replayInit(&replay, &game)) {
+            continue;
+        }
+        board = replay.snapshots[0];
+        for (int ply = 0; ply < game.num_moves; ply++) {
+            PositionEntry *entry = &counts[staircaseRank(sizedBoardToStaircase(&board))];
+            entry->count++;
+            if (game.loser != RECORD_UNFINISHED) {
+                entry->wins += game.loser != ply % 2;
+                entry->losses += game.loser == ply % 2;
+            }
+            recordApplyMove(&board, game.moves[ply]);
+        }
+        *positions += (uint64_t) game.num_moves;
+        games++;
+    }
+    return games;
+}
+
+/**
+ * Counts the games of one slice of every record file, in the counts of its task.
+ *
+ * @param arg A pointer to the CountTask.
+ */
+static void countSlice(void *arg) {
+    CountTask *task = (CountTask *) arg;
+    for (int i = 0; i < task->num_files; i++) {
+        uint64_t first = task->files[i].count * (uint64_t) task->slice / (uint64_t) task->num_slices;
+        uint64_t end = task->files[i].count * (uint64_t) (task->slice + 1) / (uint64_t) task->num_slices;
+        task->games += recordCountPositions(&task->files[i], first, end, task->counts, &task->positions);
+    }
+}
+
+/**
+ * Counts the positions of every game of several record files on several threads. Each thread replays
+ * a slice of the games into counts of its own, one entry per staircase rank, and the counts are summed
+ * at the end: the memory used does not depend on the number of games. Falls back to the calling thread
+ * if the threads cannot be started.
+ *
+ * @param files The record files.
+ * @param num_files The number of record files.
+ * @param num_threads The number of threads.
+ * @param counts One entry per staircase rank, staircaseCount() of them, updated.
+ * @param games Incremented by the number of games counted.
+ * @param positions Incremented by the number of positions counted.
+ * @return True on success, false if the memory could not be allocated.
+ */
+bool recordIndexPositions(const RecordFile *files, int num_files, int num_threads, PositionEntry *counts,
+                          uint32_t *games, uint64_t *positions) {
+    uint32_t ranks = staircaseCount();
+    int slices = num_threads > 1 ? num_threads : 1;
+    PositionEntry *slice_counts = calloc((size_t) slices * ranks, sizeof(PositionEntry));
+    if (slice_counts == NULL) {
+        return false;
+    }
+
+    CountTask tasks[slices];
+    for (int i = 0; i < slices; i++) {
+        tasks[i] = (CountTask) {files, num_files, i, slices, slice_counts + (size_t) i * ranks, 0, 0};
+    }
+    ThreadPool pool;
+    if (slices > 1 && threadPoolInit(&pool, slices, slices)) {
+        for (int i = 0; i < slices; i++) {
+            threadPoolSubmit(&pool, countSlice, &tasks[i]);
+        }
+        threadPoolWait(&pool);
+        threadPoolDestroy(&pool);
+    } else {
+        for (int i = 0; i < slices; i++) {
+            countSlice(&tasks[i]);
+        }
+    }
+
+    for (int i = 0; i < slices; i++) {
+        for (uint32_t r = 0; r < ranks; r++) {
+            counts[r].count += tasks[i].counts[r].count;
+            counts[r].wins += tasks[i].counts[r].wins;
+            counts[r].losses += tasks[i].counts[r].losses;
+        }
+        *games += tasks[i].games;
+        *positions += tasks[i].positions;
+    }
+    free(slice_counts);
+    return true;
+}
@@ -36,7 +36,7 @@ gboolean resetButtonName(gpointer data) {
  *
  * This function iterates through the game board and destroys squares starting from
  * the selected row and column. Squares are marked as "Destroyed" and the corresponding
- * button label is updated to "X".
+ * button label is updated to "X". The move is added to the game record.
  *
  * @param game Pointer to the game data structure.
  * @param row The row of the starting square.
@@ -44,6 +44,7 @@ gboolean resetButtonName(gpointer data) {
  */
 void destroySquaresGUI(GameData *game, int row, int col) {
     if (game->board[row][col] == 1) {
+        recordMove(row, col);
         for (int i = 0; i < ROWS; i++) {
             for (int j = 0; j < COLS; j++) {
                 GtkWidget *button = game->buttons[i][j];
@@ -128,7 +129,6 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
     GameData *game = (GameData *) data;
 
     int row, col;
-    char buffer[1024] = {0}; // Buffer for transferring data between client and server
 
     GtkWidget *main_window = gtk_widget_get_ancestor(widget, GTK_TYPE_WINDOW);
 
@@ -202,16 +202,10 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
             } else {
                 // Destroy the squares selected
                 destroySquaresGUI(game, row, col);
-
-                // Convert column and row into valid move format for the client
-                buffer[0] = col + 'A'; // Convert 0 -> 'A', 1 -> 'B', ..., 8 -> 'I'
-                buffer[1] = row + '1'; // Convert 0 -> '1', 1 -> '2', ..., 6 -> '7'
-                g_print("Move selected: %c%c\n\n", buffer[0], buffer[1]);
+                g_print("Move selected: %c%d\n\n", 'A' + col, row + 1);
 
                 // Send the move to the server
-                send(game->sock, buffer, strlen(buffer), 0);
-                memset(buffer, 0, sizeof(buffer));
-
+                channelSendMove(game->channel, row, col);
 
                 // Change the player to Player 2
                 game->player = 2;
@@ -219,20 +213,11 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
                 // Update the window title to reflect the current player
                 updatePlayerLabel(game->player_label, game->player, false);
                 gtk_widget_set_name(button, "False");
-                // Wait for Player 2's move (server response)
-                printf("waiting for server' move");
-                read(game->sock, buffer, 1024); // Read the move from the server
-
-                // Translate the received move to row and col
-                col = buffer[0] - 'A';
-                row = buffer[1] - '1';
-
-
-
-                printf("Received move from server: %c%c\n\n", buffer[0], buffer[1]);
 
-                // Destroy the squares based on the server's move if A1 not destroyed
-                if (game->board[0][0] != 0) {
+                // Wait for Player 2's move (server response) and destroy its squares if A1 not destroyed
+                printf("waiting for server' move");
+                if (game->board[0][0] != 0 && receiveMoveGUI(game, &row, &col)) {
+                    printf("Received move from server: %c%d\n\n", 'A' + col, row + 1);
                     destroySquaresGUI(game, row, col);
                 }
 
@@ -252,7 +237,7 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
             g_print("Player %d lost!\n", game->player);
             showWinnerPopup(widget, game->player, main_window);
             // Close the socket at the end of the game
-            close(game->sock);
+            close(game->channel->fd);
             g_main_loop_quit(game->loop);
         }
 
@@ -277,16 +262,10 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
                 } else {
                     // Destroy the squares selected
                     destroySquaresGUI(game, row, col);
-
-                    // Convert column and row into valid move format for the client
-                    buffer[0] = col + 'A'; // Convert 0 -> 'A', 1 -> 'B', ..., 8 -> 'I'
-                    buffer[1] = row + '1'; // Convert 0 -> '1', 1 -> '2', ..., 6 -> '7'
-                    g_print("Move selected: %c%c\n\n", buffer[0], buffer[1]);
+                    g_print("Move selected: %c%d\n\n", 'A' + col, row + 1);
 
                     // Send the move to the client
-                    send(game->new_socket, buffer, strlen(buffer), 0);
-                    memset(buffer, 0, sizeof(buffer));
-
+                    channelSendMove(game->channel, row, col);
 
                     // Change the player to Player 1
                     game->player = 1;
@@ -294,17 +273,10 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
                     // Update the window title to reflect the current player
                     updatePlayerLabel(game->player_label, game->player, false);
                     gtk_widget_set_name(button, "False");
-                    // Wait for Player 1's move (client response)
-                    read(game->new_socket, buffer, 1024); // Read the move from the client
 
-                    // Translate the received move to row and col
-                    col = buffer[0] - 'A';
-                    row = buffer[1] - '1';
-
-                    printf("Received move from client: %c%c\n\n", buffer[0], buffer[1]);
-
-                    // Destroy the squares based on the client's move if A1 not destroyed
-                    if (game->board[0][0] != 0) {
+                    // Wait for Player 1's move (client response) and destroy its squares if A1 not destroyed
+                    if (game->board[0][0] != 0 && receiveMoveGUI(game, &row, &col)) {
+                        printf("Received move from client: %c%d\n\n", 'A' + col, row + 1);
                         destroySquaresGUI(game, row, col);
                     }
 
@@ -323,17 +295,12 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
             game->first_turn_done = true;
             g_print("we read the client's move");
             // Wait for Player 1's move (client response)
-            read(game->new_socket, buffer, 1024); // Read the move from the client
-
-            // Translate the received move to row and col
-            col = buffer[0] - 'A';
-            row = buffer[1] - '1';
+            if (receiveMoveGUI(game, &row, &col)) {
+                printf("Received move from client: %c%d\n\n", 'A' + col, row + 1);
 
-            printf("Received move from client: %c%c\n\n", buffer[0], buffer[1]);
-
-            // Destroy the squares based on the client's move
-            destroySquaresGUI(game, row, col);
-            memset(buffer, 0, sizeof(buffer));
+                // Destroy the squares based on the client's move
+                destroySquaresGUI(game, row, col);
+            }
 
         }
         
@@ -343,7 +310,7 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
             g_print("Player %d lost!\n", game->player);
             showWinnerPopup(widget, game->player, main_window);
             // Close the socket at the end of the game
-            close(game->new_socket);
+            close(game->channel->fd);
             g_main_loop_quit(game->loop);
         }
 
@@ -353,20 +320,84 @@ void onButtonClicked(GtkWidget *widget, gpointer data) {
 }
 
 /**
- * @brief AI performs its move.
+ * @brief Waits for the opponent's move in a network game.
  *
- * This function allows the AI to choose a move, destroy squares on the board, and
- * update the game state accordingly. It also checks for win conditions after the move.
+ * The move is checked with bitboardIsLegalMove() and acked; the ack leaves with the player's next move.
+ * An illegal move loses the game for the opponent, who is told so. If the opponent resigned or
+ * disconnected, or the server ended the game, the reason is printed and no move is returned.
+ *
+ * @param game Pointer to the game data structure.
+ * @param row Set to the row of the opponent's move.
+ * @param col Set to the column of the opponent's move.
+ * @return true if a valid move was received, false otherwise.
+ */
+bool receiveMoveGUI(GameData *game, int *row, int *col) {
+    Message msg;
+    int type = channelReceiveMove(game->channel, row, col, &msg);
+
+    if (type == MSG_MOVE && bitboardIsLegalMove(boardToBitboard(game->board), *row, *col)) {
+        channelAck(game->channel, msg.seq);
+        return true;
+    }
+    if (type == MSG_MOVE) {
+        // The GUI moves second in the server's role, so the opponent holds the other seat
+        int loser = game->serverMode ? 0 : 1;
+        channelSendGameOver(game->channel, loser, OVER_ILLEGAL_MOVE);
+        recordEndGame(loser);
+        g_print("The opponent played an invalid move. You win!\n");
+    } else if (type == MSG_GAME_OVER) {
+        g_print("Game over: %s.\n", protocolReasonName(msg.over.reason));
+    } else if (type == MSG_RESIGN) {
+        g_print("The opponent resigned.\n");
+    } else {
+        g_print("The opponent closed the connection.\n");
+    }
+    return false;
+}
+
+/**
+ * @brief AI starts choosing its move.
+ *
+ * This function hands the board to the AI service, which searches on its own thread so the
+ * window keeps responding; onAiMoveReady() plays the move once the search is done.
  *
  * @param data Pointer to the game data structure.
  * @return gboolean Returns FALSE to stop further calls.
  */
 gboolean aiPlayMove(gpointer data) {
     GameData *game = (GameData *) data;
-    int row, col;
 
     printf("AI is choosing a move...\n");
-    aiChooseMove(game->board, &row, &col);
+    if (!aiServiceSubmit(&game->ai_service, boardToBitboard(game->board), aiTimeBudget(), game)) {
+        printf("AI is already choosing a move.\n");
+    }
+    return FALSE;
+}
+
+/**
+ * @brief AI performs its move.
+ *
+ * Called by the GTK main loop when the AI service has a result: this function destroys the
+ * squares of the AI's move and updates the game state accordingly. It also checks for win
+ * conditions after the move.
+ *
+ * @param fd The eventfd of the AI service.
+ * @param condition Condition flags of the eventfd.
+ * @param data Pointer to the game data structure.
+ * @return gboolean Returns G_SOURCE_CONTINUE to keep watching the AI service.
+ */
+gboolean onAiMoveReady(gint fd, GIOCondition condition, gpointer data) {
+    (void) fd;
+    (void) condition;
+    GameData *game = (GameData *) data;
+    AiResult result;
+
+    if (aiServiceCollect(&game->ai_service, &result, 1) == 0) {
+        return G_SOURCE_CONTINUE;
+    }
+    int row = result.row;
+    int col = result.col;
+    aiReportStats(&result.stats);
 
     if (row != -1 && col != -1) {
         destroySquaresGUI(game, row, col);
@@ -381,7 +412,7 @@ gboolean aiPlayMove(gpointer data) {
         g_main_loop_quit(game->loop);
     }
 
-    return FALSE;
+    return G_SOURCE_CONTINUE;
 }
 
 /**
@@ -523,14 +554,13 @@ void activate(GtkApplication *app, gpointer user_data) {
  * @param ai Boolean flag indicating if the AI mode is enabled.
  * @param serverMode Boolean flag indicating if the game is running in server mode.
  * @param clientMode Boolean flag indicating if the game is running in client mode.
- * @param sock The socket used for client-server communication.
- * @param new_socket The new socket used by the server for communication.
+ * @param channel The connection to the opponent, which already said hello, or NULL in a local game.
  * @return int The exit status of the application.
  */
-int mainGui(bool ai, bool serverMode, bool clientMode, int sock, int new_socket) {
+int mainGui(bool ai, bool serverMode, bool clientMode, Channel *channel) {
     GtkApplication *app;
     GameData game = {0};
-    printf("value of sock when entering gui = %d \n", sock);
+    printf("value of sock when entering gui = %d \n", channel != NULL ? channel->fd : 0);
     printf("clientMode is: %s after mainGui\n", clientMode ? "true" : "false");
     printf("serverMode is: %s after mainGui\n", serverMode ? "true" : "false");
 
@@ -551,8 +581,16 @@ int mainGui(bool ai, bool serverMode, bool clientMode, int sock, int new_socket)
     game.ai = ai;
     game.clientMode = clientMode;
     game.serverMode = serverMode;
-    game.sock = sock;
-    game.new_socket = new_socket;
+    game.channel = channel;
+
+    // The AI searches on its own thread and wakes the main loop when its move is ready
+    if (ai) {
+        if (!aiServiceInit(&game.ai_service, 1, 1, aiHashBits())) {
+            printf("Could not start the AI service.\n");
+            return 1;
+        }
+        g_unix_fd_add(aiServiceFd(&game.ai_service), G_IO_IN, onAiMoveReady, &game);
+    }
 
     app = gtk_application_new("org.example.gtk4", G_APPLICATION_FLAGS_NONE);
     g_signal_connect(app, "activate", G_CALLBACK(activate), &game);
@@ -562,6 +600,9 @@ int mainGui(bool ai, bool serverMode, bool clientMode, int sock, int new_socket)
     int status = g_application_run(G_APPLICATION(app), 0, 0);
     g_object_unref(app);
     g_main_loop_unref(game.loop);
+    if (ai) {
+        aiServiceDestroy(&game.ai_service);
+    }
 
     return status;
 }
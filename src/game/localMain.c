@@ -3,54 +3,71 @@
 /**
  * Manages the main game loop for a local game session.
  * Depending on the flags, it either launches a GUI or runs the game in the console.
+ * The GUI shows ROWS x COLS boards only; other sizes are played in the console.
  *
  * @param ai A boolean indicating whether the AI is playing (true) or not (false).
  * @param gui A boolean indicating whether to launch the GUI (true) or use the console (false).
+ * @param rows The number of rows of the board, up to BOARD_MAX_ROWS.
+ * @param cols The number of columns of the board, up to BOARD_MAX_COLS.
  */
-void localMain(bool ai, bool gui) {
-    int board[ROWS][COLS];
+void localMain(bool ai, bool gui, int rows, int cols) {
+    SizedBoard board;
     int row, col;
     char col_char;
     int player = 1;
 
-    if (gui) {
+    if (!sizedBoardInit(&board, rows, cols)) {
+        printf("Invalid board size %dx%d.\n", rows, cols);
+        return;
+    }
+    recordStartGame(rows, cols);
+
+    if (gui && sizedBoardIsDefault(&board)) {
         printf("Launching GUI...\n");
-        mainGui(ai, false, false, 0, 0);
+        mainGui(ai, false, false, NULL);
     } else {
-        initBoard(board);
+        if (gui) {
+            printf("The GUI only shows %dx%d boards, playing in the console.\n", ROWS, COLS);
+        }
 
         while (1) {
-            displayBoard(board);
+            sizedBoardDisplay(&board);
 
             if (!ai || player == 1) {
                 printf("Player %d's turn, choose a square to destroy (e.g., B3): \n", player);
-                scanf(" %c%d", &col_char, &row);
+                if (scanf(" %c%d", &col_char, &row) != 2) {
+                    return;
+                }
 
                 // Convert the input into a row and column
                 col = toupper(col_char) - 'A'; // Convert 'A' -> 0, 'B' -> 1, etc.
                 row -= 1; // Adjust the row index to start from 0
 
-                if (!canDestroy(board, row, col)) {
+                if (!sizedBoardCanDestroy(&board, row, col)) {
                     printf("Invalid move, try again.\n");
                     continue;
                 }
 
-                if (!destroySquaresConsole(board, row, col, false)) {
+                if (!sizedBoardDestroySquares(&board, row, col)) {
+                    printf("You are trying to destroy too many squares! You can only destroy up to %d squares.\n",
+                           MOVE_LIMIT);
                     continue;
                 }
+                recordMove(row, col);
+                showPreviousMoveConsole(row, col);
             } else {
                 printf("AI is choosing a move...\n");
 
-                aiChooseMove(board, &row, &col);
+                sizedBoardChooseMove(&board, &row, &col);
 
                 if (row != -1 && col != -1) {
-                    executeMove(board, row, col);
-                } else {
-                    printf("AI could not find a valid move.\n");
+                    sizedBoardDestroySquares(&board, row, col);
+                    recordMove(row, col);
+                    printf("Move executed at %c%d.\n", col + 'A', row + 1);
                 }
             }
 
-            if (evaluateBoard(board) == 0) {
+            if (sizedBoardSquares(&board) == 0) {
                 printf("Player %d has lost!\n", player);
                 break;
             }
@@ -0,0 +1,100 @@
+#include "../../includes/moveGen.h"
+
+/**
+ * Sets up a move generator on a staircase-shaped position.
+ *
+ * @param gen The generator to initialize.
+ * @param board The bitboard of the position.
+ */
+void moveGenInit(MoveGen *gen, Bitboard board) {
+    gen->board = board;
+    for (int i = 0; i < ROWS; i++) {
+        gen->lengths[i] = (uint8_t) bitboardRowLength(board, i);
+    }
+    gen->legal = 0;
+    for (int i = 0; i < ROWS && gen->lengths[i] > 0; i++) {
+        gen->legal |= bitboardRowMoves(gen->lengths, i);
+    }
+}
+
+/**
+ * Plays a legal move in place. A move at (row, col) only shortens the rows from 'row' down to the first
+ * row already shorter than 'col', and the legal moves of a row only depend on that row and the rows below
+ * it, so only the rows above the last shortened one are generated again: O(rows) per move.
+ *
+ * @param gen The generator.
+ * @param cell The cell index of the move, which must be in gen->legal.
+ * @param undo Receives what moveGenUnmake() needs to take the move back.
+ */
+void moveGenMake(MoveGen *gen, int cell, MoveUndo *undo) {
+    int row = cell / COLS;
+    int col = cell % COLS;
+    int end = row;
+    while (end < ROWS && gen->lengths[end] > col) {
+        gen->lengths[end++] = (uint8_t) col;
+    }
+
+    undo->removed = gen->board & bitboardQuadrant(row, col);
+    undo->legal = gen->legal;
+    undo->row = (uint8_t) row;
+    undo->end = (uint8_t) end;
+    gen->board &= ~undo->removed;
+
+    // The legal moves of the rows below 'end' are unchanged, the others are read again from the frontier
+    Bitboard legal = gen->legal & ~((((Bitboard) 1) << BB_INDEX(end, 0)) - 1);
+    for (int i = 0; i < end && gen->lengths[i] > 0; i++) {
+        legal |= bitboardRowMoves(gen->lengths, i);
+    }
+    gen->legal = legal;
+}
+
+/**
+ * Takes back the last move played with moveGenMake().
+ *
+ * @param gen The generator.
+ * @param undo The record filled when the move was played.
+ */
+void moveGenUnmake(MoveGen *gen, const MoveUndo *undo) {
+    gen->board |= undo->removed;
+    gen->legal = undo->legal;
+    for (int i = undo->row; i < undo->end; i++) {
+        gen->lengths[i] = (uint8_t) bitboardRowLength(gen->board, i);
+    }
+}
+
+/**
+ * Sets up the board of a search on a staircase-shaped position, with an empty undo stack.
+ *
+ * @param pos The position to initialize.
+ * @param board The bitboard of the position.
+ * @param isMaximizing True if the maximizing player is to move, as in zobristHash().
+ */
+void positionInit(Position *pos, Bitboard board, bool isMaximizing) {
+    moveGenInit(&pos->gen, board);
+    pos->hash = zobristHash(board, isMaximizing);
+    pos->num_moves = 0;
+}
+
+/**
+ * Plays a legal move in place and pushes its undo record. The hash is updated by XORing the keys of
+ * the destroyed squares and of the side to move.
+ *
+ * @param pos The position.
+ * @param cell The cell index of the move, which must be in pos->gen.legal.
+ */
+void makeMove(Position *pos, int cell) {
+    MoveUndo *undo = &pos->undo[pos->num_moves++];
+    moveGenMake(&pos->gen, cell, undo);
+    pos->hash ^= zobristSquares(undo->removed) ^ zobristSide();
+}
+
+/**
+ * Takes back the last move played with makeMove().
+ *
+ * @param pos The position, with at least one move on its undo stack.
+ */
+void unmakeMove(Position *pos) {
+    const MoveUndo *undo = &pos->undo[--pos->num_moves];
+    pos->hash ^= zobristSquares(undo->removed) ^ zobristSide();
+    moveGenUnmake(&pos->gen, undo);
+}
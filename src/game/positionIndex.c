@@ -0,0 +1,156 @@
+#include "../../includes/positionIndex.h"
+
+/**
+ * Turns the counts of the positions met in the recorded games into the entries of a position index:
+ * the positions reached are moved to the front, in place, with their rank. Being counted by rank,
+ * they stay sorted by rank.
+ *
+ * @param counts One entry per staircase rank, staircaseCount() of them, see recordIndexPositions().
+ * @return The number of entries, the positions reached at least once.
+ */
+uint32_t buildPositionIndex(PositionEntry *counts) {
+    uint32_t ranks = staircaseCount();
+    uint32_t n = 0;
+    for (uint32_t r = 0; r < ranks; r++) {
+        if (counts[r].count > 0) {
+            counts[n] = counts[r];
+            counts[n].rank = r;
+            n++;
+        }
+    }
+    return n;
+}
+
+/**
+ * Writes a position index: a PositionIndexHeader followed by the entries, sorted by rank.
+ *
+ * @param entries The entries.
+ * @param count The number of entries.
+ * @param games The number of games indexed.
+ * @param path The path of the file to create.
+ * @return True on success, false otherwise.
+ */
+bool savePositionIndex(const PositionEntry *entries, uint32_t count, uint32_t games, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("fopen");
+        return false;
+    }
+
+    PositionIndexHeader header = {0};
+    memcpy(header.magic, POSITION_INDEX_MAGIC, sizeof(header.magic));
+    header.version = POSITION_INDEX_VERSION;
+    header.rows = ROWS;
+    header.cols = COLS;
+    header.count = count;
+    header.games = games;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(entries, sizeof(PositionEntry), count, file) == count;
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ * Maps a position index written by savePositionIndex() read-only, as loadBook() does for opening books.
+ *
+ * @param index The index to fill. Its entries point into the mapping until freePositionIndex() is called.
+ * @param path The path of the file to map.
+ * @return True on success, false if the file is missing, truncated or does not match this board.
+ */
+bool loadPositionIndex(PositionIndex *index, const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("open");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(PositionIndexHeader)) {
+        printf("%s is not a position index.\n", path);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    const PositionIndexHeader *header = (const PositionIndexHeader *) map;
+    const char *error = NULL;
+    if (memcmp(header->magic, POSITION_INDEX_MAGIC, sizeof(header->magic)) != 0) {
+        error = "is not a position index";
+    } else if (header->version != POSITION_INDEX_VERSION) {
+        error = "was written by another version of the indexer";
+    } else if (header->rows != ROWS || header->cols != COLS) {
+        error = "is not a position index for this board";
+    } else if ((size_t) st.st_size !=
+               sizeof(PositionIndexHeader) + (size_t) header->count * sizeof(PositionEntry)) {
+        error = "is truncated";
+    }
+    if (error != NULL) {
+        printf("%s %s.\n", path, error);
+        munmap(map, (size_t) st.st_size);
+        return false;
+    }
+
+    index->map = map;
+    index->map_size = (size_t) st.st_size;
+    index->count = header->count;
+    index->games = header->games;
+    index->entries = (const PositionEntry *) ((const uint8_t *) map + sizeof(PositionIndexHeader));
+    return true;
+}
+
+/**
+ * Unmaps a position index.
+ *
+ * @param index The index to release.
+ */
+void freePositionIndex(PositionIndex *index) {
+    if (index->map != NULL) {
+        munmap(index->map, index->map_size);
+    }
+    memset(index, 0, sizeof(PositionIndex));
+}
+
+/**
+ * Finds a position in the index, by binary search on the staircase rank.
+ *
+ * @param index The position index.
+ * @param board The bitboard of the position.
+ * @return The entry of the position, NULL if it was never reached (or no index is loaded).
+ */
+const PositionEntry *positionIndexLookup(const PositionIndex *index, Bitboard board) {
+    if (index->entries == NULL) {
+        return NULL;
+    }
+    uint32_t rank = staircaseRank(staircaseFromBitboard(board));
+    uint32_t low = 0, high = index->count;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (index->entries[mid].rank < rank) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < index->count && index->entries[low].rank == rank ? &index->entries[low] : NULL;
+}
+
+/**
+ * Estimates how often the player to move wins a position from the recorded games. One win and one loss
+ * are added to the counts, so that a position seen in few games stays close to an even chance.
+ *
+ * @param index The position index.
+ * @param board The bitboard of the position.
+ * @return The share of games won by the player to move, 0.5 for a position never reached.
+ */
+double positionIndexWinRate(const PositionIndex *index, Bitboard board) {
+    const PositionEntry *entry = positionIndexLookup(index, board);
+    if (entry == NULL) {
+        return 0.5;
+    }
+    return (entry->wins + 1.0) / (entry->wins + entry->losses + 2.0);
+}
@@ -0,0 +1,102 @@
+#include "../../includes/rng.h"
+
+/**
+ * Step of the splitmix64 generator, used to spread a seed over the state of a xoshiro256** generator.
+ *
+ * @param x The splitmix64 state, advanced by the call.
+ * @return The next splitmix64 output.
+ */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Rotates a 64-bit word to the left.
+ *
+ * @param x The word.
+ * @param k The number of bits, between 1 and 63.
+ * @return The rotated word.
+ */
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Seeds a generator. Any seed, 0 included, gives a valid state.
+ *
+ * @param rng The generator.
+ * @param seed The seed.
+ */
+void rngSeed(Rng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+/**
+ * Seeds one of several independent generators derived from the same seed, e.g. one per game of a
+ * tournament or per position of a batch. The stream number is hashed before being mixed into the seed,
+ * so neighbouring seeds and stream numbers do not give overlapping sequences.
+ *
+ * @param rng The generator.
+ * @param seed The seed shared by the streams.
+ * @param stream The number of the stream.
+ */
+void rngSeedStream(Rng *rng, uint64_t seed, uint64_t stream) {
+    rngSeed(rng, seed ^ splitmix64(&stream));
+}
+
+/**
+ * Draws the next 64 random bits of a xoshiro256** generator.
+ *
+ * @param rng The generator.
+ * @return The random bits.
+ */
+uint64_t rngNext(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+/**
+ * Draws a uniform integer below a bound, without the bias of a modulo (Lemire's multiply-and-reject).
+ *
+ * @param rng The generator.
+ * @param bound The number of possible values, at least 1.
+ * @return An integer between 0 and bound - 1.
+ */
+uint32_t rngBelow(Rng *rng, uint32_t bound) {
+    uint64_t m = (rngNext(rng) >> 32) * bound;
+    uint32_t low = (uint32_t) m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = (rngNext(rng) >> 32) * bound;
+            low = (uint32_t) m;
+        }
+    }
+    return (uint32_t) (m >> 32);
+}
+
+/**
+ * Picks a seed from the clock, for games that should differ from one run to the next.
+ * The seed is meant to be printed, so that the run can be replayed.
+ *
+ * @return A seed, different from one run to the next.
+ */
+uint64_t rngClockSeed(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint64_t x = ((uint64_t) now.tv_sec << 30) ^ (uint64_t) now.tv_nsec ^ ((uint64_t) getpid() << 48);
+    return splitmix64(&x);
+}
@@ -0,0 +1,467 @@
+#include "../../includes/sizedBoard.h"
+
+/**
+ * Initializes a full board of the given size.
+ *
+ * @param board The board to initialize.
+ * @param rows The number of rows, from 1 to BOARD_MAX_ROWS.
+ * @param cols The number of columns, from 1 to BOARD_MAX_COLS.
+ * @return True on success, false if the size is out of range (the board is left untouched).
+ */
+bool sizedBoardInit(SizedBoard *board, int rows, int cols) {
+    if (rows < 1 || rows > BOARD_MAX_ROWS || cols < 1 || cols > BOARD_MAX_COLS) {
+        return false;
+    }
+    memset(board, 0, sizeof(SizedBoard));
+    board->rows = rows;
+    board->cols = cols;
+    memset(board->lengths, cols, (size_t) rows);
+    return true;
+}
+
+/**
+ * Parses a board size written as "<rows>x<cols>" (e.g. "10x12").
+ *
+ * @param text The text to parse.
+ * @param rows Set to the number of rows.
+ * @param cols Set to the number of columns.
+ * @return True if the text is a size within BOARD_MAX_ROWS x BOARD_MAX_COLS, false otherwise.
+ */
+bool sizedBoardParseSize(const char *text, int *rows, int *cols) {
+    char end;
+    if (sscanf(text, "%dx%d%c", rows, cols, &end) != 2) {
+        return false;
+    }
+    return *rows >= 1 && *rows <= BOARD_MAX_ROWS && *cols >= 1 && *cols <= BOARD_MAX_COLS;
+}
+
+/**
+ * Checks if a board has the compile-time size ROWS x COLS, which the bitboard search handles.
+ *
+ * @param board The board to check.
+ * @return True for a ROWS x COLS board, false otherwise.
+ */
+bool sizedBoardIsDefault(const SizedBoard *board) {
+    return board->rows == ROWS && board->cols == COLS;
+}
+
+/**
+ * Converts a ROWS x COLS board to the staircase encoding used by the bitboard search and the solver.
+ *
+ * @param board The board, of the default size (see sizedBoardIsDefault()).
+ * @return The staircase of the board.
+ */
+StaircaseState sizedBoardToStaircase(const SizedBoard *board) {
+    StaircaseState state;
+    memcpy(state.lengths, board->lengths, ROWS);
+    return state;
+}
+
+/**
+ * Displays a board on the console, with column letters and row numbers.
+ *
+ * @param board The board to display.
+ */
+void sizedBoardDisplay(const SizedBoard *board) {
+    printf("   ");
+    for (int j = 0; j < board->cols; j++) {
+        printf(" %c", 'A' + j);
+    }
+    printf("\n");
+    for (int i = 0; i < board->rows; i++) {
+        printf("%2d ", i + 1);
+        for (int j = 0; j < board->cols; j++) {
+            printf(" %d", j < board->lengths[i] ? 1 : 0);
+        }
+        printf("\n");
+    }
+}
+
+/**
+ * Counts the squares still present on a board.
+ *
+ * @param board The board to inspect.
+ * @return The sum of the row lengths.
+ */
+int sizedBoardSquares(const SizedBoard *board) {
+    int count = 0;
+    for (int i = 0; i < board->rows; i++) {
+        count += board->lengths[i];
+    }
+    return count;
+}
+
+/**
+ * Checks if a square of a board can be destroyed, i.e. it is within bounds and still present.
+ *
+ * @param board The board to check.
+ * @param row The row index of the square.
+ * @param col The column index of the square.
+ * @return True if the square can be destroyed, false otherwise.
+ */
+bool sizedBoardCanDestroy(const SizedBoard *board, int row, int col) {
+    return row >= 0 && row < board->rows && col >= 0 && col < board->lengths[row];
+}
+
+/**
+ * Counts the squares that a move would destroy, from row lengths.
+ *
+ * @param lengths The row lengths of the position.
+ * @param rows The number of rows.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return The number of present squares below and to the right of the given square, itself included.
+ */
+static inline int countFromLengths(const uint8_t *lengths, int rows, int row, int col) {
+    int count = 0;
+    for (int i = row; i < rows && lengths[i] > col; i++) {
+        count += lengths[i] - col;
+    }
+    return count;
+}
+
+/**
+ * Counts the squares that a move at the given square would destroy.
+ *
+ * @param board The board to inspect.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return The number of present squares below and to the right of the given square, itself included.
+ */
+int sizedBoardCountSquares(const SizedBoard *board, int row, int col) {
+    return countFromLengths(board->lengths, board->rows, row, col);
+}
+
+/**
+ * Destroys the squares covered by a move, if the move stays within the limit of MOVE_LIMIT squares.
+ *
+ * @param board The board to update.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return True if the squares were destroyed, false if the move is off the board or exceeds the limit.
+ */
+bool sizedBoardDestroySquares(SizedBoard *board, int row, int col) {
+    if (!sizedBoardCanDestroy(board, row, col) || sizedBoardCountSquares(board, row, col) > MOVE_LIMIT) {
+        return false;
+    }
+    for (int i = row; i < board->rows && board->lengths[i] > col; i++) {
+        board->lengths[i] = (uint8_t) col;
+    }
+    return true;
+}
+
+/**
+ * Generates the legal moves of a board in row-major order, as staircaseLegalMoves() does for the default size.
+ *
+ * @param board The board of the position.
+ * @param moves Receives the row and column of every legal move (at most BOARD_MAX_ROWS * BOARD_MAX_COLS moves).
+ * @return The number of legal moves.
+ */
+int sizedBoardLegalMoves(const SizedBoard *board, int moves[][2]) {
+    int num_moves = 0;
+    for (int r = 0; r < board->rows && board->lengths[r] > 0; r++) {
+        int first = board->lengths[r];
+        while (first > 0 && sizedBoardCountSquares(board, r, first - 1) <= MOVE_LIMIT) {
+            first--;
+        }
+        for (int c = first; c < board->lengths[r]; c++) {
+            moves[num_moves][0] = r;
+            moves[num_moves][1] = c;
+            num_moves++;
+        }
+    }
+    return num_moves;
+}
+
+/**
+ * Evaluates a position for the player to move, as the "staircase" evaluator does on bitboards:
+ * an empty board is a win, L-shaped positions are solved exactly, and any other position gets a tempo bonus.
+ *
+ * @param lengths The row lengths of the position.
+ * @param rows The number of rows.
+ * @param ply The distance from the root of the search.
+ * @param terminal Set to true if the game is over.
+ * @return The score of the position for the player to move.
+ */
+static inline int evaluateLengths(const uint8_t *lengths, int rows, int ply, bool *terminal) {
+    *terminal = lengths[0] == 0;
+    if (*terminal) {
+        return EVAL_WIN - ply;
+    }
+    if (rows > 1 && lengths[1] > 1) {
+        return EVAL_TEMPO;
+    }
+    int row_arm = lengths[0] - 1;
+    int col_arm = 0;
+    while (col_arm + 1 < rows && lengths[col_arm + 1] > 0) {
+        col_arm++;
+    }
+    return (row_arm % (MOVE_LIMIT + 1) == col_arm % (MOVE_LIMIT + 1)) ? -EVAL_KNOWN : EVAL_KNOWN;
+}
+
+/**
+ * Searches a position with negamax and Alpha-Beta pruning over its row lengths, for any number of rows.
+ *
+ * @param lengths The row lengths of the position.
+ * @param rows The number of rows.
+ * @param depth The remaining depth.
+ * @param ply The distance from the root of the search.
+ * @param alpha The best score the player to move is already assured of.
+ * @param beta The best score the opponent is already assured of.
+ * @param nodes Incremented by the number of positions visited.
+ * @return The score for the player to move.
+ */
+static int negamaxLengths(const uint8_t *lengths, int rows, int depth, int ply, int alpha, int beta, uint64_t *nodes) {
+    (*nodes)++;
+    bool terminal;
+    int best = evaluateLengths(lengths, rows, ply, &terminal);
+    if (depth == 0 || terminal) {
+        return best;
+    }
+    best = -INF;
+    uint8_t child[BOARD_MAX_ROWS];
+    for (int r = 0; r < rows && lengths[r] > 0; r++) {
+        for (int c = lengths[r] - 1; c >= 0 && countFromLengths(lengths, rows, r, c) <= MOVE_LIMIT; c--) {
+            memcpy(child, lengths, (size_t) rows);
+            for (int i = r; i < rows && child[i] > c; i++) {
+                child[i] = (uint8_t) c;
+            }
+            int value = -negamaxLengths(child, rows, depth - 1, ply + 1, -beta, -alpha, nodes);
+            if (value > best) {
+                best = value;
+            }
+            if (best > alpha) {
+                alpha = best;
+            }
+            if (alpha >= beta) {
+                return best;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Returns the lanes of a packed board whose row is longer than a column. A lane holds at most
+ * BOARD_MAX_COLS, so adding 0x7F - col sets its high bit exactly when it exceeds col, without a carry
+ * into the next lane.
+ *
+ * @param packed The row lengths, one per byte (see packLengths()).
+ * @param col The column, below BOARD_MAX_COLS.
+ * @return 0xFF in the lanes of the rows longer than col, 0 in the others.
+ */
+static inline uint64_t lanesLongerThan(uint64_t packed, int col) {
+    uint64_t high = (packed + (uint64_t) (0x7F - col) * PACKED_LANES) & (PACKED_LANES << 7);
+    return (high >> 7) * 0xFF;
+}
+
+/**
+ * Packs the row lengths of a board of at most PACKED_MAX_ROWS rows into a word, row i in byte i.
+ *
+ * @param lengths The row lengths.
+ * @param rows The number of rows.
+ * @return The packed board.
+ */
+static inline uint64_t packLengths(const uint8_t *lengths, int rows) {
+    uint64_t packed = 0;
+    for (int i = 0; i < rows; i++) {
+        packed |= (uint64_t) lengths[i] << (8 * i);
+    }
+    return packed;
+}
+
+/**
+ * Evaluates a packed position as evaluateLengths() does.
+ *
+ * @param packed The row lengths, one per byte.
+ * @param ply The distance from the root of the search.
+ * @param terminal Set to true if the game is over.
+ * @return The score of the position for the player to move.
+ */
+static inline int evaluatePacked(uint64_t packed, int ply, bool *terminal) {
+    *terminal = (packed & 0xFF) == 0;
+    if (*terminal) {
+        return EVAL_WIN - ply;
+    }
+    if (((packed >> 8) & 0xFF) > 1) {
+        return EVAL_TEMPO;
+    }
+    int row_arm = (int) (packed & 0xFF) - 1;
+    int col_arm = __builtin_popcountll(lanesLongerThan(packed, 0)) / 8 - 1;
+    return (row_arm % (MOVE_LIMIT + 1) == col_arm % (MOVE_LIMIT + 1)) ? -EVAL_KNOWN : EVAL_KNOWN;
+}
+
+/**
+ * Searches a position of at most PACKED_MAX_ROWS rows as negamaxLengths() does, in the same move order
+ * and with the same result, on its row lengths packed into one word: a move is counted and played on
+ * all the rows at once, with no loop over the rows and no copy of the board.
+ *
+ * @param packed The row lengths, one per byte.
+ * @param depth The remaining depth.
+ * @param ply The distance from the root of the search.
+ * @param alpha The best score the player to move is already assured of.
+ * @param beta The best score the opponent is already assured of.
+ * @param nodes Incremented by the number of positions visited.
+ * @return The score for the player to move.
+ */
+static int negamaxPacked(uint64_t packed, int depth, int ply, int alpha, int beta, uint64_t *nodes) {
+    (*nodes)++;
+    bool terminal;
+    int best = evaluatePacked(packed, ply, &terminal);
+    if (depth == 0 || terminal) {
+        return best;
+    }
+    best = -INF;
+    for (int r = 0; r < PACKED_MAX_ROWS && ((packed >> (8 * r)) & 0xFF) > 0; r++) {
+        uint64_t from_row = ~(uint64_t) 0 << (8 * r);
+        for (int c = (int) ((packed >> (8 * r)) & 0xFF) - 1; c >= 0; c--) {
+            // The rows from r longer than c lose their squares from c, i.e. each lane drops to c
+            uint64_t covered = lanesLongerThan(packed, c) & from_row;
+            uint64_t cut = (uint64_t) c * PACKED_LANES & covered;
+            int count = (int) ((((packed & covered) - cut) * PACKED_LANES) >> 56);
+            if (count > MOVE_LIMIT) {
+                break;
+            }
+            int value = -negamaxPacked((packed & ~covered) | cut, depth - 1, ply + 1, -beta, -alpha, nodes);
+            if (value > best) {
+                best = value;
+            }
+            if (best > alpha) {
+                alpha = best;
+            }
+            if (alpha >= beta) {
+                return best;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Searches a position with the fastest search for its number of rows: packed into one word up to
+ * PACKED_MAX_ROWS rows, on its row lengths otherwise.
+ *
+ * @param lengths The row lengths of the position.
+ * @param rows The number of rows.
+ * @param depth The remaining depth.
+ * @param ply The distance from the root of the search.
+ * @param alpha The best score the player to move is already assured of.
+ * @param beta The best score the opponent is already assured of.
+ * @param nodes Incremented by the number of positions visited.
+ * @return The score for the player to move.
+ */
+static int negamaxBest(const uint8_t *lengths, int rows, int depth, int ply, int alpha, int beta, uint64_t *nodes) {
+    if (rows <= PACKED_MAX_ROWS) {
+        return negamaxPacked(packLengths(lengths, rows), depth, ply, alpha, beta, nodes);
+    }
+    return negamaxLengths(lengths, rows, depth, ply, alpha, beta, nodes);
+}
+
+/**
+ * Scores a position for the player to move, packed into one word if it has at most PACKED_MAX_ROWS rows.
+ *
+ * @param board The board of the position.
+ * @param depth The depth of the search.
+ * @param nodes Incremented by the number of positions visited.
+ * @return The score for the player to move.
+ */
+int sizedBoardNegamax(const SizedBoard *board, int depth, uint64_t *nodes) {
+    return negamaxBest(board->lengths, board->rows, depth, 0, -INF, INF, nodes);
+}
+
+/**
+ * Scores a position for the player to move on its row lengths, whatever its number of rows.
+ *
+ * @param board The board of the position.
+ * @param depth The depth of the search.
+ * @param nodes Incremented by the number of positions visited.
+ * @return The score for the player to move, the same as sizedBoardNegamax().
+ */
+int sizedBoardNegamaxGeneric(const SizedBoard *board, int depth, uint64_t *nodes) {
+    return negamaxLengths(board->lengths, board->rows, depth, 0, -INF, INF, nodes);
+}
+
+/**
+ * Chooses a move on a board of any size, without printing anything. A ROWS x COLS board takes the
+ * fast path, aiSearchMove() on its bitboard, unchanged. Other sizes are searched to the context's
+ * max_depth, packed into one word up to PACKED_MAX_ROWS rows (time budgets and the solution table only
+ * apply to the default size). A1 is only considered when it is the last legal move.
+ *
+ * @param ctx The search context, prepared with initSearchContext(); its nodes, source and score are set
+ *            (only nodes are counted on other sizes) and its generator (if set) makes the choice between
+ *            equal moves repeatable.
+ * @param board The board of the position.
+ * @param best_row Set to the row index of the move, -1 if there is no move.
+ * @param best_col Set to the column index of the move, -1 if there is no move.
+ * @return The depth of the search, 0 if the move was looked up or forced.
+ */
+int sizedBoardSearchMove(SearchContext *ctx, const SizedBoard *board, int *best_row, int *best_col) {
+    if (sizedBoardIsDefault(board)) {
+        return aiSearchMove(ctx, staircaseToBitboard(sizedBoardToStaircase(board)), best_row, best_col);
+    }
+
+    int moves[BOARD_MAX_ROWS * BOARD_MAX_COLS][2];
+    int num_moves = sizedBoardLegalMoves(board, moves);
+
+    *best_row = -1;
+    *best_col = -1;
+    if (num_moves > 1 && moves[0][0] == 0 && moves[0][1] == 0) {
+        moves[0][0] = moves[num_moves - 1][0];
+        moves[0][1] = moves[num_moves - 1][1];
+        num_moves--;
+    }
+    if (num_moves == 0) {
+        return 0;
+    }
+    if (num_moves == 1) {
+        *best_row = moves[0][0];
+        *best_col = moves[0][1];
+        ctx->source = "forced";
+        return 0;
+    }
+
+    ctx->source = "search";
+    shuffleMovesSeeded(moves, num_moves, ctx->rng);
+    int best = -INF;
+    for (int i = 0; i < num_moves; i++) {
+        SizedBoard child = *board;
+        sizedBoardDestroySquares(&child, moves[i][0], moves[i][1]);
+        int value = -negamaxBest(child.lengths, child.rows, ctx->max_depth - 1, 1, -INF, -best, &ctx->nodes);
+        if (value > best) {
+            best = value;
+            *best_row = moves[i][0];
+            *best_col = moves[i][1];
+        }
+    }
+    ctx->score = best;
+    return ctx->max_depth;
+}
+
+/**
+ * Chooses the AI's move on a board of any size for the console game. The default size goes through
+ * aiChooseMove(), with its time budget, threads and solution table.
+ *
+ * @param board The board of the position.
+ * @param best_row A pointer to an integer where the selected row index will be stored.
+ * @param best_col A pointer to an integer where the selected column index will be stored.
+ */
+void sizedBoardChooseMove(const SizedBoard *board, int *best_row, int *best_col) {
+    if (sizedBoardIsDefault(board)) {
+        int grid[ROWS][COLS];
+        staircaseToBoard(sizedBoardToStaircase(board), grid);
+        aiChooseMove(grid, best_row, best_col);
+        return;
+    }
+
+    SearchContext ctx;
+    SearchStats stats;
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    int depth = sizedBoardSearchMove(&ctx, board, best_row, best_col);
+    searchStatsFill(&ctx, depth, *best_row, *best_col, &stats);
+    aiReportStats(&stats);
+    if (*best_row == -1) {
+        printf("AI could not find a valid move.\n");
+        return;
+    }
+    printf("AI chooses move at %c%d\n", *best_col + 'A', *best_row + 1);
+}
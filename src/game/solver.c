@@ -0,0 +1,240 @@
+#include "../../includes/solver.h"
+
+/**
+ * Solves every staircase position of the board under the MOVE_LIMIT rule.
+ * Positions are processed by increasing staircase rank, so the result of every child is known when its parent
+ * is solved. A position wins if one of its moves leads to a lost position (the fastest such move is
+ * counted), otherwise it loses in as many moves as the slowest defence. The empty board is won by the
+ * player to move, since the opponent has just eaten A1.
+ *
+ * @param table The table to fill. Its results array is allocated by this function.
+ * @return True on success, false if the allocation failed.
+ */
+bool solveChomp(SolutionTable *table) {
+    table->count = staircaseCount();
+    table->map = NULL;
+    table->map_size = 0;
+    table->results = malloc(table->count);
+    if (table->results == NULL) {
+        return false;
+    }
+
+    table->results[0] = SOLUTION_WIN;
+    for (uint32_t rank = 1; rank < table->count; rank++) {
+        StaircaseState state = staircaseUnrank(rank);
+        int moves[ROWS * COLS][2];
+        int num_moves = staircaseLegalMoves(state, moves);
+
+        int best_win = -1;
+        int longest_loss = -1;
+        for (int i = 0; i < num_moves; i++) {
+            StaircaseState child = state;
+            staircaseDestroySquares(&child, moves[i][0], moves[i][1]);
+            uint8_t result = table->results[staircaseRank(child)];
+            int distance = (result & SOLUTION_DISTANCE) + 1;
+            if (!(result & SOLUTION_WIN)) {
+                if (best_win == -1 || distance < best_win) {
+                    best_win = distance;
+                }
+            } else if (distance > longest_loss) {
+                longest_loss = distance;
+            }
+        }
+
+        if (best_win != -1) {
+            table->results[rank] = SOLUTION_WIN | (uint8_t) best_win;
+        } else {
+            table->results[rank] = (uint8_t) longest_loss;
+        }
+    }
+    return true;
+}
+
+/**
+ * Writes a solution table to a binary file: a SolutionHeader, with the shape of the board, the move limit,
+ * the format version and the checksum of the results, followed by one byte per position.
+ *
+ * @param table The table to write.
+ * @param path The path of the file to create.
+ * @return True on success, false otherwise.
+ */
+bool saveSolution(const SolutionTable *table, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("fopen");
+        return false;
+    }
+
+    SolutionHeader header = {0};
+    memcpy(header.magic, SOLUTION_MAGIC, sizeof(header.magic));
+    header.rows = ROWS;
+    header.cols = COLS;
+    header.move_limit = MOVE_LIMIT;
+    header.version = SOLUTION_VERSION;
+    header.count = table->count;
+    header.checksum = solutionChecksum(table->results, table->count);
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(table->results, 1, table->count, file) == table->count;
+    fclose(file);
+    return ok;
+}
+
+/**
+ * Maps a solution table written by saveSolution() into memory, read-only and shared: processes loading the
+ * same file share one copy in the page cache. The file is rejected if it was solved for another board size
+ * or move limit, written by another version of the solver, or if its results do not match the checksum
+ * (the results are only a few pages, so they are all read once).
+ *
+ * @param table The table to fill. Its results point into the mapping until freeSolution() is called.
+ * @param path The path of the file to map.
+ * @return True on success, false if the file is missing, truncated or does not match this board.
+ */
+bool loadSolution(SolutionTable *table, const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("open");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(SolutionHeader)) {
+        printf("%s is not a solution table.\n", path);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    const SolutionHeader *header = (const SolutionHeader *) map;
+    const char *error = NULL;
+    if (memcmp(header->magic, SOLUTION_MAGIC, sizeof(header->magic)) != 0) {
+        error = "is not a solution table";
+    } else if (header->version != SOLUTION_VERSION) {
+        error = "was written by another version of the solver, solve the board again";
+    } else if (header->rows != ROWS || header->cols != COLS || header->move_limit != MOVE_LIMIT ||
+               header->count != staircaseCount()) {
+        error = "is not a solution table for this board";
+    } else if ((size_t) st.st_size != sizeof(SolutionHeader) + header->count) {
+        error = "is truncated";
+    } else if (solutionChecksum((const uint8_t *) map + sizeof(SolutionHeader), header->count) != header->checksum) {
+        error = "is corrupted (checksum mismatch)";
+    }
+    if (error != NULL) {
+        printf("%s %s.\n", path, error);
+        munmap(map, (size_t) st.st_size);
+        return false;
+    }
+
+    table->map = map;
+    table->map_size = (size_t) st.st_size;
+    table->count = header->count;
+    table->results = (uint8_t *) map + sizeof(SolutionHeader);
+    return true;
+}
+
+/**
+ * Computes the checksum stored in the header of a solution file (32-bit FNV-1a).
+ *
+ * @param results The result bytes.
+ * @param count The number of result bytes.
+ * @return The checksum.
+ */
+uint32_t solutionChecksum(const uint8_t *results, uint32_t count) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < count; i++) {
+        hash = (hash ^ results[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Checks the results of a loaded solution table against the checksum of its file, reading every page.
+ *
+ * @param table The table, loaded by loadSolution().
+ * @return True if the results match the checksum, false if they do not or the table was not loaded from a file.
+ */
+bool verifySolution(const SolutionTable *table) {
+    if (table->map == NULL) {
+        return false;
+    }
+    const SolutionHeader *header = (const SolutionHeader *) table->map;
+    return solutionChecksum(table->results, table->count) == header->checksum;
+}
+
+/**
+ * Releases a solution table: unmaps the file, or frees the results solved in memory.
+ *
+ * @param table The table to release.
+ */
+void freeSolution(SolutionTable *table) {
+    if (table->map != NULL) {
+        munmap(table->map, table->map_size);
+    } else {
+        free(table->results);
+    }
+    table->map = NULL;
+    table->map_size = 0;
+    table->results = NULL;
+    table->count = 0;
+}
+
+/**
+ * Looks up the perfect-play result of a position.
+ *
+ * @param table The solution table.
+ * @param board The bitboard of the position, which must be a staircase.
+ * @param win Receives true if the player to move wins.
+ * @param distance Receives the number of moves left with perfect play.
+ * @return True if the table is loaded, false otherwise.
+ */
+bool lookupSolution(const SolutionTable *table, Bitboard board, bool *win, int *distance) {
+    if (table->results == NULL) {
+        return false;
+    }
+    uint8_t result = table->results[staircaseRank(staircaseFromBitboard(board))];
+    *win = (result & SOLUTION_WIN) != 0;
+    *distance = result & SOLUTION_DISTANCE;
+    return true;
+}
+
+/**
+ * Chooses a perfect-play move: the fastest move to a lost position for the opponent,
+ * or the move that delays the defeat the longest when every move loses.
+ * Ties are broken in row-major order.
+ *
+ * @param table The solution table.
+ * @param board The bitboard of the position, which must be a non-empty staircase.
+ * @param best_row Receives the row index of the chosen move.
+ * @param best_col Receives the column index of the chosen move.
+ * @return True if a move was found, false if the table is not loaded or the board is empty.
+ */
+bool solutionBestMove(const SolutionTable *table, Bitboard board, int *best_row, int *best_col) {
+    if (table->results == NULL) {
+        return false;
+    }
+
+    int best_score = -1;
+    Bitboard moves = bitboardLegalMoves(board);
+    while (moves) {
+        int cell = __builtin_ctzll(moves);
+        moves &= moves - 1;
+
+        bool child_win;
+        int child_distance;
+        lookupSolution(table, board & ~bitboardQuadrant(cell / COLS, cell % COLS), &child_win, &child_distance);
+
+        // Winning moves score above every losing move, shorter wins and longer defeats first
+        int score = child_win ? child_distance : 2 * ROWS * COLS + 1 - child_distance;
+        if (score > best_score) {
+            best_score = score;
+            *best_row = cell / COLS;
+            *best_col = cell % COLS;
+        }
+    }
+    return best_score != -1;
+}
@@ -0,0 +1,231 @@
+#include "../../includes/staircase.h"
+
+/**
+ * Computes the binomial coefficient C(n, k).
+ *
+ * @param n The size of the set.
+ * @param k The size of the subsets.
+ * @return The number of subsets of size k, 0 if k is out of range.
+ */
+static uint32_t binomial(int n, int k) {
+    if (k < 0 || k > n) {
+        return 0;
+    }
+    uint64_t result = 1;
+    for (int i = 1; i <= k; i++) {
+        result = result * (n - k + i) / i;
+    }
+    return (uint32_t) result;
+}
+
+/**
+ * Returns the number of staircase positions of the board, i.e. the number of non-increasing
+ * sequences of ROWS row lengths between 0 and COLS: C(ROWS + COLS, ROWS).
+ *
+ * @return The number of distinct ranks.
+ */
+uint32_t staircaseCount(void) {
+    return binomial(ROWS + COLS, ROWS);
+}
+
+/**
+ * Encodes a board stored as a 2D array. Each row length is the number of squares present
+ * before the first destroyed square of the row.
+ *
+ * @param board A 2D array representing the game board with dimensions defined by ROWS and COLS constants.
+ * @return The staircase encoding of the board.
+ */
+StaircaseState staircaseFromBoard(int board[ROWS][COLS]) {
+    StaircaseState state;
+    for (int i = 0; i < ROWS; i++) {
+        int length = 0;
+        while (length < COLS && board[i][length] == 1) {
+            length++;
+        }
+        state.lengths[i] = (uint8_t) length;
+    }
+    return state;
+}
+
+/**
+ * Decodes a staircase into a board stored as a 2D array.
+ *
+ * @param state The staircase to decode.
+ * @param board A 2D array that receives 1 for every present square and 0 for every destroyed one.
+ */
+void staircaseToBoard(StaircaseState state, int board[ROWS][COLS]) {
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            board[i][j] = (j < state.lengths[i]) ? 1 : 0;
+        }
+    }
+}
+
+/**
+ * Encodes a bitboard, one population count per row.
+ *
+ * @param board The bitboard of the position, which must be a staircase.
+ * @return The staircase encoding of the bitboard.
+ */
+StaircaseState staircaseFromBitboard(Bitboard board) {
+    StaircaseState state;
+    for (int i = 0; i < ROWS; i++) {
+        state.lengths[i] = (uint8_t) bitboardRowLength(board, i);
+    }
+    return state;
+}
+
+/**
+ * Decodes a staircase into a bitboard.
+ *
+ * @param state The staircase to decode.
+ * @return The bitboard with the first lengths[i] squares of every row i set.
+ */
+Bitboard staircaseToBitboard(StaircaseState state) {
+    Bitboard board = 0;
+    for (int i = 0; i < ROWS; i++) {
+        board |= ((((Bitboard) 1) << state.lengths[i]) - 1) << BB_INDEX(i, 0);
+    }
+    return board;
+}
+
+/**
+ * Ranks a staircase in [0, staircaseCount()). The rank is a 2-byte key on the 7x9 board.
+ * Shrinking any row gives a strictly smaller rank, so every position reachable by a move
+ * has a smaller rank than the position itself.
+ *
+ * @param state The staircase to rank.
+ * @return The rank of the staircase.
+ */
+uint32_t staircaseRank(StaircaseState state) {
+    uint32_t rank = 0;
+    for (int i = 0; i < ROWS; i++) {
+        rank += binomial(ROWS - i - 1 + state.lengths[i], ROWS - i);
+    }
+    return rank;
+}
+
+/**
+ * Rebuilds the staircase with the given rank.
+ *
+ * @param rank The rank, in [0, staircaseCount()).
+ * @return The staircase whose rank is the given value.
+ */
+StaircaseState staircaseUnrank(uint32_t rank) {
+    StaircaseState state;
+    int max_length = COLS;
+    for (int i = 0; i < ROWS; i++) {
+        int length = max_length;
+        while (binomial(ROWS - i - 1 + length, ROWS - i) > rank) {
+            length--;
+        }
+        rank -= binomial(ROWS - i - 1 + length, ROWS - i);
+        state.lengths[i] = (uint8_t) length;
+        max_length = length;
+    }
+    return state;
+}
+
+/**
+ * Checks that a staircase describes a reachable position: lengths within the board and
+ * non-increasing from the top row.
+ *
+ * @param state The staircase to check.
+ * @return True if the staircase is valid, false otherwise.
+ */
+bool staircaseIsValid(StaircaseState state) {
+    int max_length = COLS;
+    for (int i = 0; i < ROWS; i++) {
+        if (state.lengths[i] > max_length) {
+            return false;
+        }
+        max_length = state.lengths[i];
+    }
+    return true;
+}
+
+/**
+ * Counts the squares still present in a staircase.
+ *
+ * @param state The staircase to count.
+ * @return The sum of the row lengths.
+ */
+int staircaseSquares(StaircaseState state) {
+    int count = 0;
+    for (int i = 0; i < ROWS; i++) {
+        count += state.lengths[i];
+    }
+    return count;
+}
+
+/**
+ * Checks if a square of a staircase can be destroyed, i.e. it is within bounds and still present.
+ *
+ * @param state The staircase to check.
+ * @param row The row index of the square.
+ * @param col The column index of the square.
+ * @return True if the square can be destroyed, false otherwise.
+ */
+bool staircaseCanDestroy(StaircaseState state, int row, int col) {
+    return row >= 0 && row < ROWS && col >= 0 && col < state.lengths[row];
+}
+
+/**
+ * Counts the squares that a move at the given square would destroy.
+ *
+ * @param state The staircase to inspect.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return The number of present squares below and to the right of the given square, itself included.
+ */
+int staircaseCountSquares(StaircaseState state, int row, int col) {
+    int count = 0;
+    for (int i = row; i < ROWS && state.lengths[i] > col; i++) {
+        count += state.lengths[i] - col;
+    }
+    return count;
+}
+
+/**
+ * Destroys the squares covered by a move, if the move stays within the limit of MOVE_LIMIT squares.
+ * Only the lengths of the rows from the move downwards change.
+ *
+ * @param state A pointer to the staircase to update.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return True if the squares were destroyed, false if the move exceeds the limit (the staircase is left untouched).
+ */
+bool staircaseDestroySquares(StaircaseState *state, int row, int col) {
+    if (staircaseCountSquares(*state, row, col) > MOVE_LIMIT) {
+        return false;
+    }
+    for (int i = row; i < ROWS && state->lengths[i] > col; i++) {
+        state->lengths[i] = (uint8_t) col;
+    }
+    return true;
+}
+
+/**
+ * Generates the legal moves of a staircase in row-major order, without building a board.
+ * On each row only the last squares can be legal, so every row is scanned from its end
+ * until the limit of MOVE_LIMIT squares is exceeded.
+ *
+ * @param state The staircase of the position.
+ * @param moves Receives the row and column of every legal move (at most ROWS * COLS moves).
+ * @return The number of legal moves.
+ */
+int staircaseLegalMoves(StaircaseState state, int moves[][2]) {
+    int num_moves = 0;
+    for (int r = 0; r < ROWS && state.lengths[r] > 0; r++) {
+        int first = state.lengths[r];
+        while (first > 0 && staircaseCountSquares(state, r, first - 1) <= MOVE_LIMIT) {
+            first--;
+        }
+        for (int c = first; c < state.lengths[r]; c++) {
+            moves[num_moves][0] = r;
+            moves[num_moves][1] = c;
+            num_moves++;
+        }
+    }
+    return num_moves;
+}
@@ -0,0 +1,134 @@
+#include "../../includes/threadPool.h"
+
+/**
+ * Main loop of a pool thread: takes the oldest pending task, runs it, and starts again
+ * until the pool shuts down and the queue is empty.
+ *
+ * @param arg A pointer to the ThreadPool the thread belongs to.
+ * @return Always NULL.
+ */
+static void *threadPoolWorker(void *arg) {
+    ThreadPool *pool = (ThreadPool *) arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (pool->count == 0 && !pool->shutdown) {
+            pthread_cond_wait(&pool->not_empty, &pool->lock);
+        }
+        if (pool->count == 0 && pool->shutdown) {
+            break;
+        }
+
+        PoolTask task = pool->queue[pool->head];
+        pool->head = (pool->head + 1) % pool->capacity;
+        pool->count--;
+        pool->active++;
+        pthread_cond_signal(&pool->not_full);
+        pthread_mutex_unlock(&pool->lock);
+
+        task.function(task.arg);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->active--;
+        if (pool->active == 0 && pool->count == 0) {
+            pthread_cond_broadcast(&pool->idle);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ * Starts a pool of worker threads sharing a bounded queue of tasks.
+ *
+ * @param pool The pool to initialize.
+ * @param num_threads The number of worker threads to start.
+ * @param capacity The maximum number of pending tasks; threadPoolSubmit() blocks when it is reached.
+ * @return True on success, false if the threads or the queue could not be created.
+ */
+bool threadPoolInit(ThreadPool *pool, int num_threads, int capacity) {
+    pool->threads = calloc(num_threads, sizeof(pthread_t));
+    pool->queue = calloc(capacity, sizeof(PoolTask));
+    if (pool->threads == NULL || pool->queue == NULL) {
+        free(pool->threads);
+        free(pool->queue);
+        return false;
+    }
+
+    pool->num_threads = 0;
+    pool->capacity = capacity;
+    pool->head = 0;
+    pool->count = 0;
+    pool->active = 0;
+    pool->shutdown = false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->not_empty, NULL);
+    pthread_cond_init(&pool->not_full, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    for (int i = 0; i < num_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, threadPoolWorker, pool) != 0) {
+            threadPoolDestroy(pool);
+            return false;
+        }
+        pool->num_threads++;
+    }
+    return true;
+}
+
+/**
+ * Queues a task, waiting for a free slot if the queue is full.
+ *
+ * @param pool The pool that runs the task.
+ * @param function The function to run on a worker thread.
+ * @param arg The argument passed to the function.
+ */
+void threadPoolSubmit(ThreadPool *pool, TaskFunction function, void *arg) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->count == pool->capacity) {
+        pthread_cond_wait(&pool->not_full, &pool->lock);
+    }
+    pool->queue[(pool->head + pool->count) % pool->capacity] = (PoolTask) {function, arg};
+    pool->count++;
+    pthread_cond_signal(&pool->not_empty);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Waits until every queued task has been run.
+ *
+ * @param pool The pool to wait for.
+ */
+void threadPoolWait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->count > 0 || pool->active > 0) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Runs the remaining tasks, stops the worker threads and releases the pool.
+ *
+ * @param pool The pool to destroy.
+ */
+void threadPoolDestroy(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->not_empty);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->not_empty);
+    pthread_cond_destroy(&pool->not_full);
+    pthread_cond_destroy(&pool->idle);
+    free(pool->threads);
+    free(pool->queue);
+    pool->threads = NULL;
+    pool->queue = NULL;
+    pool->num_threads = 0;
+}
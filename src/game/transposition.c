@@ -0,0 +1,269 @@
+#include "../../includes/transposition.h"
+
+#define ZOBRIST_SEED 0x43686f6d70ULL // "Chomp"
+
+/**
+ * Mixes a 64-bit value with the SplitMix64 finalizer.
+ * Used to derive the Zobrist keys, so they are the same in every run without storing a table.
+ *
+ * @param x The value to mix.
+ * @return A well-distributed 64-bit value.
+ */
+static uint64_t splitMix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Returns the Zobrist key of a square.
+ *
+ * @param cell The cell index of the square (row * COLS + col).
+ * @return The random key associated with the square.
+ */
+uint64_t zobristCell(int cell) {
+    return splitMix64(ZOBRIST_SEED + (uint64_t) cell);
+}
+
+/**
+ * Returns the Zobrist key toggled when the player to move changes.
+ *
+ * @return The random key associated with the maximizing player to move.
+ */
+uint64_t zobristSide(void) {
+    return splitMix64(ZOBRIST_SEED + ROWS * COLS);
+}
+
+/**
+ * Combines the Zobrist keys of a set of squares.
+ * Since removing squares is a XOR, the hash of a child is the parent hash XOR the keys of the destroyed squares.
+ *
+ * @param squares The bitboard of the squares to combine.
+ * @return The XOR of the keys of every square in the set.
+ */
+uint64_t zobristSquares(Bitboard squares) {
+    uint64_t key = 0;
+    while (squares) {
+        key ^= zobristCell(__builtin_ctzll(squares));
+        squares &= squares - 1;
+    }
+    return key;
+}
+
+/**
+ * Computes the full Zobrist hash of a position.
+ *
+ * @param board The bitboard of the position.
+ * @param isMaximizing True if the maximizing player is to move.
+ * @return The hash of the position.
+ */
+uint64_t zobristHash(Bitboard board, bool isMaximizing) {
+    uint64_t key = zobristSquares(board);
+    if (isMaximizing) {
+        key ^= zobristSide();
+    }
+    return key;
+}
+
+// Layout of the packed data word of a slot
+#define DATA_SCORE_SHIFT 0
+#define DATA_DEPTH_SHIFT 16
+#define DATA_MOVE_SHIFT 24
+#define DATA_BOUND_SHIFT 32
+#define DATA_GENERATION_SHIFT 40
+#define DATA_USED ((uint64_t) 1 << 48)
+
+/**
+ * Packs the fields of an entry into the data word of a slot.
+ *
+ * @param depth The remaining depth the position was searched to.
+ * @param bound Whether the score is exact, a lower bound or an upper bound.
+ * @param score The score returned by the search.
+ * @param best_move The cell index of the best move found, -1 if none.
+ * @param generation The current search of the table.
+ * @return The data word, never 0.
+ */
+static inline uint64_t ttPack(int depth, BoundType bound, int score, int best_move, unsigned int generation) {
+    return ((uint64_t) (uint16_t) score << DATA_SCORE_SHIFT) | ((uint64_t) (uint8_t) depth << DATA_DEPTH_SHIFT) |
+           ((uint64_t) (uint8_t) best_move << DATA_MOVE_SHIFT) | ((uint64_t) bound << DATA_BOUND_SHIFT) |
+           ((uint64_t) (uint8_t) generation << DATA_GENERATION_SHIFT) | DATA_USED;
+}
+
+/**
+ * Unpacks the data word of a slot.
+ *
+ * @param key The hash of the position.
+ * @param data The data word.
+ * @param entry Receives the fields of the entry.
+ */
+static inline void ttUnpack(uint64_t key, uint64_t data, TTEntry *entry) {
+    entry->key = key;
+    entry->score = (int16_t) (uint16_t) (data >> DATA_SCORE_SHIFT);
+    entry->depth = (int8_t) (uint8_t) (data >> DATA_DEPTH_SHIFT);
+    entry->best_move = (int8_t) (uint8_t) (data >> DATA_MOVE_SHIFT);
+    entry->bound = (uint8_t) ((data >> DATA_BOUND_SHIFT) & 3);
+    entry->generation = (uint8_t) (data >> DATA_GENERATION_SHIFT);
+    entry->used = (data & DATA_USED) != 0;
+}
+
+/**
+ * Returns the table size, in entries, fitting in a memory budget.
+ *
+ * @param size_mb The memory budget in MiB, from 1 to TT_MAX_SIZE_MB.
+ * @return The base-2 logarithm of the largest number of entries fitting in the budget.
+ */
+int ttBitsForSize(int size_mb) {
+    uint64_t entries = ((uint64_t) size_mb << 20) / sizeof(TTSlot);
+    int bits = 0;
+    while (((uint64_t) 2 << bits) <= entries) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * Allocates a transposition table with 2^size_bits entries, grouped in cache-line buckets, and empties it.
+ *
+ * @param table The table to initialize.
+ * @param size_bits The base-2 logarithm of the number of entries.
+ * @return True on success, false if the allocation failed.
+ */
+bool ttInit(TranspositionTable *table, int size_bits) {
+    uint64_t buckets = ((uint64_t) 1 << size_bits) / TT_BUCKET_SLOTS;
+    if (buckets == 0) {
+        buckets = 1;
+    }
+    size_t bytes = buckets * TT_BUCKET_SLOTS * sizeof(TTSlot);
+    table->slots = aligned_alloc(TT_BUCKET_SLOTS * sizeof(TTSlot), bytes);
+    if (table->slots == NULL) {
+        table->mask = 0;
+        return false;
+    }
+    table->mask = buckets - 1;
+    ttClear(table);
+    return true;
+}
+
+/**
+ * Releases the memory of a transposition table.
+ *
+ * @param table The table to release.
+ */
+void ttFree(TranspositionTable *table) {
+    free(table->slots);
+    table->slots = NULL;
+    table->mask = 0;
+}
+
+/**
+ * Empties a transposition table, keeping its memory.
+ * No other thread may use the table meanwhile.
+ *
+ * @param table The table to clear.
+ */
+void ttClear(TranspositionTable *table) {
+    if (table->slots == NULL) {
+        return;
+    }
+    memset(table->slots, 0, (table->mask + 1) * TT_BUCKET_SLOTS * sizeof(TTSlot));
+    atomic_store(&table->generation, 0);
+}
+
+/**
+ * Starts a new search, i.e. a new move: the entries stored by earlier searches stay valid, but age,
+ * so they are replaced before the entries of the current search.
+ *
+ * @param table The table.
+ */
+void ttNewSearch(TranspositionTable *table) {
+    atomic_fetch_add(&table->generation, 1);
+}
+
+/**
+ * Looks up a position in the transposition table.
+ * Safe to call while other threads probe and store.
+ *
+ * @param table The table to search.
+ * @param key The Zobrist hash of the position.
+ * @param entry Receives a copy of the entry when the position is found.
+ * @return True if the position was found, false otherwise.
+ */
+bool ttProbe(TranspositionTable *table, uint64_t key, TTEntry *entry) {
+    if (table->slots == NULL) {
+        return false;
+    }
+    TTSlot *bucket = &table->slots[(key & table->mask) * TT_BUCKET_SLOTS];
+    for (int i = 0; i < TT_BUCKET_SLOTS; i++) {
+        uint64_t data = atomic_load_explicit(&bucket[i].data, memory_order_relaxed);
+        uint64_t check = atomic_load_explicit(&bucket[i].check, memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key) {
+            ttUnpack(key, data, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Stores the result of a search in the transposition table. The position replaces its own entry if its
+ * bucket holds one, else an empty entry, else the entry with the lowest depth once aged by TT_AGE_WEIGHT
+ * per search since it was stored. Safe to call while other threads probe and store.
+ *
+ * @param table The table to update.
+ * @param key The Zobrist hash of the position.
+ * @param depth The remaining depth the position was searched to.
+ * @param bound Whether the score is exact, a lower bound or an upper bound.
+ * @param score The score returned by the search.
+ * @param best_move The cell index of the best move found, -1 if none.
+ */
+void ttStore(TranspositionTable *table, uint64_t key, int depth, BoundType bound, int score, int best_move) {
+    if (table->slots == NULL) {
+        return;
+    }
+    unsigned int generation = atomic_load_explicit(&table->generation, memory_order_relaxed);
+    TTSlot *bucket = &table->slots[(key & table->mask) * TT_BUCKET_SLOTS];
+    TTSlot *victim = NULL;
+    int victim_value = INT32_MAX;
+
+    for (int i = 0; i < TT_BUCKET_SLOTS; i++) {
+        uint64_t data = atomic_load_explicit(&bucket[i].data, memory_order_relaxed);
+        uint64_t check = atomic_load_explicit(&bucket[i].check, memory_order_relaxed);
+        if (data == 0 || (check ^ data) == key) {
+            victim = &bucket[i];
+            victim_value = INT32_MIN;
+            break;
+        }
+        int age = (uint8_t) (generation - (unsigned int) (data >> DATA_GENERATION_SHIFT));
+        int value = (int8_t) (uint8_t) (data >> DATA_DEPTH_SHIFT) - TT_AGE_WEIGHT * age;
+        if (value < victim_value) {
+            victim = &bucket[i];
+            victim_value = value;
+        }
+    }
+
+    uint64_t data = ttPack(depth, bound, score, best_move, generation);
+    atomic_store_explicit(&victim->data, data, memory_order_relaxed);
+    atomic_store_explicit(&victim->check, key ^ data, memory_order_relaxed);
+}
+
+/**
+ * Prints how full a transposition table is, to help choosing its size.
+ *
+ * @param table The table to report.
+ */
+void ttPrintStats(TranspositionTable *table) {
+    if (table->slots == NULL) {
+        printf("Transposition table: not allocated\n");
+        return;
+    }
+    uint64_t size = (table->mask + 1) * TT_BUCKET_SLOTS;
+    uint64_t used = 0;
+    for (uint64_t i = 0; i < size; i++) {
+        if (atomic_load_explicit(&table->slots[i].data, memory_order_relaxed) != 0) {
+            used++;
+        }
+    }
+    printf("Transposition table: %llu entries (%llu MiB), %llu used (%.1f%%)\n", (unsigned long long) size,
+           (unsigned long long) (size * sizeof(TTSlot) >> 20), (unsigned long long) used, 100.0 * used / size);
+}
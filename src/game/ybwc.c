@@ -0,0 +1,530 @@
+#include "../../includes/ybwc.h"
+
+static int ybwcNode(YbwcWorker *worker, Position *pos, int depth, int ply, bool isMaximizing, int alpha, int beta,
+                    SplitPoint *parent);
+
+/**
+ * Pushes a task on the bottom of a worker's own deque.
+ *
+ * @param worker The worker owning the deque.
+ * @param task The task to push.
+ */
+static void pushTask(YbwcWorker *worker, YbwcTask task) {
+    pthread_mutex_lock(&worker->lock);
+    worker->deque[worker->bottom % YBWC_DEQUE_SIZE] = task;
+    worker->bottom++;
+    pthread_mutex_unlock(&worker->lock);
+}
+
+/**
+ * Pops the newest task of a worker's own deque, i.e. the deepest and smallest piece of work.
+ *
+ * @param worker The worker owning the deque.
+ * @param task Receives the task.
+ * @return True if a task was popped, false if the deque is empty.
+ */
+static bool popTask(YbwcWorker *worker, YbwcTask *task) {
+    bool found = false;
+    pthread_mutex_lock(&worker->lock);
+    if (worker->bottom > worker->top) {
+        worker->bottom--;
+        *task = worker->deque[worker->bottom % YBWC_DEQUE_SIZE];
+        found = true;
+    }
+    if (worker->bottom == worker->top) {
+        worker->bottom = worker->top = 0;
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return found;
+}
+
+/**
+ * Steals the oldest task of another worker, i.e. the one closest to the root and the largest subtree.
+ * Victims are tried in turn starting from the thief's neighbour.
+ *
+ * @param thief The worker looking for work.
+ * @param task Receives the task.
+ * @return True if a task was stolen, false if every other deque is empty.
+ */
+static bool stealTask(YbwcWorker *thief, YbwcTask *task) {
+    YbwcSearch *search = thief->search;
+    for (int k = 1; k < search->num_workers; k++) {
+        YbwcWorker *victim = &search->workers[(thief->id + k) % search->num_workers];
+        pthread_mutex_lock(&victim->lock);
+        bool found = victim->bottom > victim->top;
+        if (found) {
+            *task = victim->deque[victim->top % YBWC_DEQUE_SIZE];
+            victim->top++;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (found) {
+            thief->steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Checks if the results of a subtree are no longer needed: the deadline passed, or a cutoff happened
+ * at one of the enclosing split points.
+ *
+ * @param search The parallel search.
+ * @param sp The innermost enclosing split point, NULL at the top of the search.
+ * @return True if the subtree must be abandoned, false otherwise.
+ */
+static bool isAborted(YbwcSearch *search, SplitPoint *sp) {
+    if (atomic_load_explicit(&search->stopped, memory_order_relaxed)) {
+        return true;
+    }
+    for (; sp != NULL; sp = sp->parent) {
+        if (atomic_load_explicit(&sp->cutoff, memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Searches one younger brother of a split point and merges its score into the split point.
+ *
+ * @param worker The worker running the task.
+ * @param task The task to run.
+ */
+static void runTask(YbwcWorker *worker, YbwcTask task) {
+    SplitPoint *sp = task.sp;
+    YbwcSearch *search = worker->search;
+
+    if (!isAborted(search, sp)) {
+        pthread_mutex_lock(&sp->lock);
+        int alpha = sp->root ? sp->alpha - 1 : sp->alpha;
+        int beta = sp->beta;
+        pthread_mutex_unlock(&sp->lock);
+
+        // A task may run on any worker, in the middle of another search: it gets a position of its own
+        int cell = sp->moves[task.index];
+        Position pos;
+        positionInit(&pos, sp->board, sp->isMaximizing);
+        makeMove(&pos, cell);
+        int value = ybwcNode(worker, &pos, sp->depth - 1, sp->ply + 1, !sp->isMaximizing, alpha, beta, sp);
+
+        if (!isAborted(search, sp)) {
+            pthread_mutex_lock(&sp->lock);
+            sp->values[task.index] = value;
+            if (sp->isMaximizing) {
+                if (value > sp->bestValue) {
+                    sp->bestValue = value;
+                    sp->bestMove = cell;
+                }
+                sp->alpha = (sp->alpha > sp->bestValue) ? sp->alpha : sp->bestValue;
+            } else {
+                if (value < sp->bestValue) {
+                    sp->bestValue = value;
+                    sp->bestMove = cell;
+                }
+                sp->beta = (sp->beta < sp->bestValue) ? sp->beta : sp->bestValue;
+            }
+            if (!sp->root && sp->beta <= sp->alpha) {
+                atomic_store(&sp->cutoff, true);
+            }
+            pthread_mutex_unlock(&sp->lock);
+        }
+    }
+    atomic_fetch_sub(&sp->pending, 1);
+}
+
+/**
+ * Waits for the younger brothers of a split point. The owner does not sleep meanwhile: it runs its own
+ * pending tasks first, then steals work from the other workers.
+ *
+ * @param worker The worker owning the split point.
+ * @param sp The split point to complete.
+ */
+static void waitSplitPoint(YbwcWorker *worker, SplitPoint *sp) {
+    YbwcTask task;
+    while (atomic_load(&sp->pending) > 0) {
+        if (popTask(worker, &task) || stealTask(worker, &task)) {
+            runTask(worker, task);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * Raises the stop flag once the deadline has passed. The clock is only read every 1024 nodes.
+ *
+ * @param worker The worker checking the clock.
+ */
+static void checkDeadline(YbwcWorker *worker) {
+    YbwcSearch *search = worker->search;
+    if (search->timed && (worker->nodes & 1023) == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > search->deadline.tv_sec ||
+            (now.tv_sec == search->deadline.tv_sec && now.tv_nsec >= search->deadline.tv_nsec)) {
+            atomic_store(&search->stopped, true);
+        }
+    }
+}
+
+/**
+ * Parallel Alpha-Beta search following the Young Brothers Wait Concept: the eldest child of a node is
+ * searched alone, and only if it does not produce a cutoff are its younger brothers offered to the other
+ * workers through a split point. Scores and cutoffs follow the sequential alphaBeta() of the AI.
+ *
+ * @param worker The worker running the search.
+ * @param pos The position to search, played on in place and restored before returning.
+ * @param depth The remaining depth of the search tree.
+ * @param ply The distance from the root of the search.
+ * @param isMaximizing A boolean indicating whether the current player is maximizing (true) or minimizing (false).
+ * @param alpha The current best score for the maximizing player.
+ * @param beta The current best score for the minimizing player.
+ * @param parent The innermost enclosing split point, NULL at the top of the search.
+ * @return The best score for the current player, meaningless if the subtree was aborted.
+ */
+static int ybwcNode(YbwcWorker *worker, Position *pos, int depth, int ply, bool isMaximizing, int alpha, int beta,
+                    SplitPoint *parent) {
+    YbwcSearch *search = worker->search;
+    worker->nodes++;
+    checkDeadline(worker);
+    if (isAborted(search, parent)) {
+        return 0;
+    }
+
+    bool terminal;
+    int score = search->evaluator->evaluate(pos->gen.board, isMaximizing, ply, &terminal);
+    if (depth == 0 || terminal) {
+        return score;
+    }
+
+    TTEntry entry;
+    int tt_move = -1;
+    if (ttProbe(&search->table, pos->hash, &entry)) {
+        int tt_score = evalScoreFromTable(entry.score, ply);
+        if (entry.depth == depth &&
+            (entry.bound == TT_EXACT ||
+             (entry.bound == TT_LOWER && tt_score >= beta) ||
+             (entry.bound == TT_UPPER && tt_score <= alpha))) {
+            return tt_score;
+        }
+        tt_move = entry.best_move;
+    }
+
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int moves[ROWS * COLS];
+    int num_moves = 0;
+    Bitboard legal = pos->gen.legal;
+    if (tt_move >= 0 && (legal & (((Bitboard) 1) << tt_move))) {
+        moves[num_moves++] = tt_move;
+        legal &= ~(((Bitboard) 1) << tt_move);
+    }
+    while (legal) {
+        moves[num_moves++] = __builtin_ctzll(legal);
+        legal &= legal - 1;
+    }
+
+    // Eldest brother: searched alone
+    makeMove(pos, moves[0]);
+    int bestValue = ybwcNode(worker, pos, depth - 1, ply + 1, !isMaximizing, alpha, beta, parent);
+    unmakeMove(pos);
+    int bestMove = moves[0];
+    if (isAborted(search, parent)) {
+        return 0;
+    }
+    if (isMaximizing) {
+        alpha = (alpha > bestValue) ? alpha : bestValue;
+    } else {
+        beta = (beta < bestValue) ? beta : bestValue;
+    }
+
+    if (beta > alpha && num_moves > 1) {
+        if (depth >= YBWC_MIN_SPLIT_DEPTH) {
+            // Younger brothers: offered to the other workers
+            SplitPoint sp;
+            sp.parent = parent;
+            sp.board = pos->gen.board;
+            sp.depth = depth;
+            sp.ply = ply;
+            sp.isMaximizing = isMaximizing;
+            sp.root = false;
+            memcpy(sp.moves, moves, num_moves * sizeof(int));
+            pthread_mutex_init(&sp.lock, NULL);
+            sp.alpha = alpha;
+            sp.beta = beta;
+            sp.bestValue = bestValue;
+            sp.bestMove = bestMove;
+            atomic_init(&sp.pending, num_moves - 1);
+            atomic_init(&sp.cutoff, false);
+
+            for (int i = num_moves - 1; i >= 1; i--) {
+                pushTask(worker, (YbwcTask) {&sp, i});
+            }
+            waitSplitPoint(worker, &sp);
+
+            pthread_mutex_destroy(&sp.lock);
+            bestValue = sp.bestValue;
+            bestMove = sp.bestMove;
+            if (isAborted(search, parent)) {
+                return 0;
+            }
+        } else {
+            for (int i = 1; i < num_moves && beta > alpha; i++) {
+                makeMove(pos, moves[i]);
+                int value = ybwcNode(worker, pos, depth - 1, ply + 1, !isMaximizing, alpha, beta, parent);
+                unmakeMove(pos);
+                if (isAborted(search, parent)) {
+                    return 0;
+                }
+                if (isMaximizing ? value > bestValue : value < bestValue) {
+                    bestValue = value;
+                    bestMove = moves[i];
+                }
+                if (isMaximizing) {
+                    alpha = (alpha > bestValue) ? alpha : bestValue;
+                } else {
+                    beta = (beta < bestValue) ? beta : bestValue;
+                }
+            }
+        }
+    }
+
+    BoundType bound = TT_EXACT;
+    if (bestValue <= alphaOrig) {
+        bound = TT_UPPER;
+    } else if (bestValue >= betaOrig) {
+        bound = TT_LOWER;
+    }
+    ttStore(&search->table, pos->hash, depth, bound, evalScoreToTable(bestValue, ply), bestMove);
+    return bestValue;
+}
+
+/**
+ * Main loop of a helper worker: while a search is active it steals and runs tasks,
+ * otherwise it sleeps until the next search starts.
+ *
+ * @param arg A pointer to the YbwcWorker of the thread.
+ * @return Always NULL.
+ */
+static void *ybwcHelper(void *arg) {
+    YbwcWorker *worker = (YbwcWorker *) arg;
+    YbwcSearch *search = worker->search;
+    YbwcTask task;
+
+    while (!atomic_load(&search->quit)) {
+        if (!atomic_load(&search->active)) {
+            pthread_mutex_lock(&search->idle_lock);
+            while (!atomic_load(&search->active) && !atomic_load(&search->quit)) {
+                pthread_cond_wait(&search->wake, &search->idle_lock);
+            }
+            pthread_mutex_unlock(&search->idle_lock);
+            continue;
+        }
+        if (popTask(worker, &task) || stealTask(worker, &task)) {
+            runTask(worker, task);
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Starts a parallel search with its helper threads and its shared transposition table.
+ *
+ * @param search The parallel search to initialize.
+ * @param num_workers The number of workers, the calling thread included.
+ * @param table_bits The base-2 logarithm of the number of entries of the shared table.
+ * @return True on success, false if the memory or the threads could not be allocated.
+ */
+bool ybwcInit(YbwcSearch *search, int num_workers, int table_bits) {
+    search->workers = calloc(num_workers, sizeof(YbwcWorker));
+    if (search->workers == NULL || !ttInit(&search->table, table_bits)) {
+        free(search->workers);
+        return false;
+    }
+
+    search->num_workers = num_workers;
+    atomic_init(&search->active, false);
+    atomic_init(&search->quit, false);
+    atomic_init(&search->stopped, false);
+    search->timed = false;
+    search->evaluator = aiEvaluator();
+    pthread_mutex_init(&search->idle_lock, NULL);
+    pthread_cond_init(&search->wake, NULL);
+
+    for (int i = 0; i < num_workers; i++) {
+        search->workers[i].search = search;
+        search->workers[i].id = i;
+        pthread_mutex_init(&search->workers[i].lock, NULL);
+    }
+    for (int i = 1; i < num_workers; i++) {
+        if (pthread_create(&search->workers[i].thread, NULL, ybwcHelper, &search->workers[i]) != 0) {
+            search->num_workers = i;
+            ybwcDestroy(search);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Stops the helper threads and releases a parallel search.
+ *
+ * @param search The parallel search to destroy.
+ */
+void ybwcDestroy(YbwcSearch *search) {
+    pthread_mutex_lock(&search->idle_lock);
+    atomic_store(&search->quit, true);
+    pthread_cond_broadcast(&search->wake);
+    pthread_mutex_unlock(&search->idle_lock);
+
+    for (int i = 1; i < search->num_workers; i++) {
+        pthread_join(search->workers[i].thread, NULL);
+    }
+    for (int i = 0; i < search->num_workers; i++) {
+        pthread_mutex_destroy(&search->workers[i].lock);
+    }
+    pthread_mutex_destroy(&search->idle_lock);
+    pthread_cond_destroy(&search->wake);
+    ttFree(&search->table);
+    free(search->workers);
+    search->workers = NULL;
+    search->num_workers = 0;
+}
+
+/**
+ * Sets the deadline of the following searches.
+ *
+ * @param search The parallel search.
+ * @param timed True if the deadline applies, false to search without time limit.
+ * @param deadline The time at which the searches stop (CLOCK_MONOTONIC).
+ */
+void ybwcSetDeadline(YbwcSearch *search, bool timed, struct timespec deadline) {
+    search->timed = timed;
+    search->deadline = deadline;
+}
+
+/**
+ * Wakes the helpers up for a new search.
+ *
+ * @param search The parallel search.
+ */
+static void startSearch(YbwcSearch *search) {
+    atomic_store(&search->stopped, false);
+    pthread_mutex_lock(&search->idle_lock);
+    atomic_store(&search->active, true);
+    pthread_cond_broadcast(&search->wake);
+    pthread_mutex_unlock(&search->idle_lock);
+}
+
+/**
+ * Sends the helpers back to sleep once a search is complete.
+ *
+ * @param search The parallel search.
+ */
+static void endSearch(YbwcSearch *search) {
+    atomic_store(&search->active, false);
+}
+
+/**
+ * Parallel counterpart of minimaxBitboard(): same arguments, same score, computed by every worker.
+ *
+ * @param search The parallel search.
+ * @param board The bitboard of the position to search.
+ * @param depth The maximum depth of the search tree.
+ * @param isMaximizing A boolean indicating whether the current player is maximizing (true) or minimizing (false).
+ * @param alpha The current best score for the maximizing player.
+ * @param beta The current best score for the minimizing player.
+ * @return The best score for the current player, meaningless if the deadline passed.
+ */
+int ybwcMinimax(YbwcSearch *search, Bitboard board, int depth, bool isMaximizing, int alpha, int beta) {
+    Position pos;
+    positionInit(&pos, board, isMaximizing);
+    startSearch(search);
+    int value = ybwcNode(&search->workers[0], &pos, depth, 0, isMaximizing, alpha, beta, NULL);
+    endSearch(search);
+    return value;
+}
+
+/**
+ * Parallel counterpart of the AI's root search: the first root move is searched alone, then the others
+ * are shared through a root split point. Root moves are searched with alpha one below the best score,
+ * so every move at least as good as the best gets its exact score and ties go to the lowest index,
+ * as in the sequential search.
+ *
+ * @param search The parallel search.
+ * @param board The bitboard of the position, the AI being the maximizing player.
+ * @param moves The root moves, in search order.
+ * @param num_moves The number of root moves.
+ * @param depth The depth of the search, the root move included.
+ * @param best_index Receives the index of the best move in the moves array.
+ * @return The score of the best move, or -INF if the deadline passed.
+ */
+int ybwcSearchRoot(YbwcSearch *search, Bitboard board, int moves[][2], int num_moves, int depth, int *best_index) {
+    YbwcWorker *master = &search->workers[0];
+    SplitPoint sp;
+    Position pos;
+    positionInit(&pos, board, true);
+
+    startSearch(search);
+    sp.parent = NULL;
+    sp.board = board;
+    sp.depth = depth;
+    sp.ply = 0;
+    sp.isMaximizing = true;
+    sp.root = true;
+    for (int i = 0; i < num_moves; i++) {
+        sp.moves[i] = BB_INDEX(moves[i][0], moves[i][1]);
+        sp.values[i] = -INF;
+    }
+
+    makeMove(&pos, sp.moves[0]);
+    sp.values[0] = ybwcNode(master, &pos, depth - 1, 1, false, -INF, INF, NULL);
+
+    pthread_mutex_init(&sp.lock, NULL);
+    sp.alpha = sp.values[0];
+    sp.beta = INF;
+    sp.bestValue = sp.values[0];
+    sp.bestMove = sp.moves[0];
+    atomic_init(&sp.pending, num_moves - 1);
+    atomic_init(&sp.cutoff, false);
+    if (!atomic_load(&search->stopped)) {
+        for (int i = num_moves - 1; i >= 1; i--) {
+            pushTask(master, (YbwcTask) {&sp, i});
+        }
+        waitSplitPoint(master, &sp);
+    } else {
+        atomic_store(&sp.pending, 0);
+    }
+    pthread_mutex_destroy(&sp.lock);
+    endSearch(search);
+
+    if (atomic_load(&search->stopped)) {
+        return -INF;
+    }
+    int bestValue = -INF;
+    *best_index = 0;
+    for (int i = 0; i < num_moves; i++) {
+        if (sp.values[i] > bestValue) {
+            bestValue = sp.values[i];
+            *best_index = i;
+        }
+    }
+    return bestValue;
+}
+
+/**
+ * Returns the number of positions visited by every worker since the search was initialized.
+ *
+ * @param search The parallel search.
+ * @return The total node count.
+ */
+uint64_t ybwcNodes(YbwcSearch *search) {
+    uint64_t nodes = 0;
+    for (int i = 0; i < search->num_workers; i++) {
+        nodes += search->workers[i].nodes;
+    }
+    return nodes;
+}
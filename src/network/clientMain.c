@@ -14,11 +14,11 @@
  * @param guiMode A boolean value indicating whether the game runs in graphical mode (true) or console mode (false).
  * @param serverMode A boolean indicating whether the client is in server mode (true) or not (false).
  * @param clientMode A boolean indicating whether the client is in client mode (true) or not (false).
+ *
+ * The client says hello first; the server answers with the client's seat once an opponent is found
+ * (at once for a single-game server, where the client always moves first).
  */
 void clientMain(char* ip, int port, bool ai, bool guiMode, bool serverMode, bool clientMode) {
-    // Initialization of the client's connection to the server
-    int new_sock = 0;
-
     // Establishing the client connection to the server
     int sock = initClient(ip, port);
     printf("sock = %d \n", sock);
@@ -28,16 +28,41 @@ void clientMain(char* ip, int port, bool ai, bool guiMode, bool serverMode, bool
     int row, col;                  // Row and column of the chosen square
     char col_char;                 // Column as a character (A-I)
     int player = 1;                // Player turn (1 = Client, 2 = Server)
-    char buffer[1024] = {0};       // Buffer for transferring data between client and server
-    int valread = 0;               // Value to check if the server has played a move
+    int seat = 0;                  // Seat given by the server, 0 moves first
+    Channel channel;               // Frames exchanged with the server
+    Message msg;                   // Last message received from the server
 
     // Initialize the game board
     initBoard(board);
+    channelInit(&channel, sock);
+
+    printf("Waiting for an opponent...\n");
+    if (sock < 0 || !channelSendHello(&channel, PROTOCOL_ANY_SEAT) || !channelReceive(&channel, &msg) ||
+        msg.type != MSG_HELLO || msg.hello.rows != ROWS || msg.hello.cols != COLS) {
+        printf("The server refused the game.\n");
+        if (sock >= 0) {
+            close(sock);
+        }
+        return;
+    }
+    seat = msg.hello.seat;
+    recordStartGame(ROWS, COLS);
+    if (seat == 1) {
+        printf("Opponent found, it moves first.\n");
+        player = 2;
+    } else {
+        printf("Opponent found, you move first.\n");
+    }
 
     // If the GUI mode is enabled, launch the graphical interface
     if (guiMode) {
         printf("Launching GUI...\n");
-        mainGui(ai, serverMode, clientMode, sock, new_sock);
+        if (player == 2) {
+            // Moving second is the server's role in the GUI
+            mainGui(ai, true, false, &channel);
+        } else {
+            mainGui(ai, serverMode, clientMode, &channel);
+        }
     } else {
         // Client loop - runs until the game is over
         while (1) {
@@ -59,10 +84,6 @@ void clientMain(char* ip, int port, bool ai, bool guiMode, bool serverMode, bool
                     // Convert the user's input into matrix indices
                     col = toupper(col_char) - 'A';  // Convert 'A' -> 0, 'B' -> 1, etc.
                     row -= 1;  // Adjust the row index to start from 0
-
-                    // Transfer the [A-I][1-7] data to the client via buffer
-                    buffer[0] = toupper(col_char);  // Store column letter as is
-                    buffer[1] = (row + 1) + '0';    // Convert row number to character (1 -> '1', 2 -> '2', etc.)
                 }
 
                 // AI move
@@ -72,34 +93,31 @@ void clientMain(char* ip, int port, bool ai, bool guiMode, bool serverMode, bool
                     // AI selects a move
                     aiChooseMove(board, &row, &col);
                     printf("AI chose col = %d and row = %d\n", col, row);
-
-                    // Convert column and row into valid move format for the client
-                    buffer[0] = col + 'A';  // Convert 0 -> 'A', 1 -> 'B', ..., 8 -> 'I'
-                    buffer[1] = row + '1';  // Convert 0 -> '1', 1 -> '2', ..., 6 -> '7'
                 }
 
-                // Validate the move format before sending it to the server
-                if (strlen(buffer) == 2 &&
-                    buffer[0] >= 'A' && buffer[0] <= 'I' &&
-                    buffer[1] >= '1' && buffer[1] <= '7') {
+                // Validate the move before sending it to the server
+                if (row >= 0 && row < ROWS && col >= 0 && col < COLS) {
 
-                    // Verify if the square can be destroyed
-                    if (canDestroy(board, row, col)) {
+                    // Verify the move with the check the server applies to it
+                    if (bitboardIsLegalMove(boardToBitboard(board), row, col)) {
 
-                        // Destroy the square if valid
-                        if (destroySquaresConsole(board, row, col, false)) {
-                            printf("Valid move. Sending to server...\n");
+                        // Destroy the squares
+                        destroySquaresConsole(board, row, col, false);
+                        recordMove(row, col);
+                        printf("Valid move. Sending to server...\n");
 
-                            // Display the updated board
-                            displayBoard(board);
+                        // Display the updated board
+                        displayBoard(board);
 
-                            // Send the move to the server
-                            send(sock, buffer, strlen(buffer), 0);
-
-                            // End of client's turn
-                            player = 2;
+                        // Send the move to the server, with the ack of the server's last move
+                        if (!channelSendMove(&channel, row, col)) {
+                            printf("The server closed the connection.\n");
+                            break;
                         }
 
+                        // End of client's turn
+                        player = 2;
+
                         // Check if the game is over
                         if (board[0][0] == 0) {
                             printf("\nSERVER WINS!\n");
@@ -107,8 +125,8 @@ void clientMain(char* ip, int port, bool ai, bool guiMode, bool serverMode, bool
                         }
 
                     } else {
-                        // Invalid move (square already destroyed)
-                        printf("Invalid move. Square already destroyed. Try again.\n");
+                        // Invalid move (square already destroyed, or too many squares)
+                        printf("Invalid move. Square already destroyed or too many squares. Try again.\n");
                         continue;
                     }
 
@@ -124,52 +142,47 @@ void clientMain(char* ip, int port, bool ai, bool guiMode, bool serverMode, bool
                 printf("Server's turn\n");
 
                 // Wait until server plays a move and sends it
-                read(sock, buffer, 1024);
-                valread = strlen(buffer);
-
-                if (valread != 0) {
-                    // Process the server's move
-
-                    if (valread > 0) {
-                        printf("\nServer played: %c%c\n", buffer[0], buffer[1]);
-
-                        // Convert lowercase to uppercase if necessary
-                        if (buffer[0] >= 'a' && buffer[0] <= 'i') {
-                            buffer[0] = toupper(buffer[0]);
-                        }
-
-                        // Validate the move format
-                        if (strlen(buffer) == 2 &&
-                            buffer[0] >= 'A' && buffer[0] <= 'I' &&
-                            buffer[1] >= '1' && buffer[1] <= '7') {
-
-                            // Convert buffer values to matrix indices
-                            col = buffer[0] - 'A';
-                            row = buffer[1] - '1';
-
-                            // Verify if the square can be destroyed
-                            if (canDestroy(board, row, col)) {
-                                // Destroy the square
-                                destroySquaresConsole(board, row, col, false);
+                int type = channelReceiveMove(&channel, &row, &col, &msg);
+                if (type == MSG_GAME_OVER) {
+                    recordEndGame(msg.over.loser);
+                    printf("\nGame over (%s): %s WINS!\n", protocolReasonName(msg.over.reason),
+                           msg.over.loser == seat ? "SERVER" : "CLIENT");
+                    break;
+                }
+                if (type == MSG_RESIGN) {
+                    recordEndGame(1 - seat);
+                    printf("\nServer resigned. CLIENT WINS!\n");
+                    break;
+                }
+                if (type != MSG_MOVE) {
+                    printf("The server closed the connection.\n");
+                    break;
+                }
+                printf("\nServer played: %c%d\n", 'A' + col, row + 1);
 
-                                // Display the updated board
-                                displayBoard(board);
+                // Verify the move with the rules the servers apply, the ack only accepts a legal move
+                if (bitboardIsLegalMove(boardToBitboard(board), row, col)) {
+                    // Destroy the square, the ack leaves with the client's next move
+                    destroySquaresConsole(board, row, col, false);
+                    recordMove(row, col);
+                    channelAck(&channel, msg.seq);
 
-                                // End of server's turn
-                                player = 1;
+                    // Display the updated board
+                    displayBoard(board);
 
-                                // Check if the game is over
-                                if (board[0][0] == 0) {
-                                    printf("\nCLIENT WINS!\n");
-                                    break;
-                                }
+                    // End of server's turn
+                    player = 1;
 
-                                // Clear the buffer
-                                memset(buffer, 0, sizeof(buffer));
-                                printf("The buffer has been erased.\n");
-                            }
-                        }
+                    // Check if the game is over
+                    if (board[0][0] == 0) {
+                        printf("\nCLIENT WINS!\n");
+                        break;
                     }
+                } else {
+                    channelSendGameOver(&channel, 1 - seat, OVER_ILLEGAL_MOVE);
+                    recordEndGame(1 - seat);
+                    printf("\nThe server played an invalid move. CLIENT WINS!\n");
+                    break;
                 }
             }
         }
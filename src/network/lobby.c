@@ -0,0 +1,664 @@
+#include "../../includes/lobby.h"
+
+static void closeConnection(Lobby *lobby, LobbyConnection *conn);
+
+/**
+ * Switches a file descriptor to non-blocking mode.
+ *
+ * @param fd The file descriptor.
+ * @return True on success, false otherwise.
+ */
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * Appends a connection to the list of clients waiting for an opponent.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection.
+ */
+static void enqueueWaiting(Lobby *lobby, LobbyConnection *conn) {
+    conn->next = NULL;
+    conn->prev = lobby->waiting_tail;
+    if (lobby->waiting_tail != NULL) {
+        lobby->waiting_tail->next = conn;
+    } else {
+        lobby->waiting_head = conn;
+    }
+    lobby->waiting_tail = conn;
+}
+
+/**
+ * Removes a connection from the list of clients waiting for an opponent.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection, which must be waiting.
+ */
+static void dequeueWaiting(Lobby *lobby, LobbyConnection *conn) {
+    if (conn->prev != NULL) {
+        conn->prev->next = conn->next;
+    } else {
+        lobby->waiting_head = conn->next;
+    }
+    if (conn->next != NULL) {
+        conn->next->prev = conn->prev;
+    } else {
+        lobby->waiting_tail = conn->prev;
+    }
+    conn->next = conn->prev = NULL;
+}
+
+/**
+ * Sends as much of the pending output of a connection as the kernel accepts. The connection listens for
+ * EPOLLOUT only while output remains. A closing connection is closed once its output is sent.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection.
+ */
+static void flushConnection(Lobby *lobby, LobbyConnection *conn) {
+    int sent = 0;
+    while (sent < conn->out_len) {
+        ssize_t n = send(conn->fd, conn->out + sent, conn->out_len - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (int) n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeConnection(lobby, conn);
+            return;
+        }
+    }
+    memmove(conn->out, conn->out + sent, conn->out_len - sent);
+    conn->out_len -= sent;
+
+    bool writable = conn->out_len == 0;
+    if (writable != conn->writable) {
+        struct epoll_event event = {.events = EPOLLIN | (writable ? 0 : EPOLLOUT), .data.ptr = conn};
+        epoll_ctl(lobby->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+        conn->writable = writable;
+    }
+    if (writable && conn->state == CONN_CLOSING) {
+        closeConnection(lobby, conn);
+    }
+}
+
+/**
+ * Numbers a message and appends its frame to the output of a connection, without sending it:
+ * the frames queued while handling an event leave together with the next flush.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection, NULL for the AI (the message is dropped).
+ * @param msg The message.
+ */
+static void queueMessage(Lobby *lobby, LobbyConnection *conn, Message *msg) {
+    if (conn == NULL || conn->fd < 0) {
+        return;
+    }
+    msg->seq = conn->next_seq;
+    int size = protocolEncode(msg, conn->out + conn->out_len, LOBBY_OUT_SIZE - conn->out_len);
+    if (size < 0) {
+        // The client does not read its messages anymore
+        closeConnection(lobby, conn);
+        return;
+    }
+    conn->next_seq++;
+    conn->out_len += size;
+}
+
+/**
+ * Sends the queued output of both clients of a game.
+ *
+ * @param lobby The lobby.
+ * @param game The game.
+ */
+static void flushGame(Lobby *lobby, LobbyGame *game) {
+    for (int seat = 0; seat < 2; seat++) {
+        if (game->players[seat] != NULL && game->players[seat]->fd >= 0) {
+            flushConnection(lobby, game->players[seat]);
+        }
+    }
+}
+
+/**
+ * Ends a game: its clients are told who lost and why, and are closed once their last messages are sent.
+ * The game is appended to the record file, if one is open.
+ *
+ * @param lobby The lobby.
+ * @param game The game.
+ * @param loser The seat of the loser.
+ * @param reason A GameOverReason.
+ */
+static void finishGame(Lobby *lobby, LobbyGame *game, int loser, int reason) {
+    game->over = true;
+    lobby->games_finished++;
+    recordAppend(&game->record, loser);
+    for (int seat = 0; seat < 2; seat++) {
+        Message over = {.type = MSG_GAME_OVER, .over = {(uint8_t) loser, (uint8_t) reason}};
+        queueMessage(lobby, game->players[seat], &over);
+        if (game->players[seat] != NULL && game->players[seat]->fd >= 0) {
+            game->players[seat]->state = CONN_CLOSING;
+        }
+    }
+    flushGame(lobby, game);
+}
+
+/**
+ * Plays a legal move in a game and queues it for the opponent. Eating A1 ends the game,
+ * the player who ate it losing.
+ *
+ * @param lobby The lobby.
+ * @param game The game.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ */
+static void playMove(Lobby *lobby, LobbyGame *game, int row, int col) {
+    int mover = game->turn;
+    bitboardDestroySquares(&game->board, row, col);
+    gameRecordAddMove(&game->record, row, col);
+    game->turn = 1 - game->turn;
+
+    Message move = {.type = MSG_MOVE, .move = {(uint8_t) row, (uint8_t) col}};
+    queueMessage(lobby, game->players[game->turn], &move);
+    if ((game->board & BB_CELL(0, 0)) == 0) {
+        finishGame(lobby, game, mover, OVER_A1_EATEN);
+    }
+}
+
+/**
+ * Frees a game at the end of the loop iteration once its clients are closed, unless the AI service
+ * still refers to it.
+ *
+ * @param lobby The lobby.
+ * @param game The game.
+ */
+static void releaseGame(Lobby *lobby, LobbyGame *game) {
+    if (game->players[0] == NULL && game->players[1] == NULL && !game->thinking && !game->backlogged) {
+        game->next_dead = lobby->dead_games;
+        lobby->dead_games = game;
+    }
+}
+
+/**
+ * Asks the AI service for the AI's move of a game, if it is the AI's turn. The search runs on a service
+ * thread and the move is played when its result comes back (see collectAiMoves()), so a long search
+ * never delays the other games. If the service's queue is full, the game waits in the backlog.
+ *
+ * @param lobby The lobby.
+ * @param game The game.
+ */
+static void playAi(Lobby *lobby, LobbyGame *game) {
+    if (game->players[game->turn] != NULL || game->over || game->thinking || game->backlogged) {
+        return;
+    }
+    if (aiServiceSubmit(&lobby->ai, game->board, aiTimeBudget(), game)) {
+        game->thinking = true;
+    } else {
+        game->backlogged = true;
+        game->next_ai = lobby->ai_backlog;
+        lobby->ai_backlog = game;
+    }
+}
+
+/**
+ * Plays the AI moves computed by the AI service, then queues the backlogged games again now that
+ * the service has room. Games that ended meanwhile are released.
+ *
+ * @param lobby The lobby.
+ */
+static void collectAiMoves(Lobby *lobby) {
+    AiResult results[LOBBY_AI_RESULTS];
+    int n = aiServiceCollect(&lobby->ai, results, LOBBY_AI_RESULTS);
+
+    for (int i = 0; i < n; i++) {
+        LobbyGame *game = results[i].tag;
+        game->thinking = false;
+        aiReportStats(&results[i].stats);
+        if (game->over) {
+            releaseGame(lobby, game);
+            continue;
+        }
+        if (!bitboardIsLegalMove(game->board, results[i].row, results[i].col)) {
+            finishGame(lobby, game, game->turn, OVER_ILLEGAL_MOVE);
+            continue;
+        }
+        playMove(lobby, game, results[i].row, results[i].col);
+        playAi(lobby, game);
+        flushGame(lobby, game);
+    }
+
+    LobbyGame *backlog = lobby->ai_backlog;
+    lobby->ai_backlog = NULL;
+    while (backlog != NULL) {
+        LobbyGame *game = backlog;
+        backlog = game->next_ai;
+        game->backlogged = false;
+        if (game->over) {
+            releaseGame(lobby, game);
+        } else {
+            playAi(lobby, game);
+        }
+    }
+}
+
+/**
+ * Handles a move received from a client: it must be the client's turn and the move must be legal,
+ * otherwise the client loses the game. A legal move is acked and forwarded to the opponent, or to
+ * the AI service if the AI plays the other seat.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection.
+ * @param msg The move.
+ */
+static void handleMove(Lobby *lobby, LobbyConnection *conn, const Message *msg) {
+    LobbyGame *game = conn->game;
+    if (game->turn != conn->seat || !bitboardIsLegalMove(game->board, msg->move.row, msg->move.col)) {
+        finishGame(lobby, game, conn->seat, OVER_ILLEGAL_MOVE);
+        return;
+    }
+    Message ack = {.type = MSG_ACK, .ack = {msg->seq}};
+    queueMessage(lobby, conn, &ack);
+    playMove(lobby, game, msg->move.row, msg->move.col);
+    playAi(lobby, game);
+    flushGame(lobby, game);
+}
+
+/**
+ * Seats two clients, or a client and the AI, in a new game. The first seat moves first;
+ * each client is told its seat with a hello, then the AI plays if it moves first.
+ *
+ * @param lobby The lobby.
+ * @param first The client moving first, NULL for the AI.
+ * @param second The client moving second, NULL for the AI.
+ */
+static void startGame(Lobby *lobby, LobbyConnection *first, LobbyConnection *second) {
+    LobbyGame *game = calloc(1, sizeof(LobbyGame));
+    if (game == NULL) {
+        LobbyConnection *players[2] = {first, second};
+        for (int seat = 0; seat < 2; seat++) {
+            if (players[seat] != NULL) {
+                players[seat]->state = CONN_CLOSING;
+                closeConnection(lobby, players[seat]);
+            }
+        }
+        return;
+    }
+    game->board = BB_FULL;
+    game->players[0] = first;
+    game->players[1] = second;
+    game->turn = 0;
+    gameRecordInit(&game->record, ROWS, COLS);
+    lobby->games_started++;
+
+    LobbyConnection *players[2] = {first, second};
+    for (int seat = 0; seat < 2; seat++) {
+        if (players[seat] != NULL) {
+            players[seat]->state = CONN_PLAYING;
+            players[seat]->game = game;
+            players[seat]->seat = seat;
+            Message hello = {.type = MSG_HELLO, .hello = {(uint8_t) seat, ROWS, COLS}};
+            queueMessage(lobby, players[seat], &hello);
+        }
+    }
+    playAi(lobby, game);
+    flushGame(lobby, game);
+}
+
+/**
+ * Pairs the waiting clients: the two oldest play each other, and a client waiting longer than the
+ * pairing timeout (or any client if the lobby only offers the AI) plays the AI, moving first.
+ *
+ * @param lobby The lobby.
+ */
+static void pairClients(Lobby *lobby) {
+    while (!lobby->ai_only && lobby->waiting_head != NULL && lobby->waiting_head->next != NULL) {
+        LobbyConnection *first = lobby->waiting_head;
+        LobbyConnection *second = first->next;
+        dequeueWaiting(lobby, first);
+        dequeueWaiting(lobby, second);
+        startGame(lobby, first, second);
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    while (lobby->waiting_head != NULL) {
+        LobbyConnection *conn = lobby->waiting_head;
+        long waited_ms = (now.tv_sec - conn->since.tv_sec) * 1000 + (now.tv_nsec - conn->since.tv_nsec) / 1000000;
+        if (!lobby->ai_only && waited_ms < lobby->pair_timeout_ms) {
+            break;
+        }
+        dequeueWaiting(lobby, conn);
+        startGame(lobby, conn, NULL);
+    }
+}
+
+/**
+ * Closes a client connection. If its game is still running, the game ends and the opponent is
+ * disconnected too. The memory is released at the end of the loop iteration.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection, ignored if NULL or already closed.
+ */
+static void closeConnection(Lobby *lobby, LobbyConnection *conn) {
+    if (conn == NULL || conn->fd < 0) {
+        return;
+    }
+    if (conn->state == CONN_WAITING) {
+        dequeueWaiting(lobby, conn);
+    }
+    epoll_ctl(lobby->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn->fd = -1;
+    lobby->connections--;
+    if (conn->all_prev != NULL) {
+        conn->all_prev->all_next = conn->all_next;
+    } else {
+        lobby->all = conn->all_next;
+    }
+    if (conn->all_next != NULL) {
+        conn->all_next->all_prev = conn->all_prev;
+    }
+
+    LobbyGame *game = conn->game;
+    if (game != NULL) {
+        if (!game->over) {
+            // Disconnected in the middle of a game: the opponent wins
+            finishGame(lobby, game, conn->seat, OVER_DISCONNECTED);
+        }
+        game->players[conn->seat] = NULL;
+        conn->game = NULL;
+        releaseGame(lobby, game);
+    }
+    conn->next = lobby->graveyard;
+    lobby->graveyard = conn;
+}
+
+/**
+ * Frees the connections closed during the current loop iteration, and their games. They are kept until then
+ * because later events of the iteration, or the caller of closeConnection(), may still refer to them.
+ *
+ * @param lobby The lobby.
+ */
+static void freeClosedConnections(Lobby *lobby) {
+    while (lobby->graveyard != NULL) {
+        LobbyConnection *dead = lobby->graveyard;
+        lobby->graveyard = dead->next;
+        free(dead);
+    }
+    while (lobby->dead_games != NULL) {
+        LobbyGame *dead = lobby->dead_games;
+        lobby->dead_games = dead->next_dead;
+        free(dead);
+    }
+}
+
+/**
+ * Handles a message received from a client, according to the state of its connection: a new client must
+ * say hello with the board size of the server, then waits for an opponent, then plays. Pings are acked
+ * in any state. Any other message closes the connection.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection.
+ * @param msg The message.
+ */
+static void handleMessage(Lobby *lobby, LobbyConnection *conn, const Message *msg) {
+    if (msg->type == MSG_PING) {
+        Message ack = {.type = MSG_ACK, .ack = {msg->seq}};
+        queueMessage(lobby, conn, &ack);
+        return;
+    }
+    if (msg->type == MSG_ACK) {
+        return;
+    }
+    if (conn->state == CONN_HELLO && msg->type == MSG_HELLO &&
+        msg->hello.rows == ROWS && msg->hello.cols == COLS) {
+        conn->state = CONN_WAITING;
+        clock_gettime(CLOCK_MONOTONIC, &conn->since);
+        enqueueWaiting(lobby, conn);
+    } else if (conn->state == CONN_PLAYING && msg->type == MSG_MOVE) {
+        handleMove(lobby, conn, msg);
+    } else if (conn->state == CONN_PLAYING && msg->type == MSG_RESIGN) {
+        finishGame(lobby, conn->game, conn->seat, OVER_RESIGNED);
+    } else {
+        closeConnection(lobby, conn);
+    }
+}
+
+/**
+ * Reads the bytes available on a client connection and handles every complete frame. A partial frame is
+ * kept until the rest arrives; a malformed stream closes the connection.
+ *
+ * @param lobby The lobby.
+ * @param conn The connection.
+ */
+static void handleRead(Lobby *lobby, LobbyConnection *conn) {
+    while (conn->fd >= 0) {
+        ssize_t n = recv(conn->fd, conn->in + conn->in_len, sizeof(conn->in) - conn->in_len, 0);
+        if (n == 0) {
+            closeConnection(lobby, conn);
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                closeConnection(lobby, conn);
+            }
+            break;
+        }
+        if (conn->state == CONN_CLOSING) {
+            continue;
+        }
+        conn->in_len += (int) n;
+
+        int used = 0;
+        Message msg;
+        int size;
+        while (conn->fd >= 0 && conn->state != CONN_CLOSING &&
+               (size = protocolDecode(conn->in + used, conn->in_len - used, &msg)) != 0) {
+            if (size < 0) {
+                closeConnection(lobby, conn);
+                return;
+            }
+            used += size;
+            handleMessage(lobby, conn, &msg);
+        }
+        memmove(conn->in, conn->in + used, conn->in_len - used);
+        conn->in_len -= used;
+    }
+    if (conn->fd >= 0) {
+        flushConnection(lobby, conn);
+    }
+}
+
+/**
+ * Accepts every pending connection of the listening socket. The new clients join the waiting list once
+ * they said hello.
+ *
+ * @param lobby The lobby.
+ */
+static void acceptClients(Lobby *lobby) {
+    for (;;) {
+        int fd = accept(lobby->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("accept");
+            }
+            if (errno != EINTR) {
+                return;
+            }
+            continue;
+        }
+
+        LobbyConnection *conn = calloc(1, sizeof(LobbyConnection));
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = conn};
+        if (conn == NULL || !setNonBlocking(fd) || epoll_ctl(lobby->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            free(conn);
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->state = CONN_HELLO;
+        conn->writable = true;
+        conn->all_next = lobby->all;
+        if (lobby->all != NULL) {
+            lobby->all->all_prev = conn;
+        }
+        lobby->all = conn;
+        lobby->connections++;
+    }
+}
+
+/**
+ * Opens the listening socket and the epoll instance of a lobby, and starts its AI service.
+ *
+ * @param lobby The lobby to initialize.
+ * @param port The port to listen on, 0 for any free port (see the listening socket for the one chosen).
+ * @param ai_only True if every client plays the AI, false to pair clients with each other first.
+ * @return True on success, false otherwise (an error message is printed).
+ */
+bool lobbyInit(Lobby *lobby, int port, bool ai_only) {
+    memset(lobby, 0, sizeof(Lobby));
+    lobby->ai_only = ai_only;
+    lobby->pair_timeout_ms = LOBBY_PAIR_TIMEOUT_MS;
+    atomic_init(&lobby->running, true);
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+
+    int reuse = 1;
+    lobby->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (lobby->listen_fd < 0 ||
+        setsockopt(lobby->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+        bind(lobby->listen_fd, (struct sockaddr *) &address, sizeof(address)) < 0 ||
+        listen(lobby->listen_fd, LOBBY_BACKLOG) < 0 || !setNonBlocking(lobby->listen_fd)) {
+        perror("lobby socket");
+        if (lobby->listen_fd >= 0) {
+            close(lobby->listen_fd);
+        }
+        return false;
+    }
+
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    lobby->epoll_fd = epoll_create1(0);
+    if (lobby->epoll_fd < 0 || epoll_ctl(lobby->epoll_fd, EPOLL_CTL_ADD, lobby->listen_fd, &event) < 0) {
+        perror("epoll");
+        close(lobby->listen_fd);
+        return false;
+    }
+
+    // One search thread per core; its results wake the event loop like a client does
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    struct epoll_event ai_event = {.events = EPOLLIN, .data.ptr = &lobby->ai};
+    if (!aiServiceInit(&lobby->ai, cores > 0 ? (int) cores : 1, AI_SERVICE_QUEUE, aiHashBits())) {
+        fprintf(stderr, "Could not start the AI service.\n");
+        close(lobby->listen_fd);
+        close(lobby->epoll_fd);
+        return false;
+    }
+    if (epoll_ctl(lobby->epoll_fd, EPOLL_CTL_ADD, aiServiceFd(&lobby->ai), &ai_event) < 0) {
+        perror("epoll");
+        aiServiceDestroy(&lobby->ai);
+        close(lobby->listen_fd);
+        close(lobby->epoll_fd);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Runs the event loop of a lobby until lobbyStop() is called. The listening socket stays open across games;
+ * every client connection is a small state machine (hello, waiting, playing, closing) driven by epoll events.
+ *
+ * @param lobby The lobby.
+ */
+void lobbyRun(Lobby *lobby) {
+    struct epoll_event events[LOBBY_MAX_EVENTS];
+
+    while (atomic_load(&lobby->running)) {
+        int n = epoll_wait(lobby->epoll_fd, events, LOBBY_MAX_EVENTS, LOBBY_TICK_MS);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            LobbyConnection *conn = events[i].data.ptr;
+            if (conn == NULL) {
+                acceptClients(lobby);
+                continue;
+            }
+            if (events[i].data.ptr == &lobby->ai) {
+                collectAiMoves(lobby);
+                continue;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(lobby, conn);
+            }
+            if (conn->fd >= 0 && (events[i].events & EPOLLOUT)) {
+                flushConnection(lobby, conn);
+            }
+            if (conn->fd >= 0 && (events[i].events & EPOLLIN)) {
+                handleRead(lobby, conn);
+            }
+        }
+        pairClients(lobby);
+        freeClosedConnections(lobby);
+    }
+}
+
+/**
+ * Asks the event loop of a lobby to return. Safe to call from another thread or a signal handler.
+ *
+ * @param lobby The lobby.
+ */
+void lobbyStop(Lobby *lobby) {
+    atomic_store(&lobby->running, false);
+}
+
+/**
+ * Closes every connection of a lobby, its listening socket and its epoll instance, once the AI service
+ * has answered the searches still running. The lobby's event loop must have returned.
+ *
+ * @param lobby The lobby.
+ */
+void lobbyDestroy(Lobby *lobby) {
+    while (lobby->all != NULL) {
+        closeConnection(lobby, lobby->all);
+    }
+    threadPoolWait(&lobby->ai.pool);
+    while (lobby->ai.pending > 0 || lobby->ai_backlog != NULL) {
+        collectAiMoves(lobby);
+    }
+    aiServiceDestroy(&lobby->ai);
+    freeClosedConnections(lobby);
+    close(lobby->listen_fd);
+    close(lobby->epoll_fd);
+}
+
+/**
+ * Runs a multi-game server: clients are paired with each other, or with the AI after
+ * LOBBY_PAIR_TIMEOUT_MS (at once with '-ia'), and any number of games run at the same time.
+ *
+ * @param port The port number on which the server listens.
+ * @param ai True if every client plays the AI.
+ */
+void lobbyMain(int port, bool ai) {
+    Lobby lobby;
+    if (!lobbyInit(&lobby, port, ai)) {
+        return;
+    }
+    printf("Multi-game server listening on port %d (%s)...\n", port,
+           ai ? "every client plays the AI" : "clients play each other, or the AI if left alone");
+    lobbyRun(&lobby);
+    lobbyDestroy(&lobby);
+}
@@ -0,0 +1,416 @@
+#include "../../includes/protocol.h"
+
+/**
+ * Returns the size of the payload of a message type. Every type has a fixed payload size.
+ *
+ * @param type The message type.
+ * @return The payload size in bytes, or -1 if the type is unknown.
+ */
+int protocolPayloadSize(int type) {
+    switch (type) {
+        case MSG_HELLO:
+            return 3;
+        case MSG_MOVE:
+        case MSG_GAME_OVER:
+            return 2;
+        case MSG_ACK:
+            return 4;
+        case MSG_RESIGN:
+        case MSG_PING:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * Writes a 32-bit integer in network byte order.
+ *
+ * @param p Where to write the 4 bytes.
+ * @param value The integer.
+ */
+static void putU32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t) (value >> 24);
+    p[1] = (uint8_t) (value >> 16);
+    p[2] = (uint8_t) (value >> 8);
+    p[3] = (uint8_t) value;
+}
+
+/**
+ * Reads a 32-bit integer in network byte order.
+ *
+ * @param p The 4 bytes.
+ * @return The integer.
+ */
+static uint32_t getU32(const uint8_t *p) {
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+/**
+ * Encodes a message as a frame: a 2-byte length (of what follows it), the version byte, the type byte,
+ * the 4-byte sequence number and the payload of the type. Integers are in network byte order.
+ *
+ * @param msg The message; its version field is ignored, PROTOCOL_VERSION is written.
+ * @param buffer Where to write the frame.
+ * @param size The size of the buffer.
+ * @return The size of the frame, or -1 if the type is unknown or the buffer too small.
+ */
+int protocolEncode(const Message *msg, uint8_t *buffer, size_t size) {
+    int payload = protocolPayloadSize(msg->type);
+    if (payload < 0 || size < (size_t) (PROTOCOL_HEADER_SIZE + payload)) {
+        return -1;
+    }
+    int length = PROTOCOL_HEADER_SIZE - 2 + payload;
+    buffer[0] = (uint8_t) (length >> 8);
+    buffer[1] = (uint8_t) length;
+    buffer[2] = PROTOCOL_VERSION;
+    buffer[3] = msg->type;
+    putU32(buffer + 4, msg->seq);
+
+    uint8_t *p = buffer + PROTOCOL_HEADER_SIZE;
+    switch (msg->type) {
+        case MSG_HELLO:
+            p[0] = msg->hello.seat;
+            p[1] = msg->hello.rows;
+            p[2] = msg->hello.cols;
+            break;
+        case MSG_MOVE:
+            p[0] = msg->move.row;
+            p[1] = msg->move.col;
+            break;
+        case MSG_ACK:
+            putU32(p, msg->ack.seq);
+            break;
+        case MSG_GAME_OVER:
+            p[0] = msg->over.loser;
+            p[1] = msg->over.reason;
+            break;
+        default:
+            break;
+    }
+    return PROTOCOL_HEADER_SIZE + payload;
+}
+
+/**
+ * Decodes the first frame of a byte stream. The stream may hold a partial frame (more bytes must be
+ * received first) or several frames (call again after the bytes consumed).
+ *
+ * @param buffer The bytes received.
+ * @param length The number of bytes received.
+ * @param msg Filled with the decoded message.
+ * @return The size of the frame decoded, 0 if the frame is not complete yet, or -1 if the stream is malformed
+ *         (unknown version or type, or a length that does not match the type).
+ */
+int protocolDecode(const uint8_t *buffer, size_t length, Message *msg) {
+    if (length < 4) {
+        // The version and type are checked as soon as they arrive
+        if (length >= 3 && buffer[2] != PROTOCOL_VERSION) {
+            return -1;
+        }
+        return 0;
+    }
+    int payload = protocolPayloadSize(buffer[3]);
+    int frame_length = (buffer[0] << 8) | buffer[1];
+    if (buffer[2] != PROTOCOL_VERSION || payload < 0 || frame_length != PROTOCOL_HEADER_SIZE - 2 + payload) {
+        return -1;
+    }
+    if (length < (size_t) (PROTOCOL_HEADER_SIZE + payload)) {
+        return 0;
+    }
+
+    memset(msg, 0, sizeof(Message));
+    msg->version = buffer[2];
+    msg->type = buffer[3];
+    msg->seq = getU32(buffer + 4);
+    const uint8_t *p = buffer + PROTOCOL_HEADER_SIZE;
+    switch (msg->type) {
+        case MSG_HELLO:
+            msg->hello.seat = p[0];
+            msg->hello.rows = p[1];
+            msg->hello.cols = p[2];
+            break;
+        case MSG_MOVE:
+            msg->move.row = p[0];
+            msg->move.col = p[1];
+            break;
+        case MSG_ACK:
+            msg->ack.seq = getU32(p);
+            break;
+        case MSG_GAME_OVER:
+            msg->over.loser = p[0];
+            msg->over.reason = p[1];
+            break;
+        default:
+            break;
+    }
+    return PROTOCOL_HEADER_SIZE + payload;
+}
+
+/**
+ * Returns a readable name for the reason a game ended.
+ *
+ * @param reason A GameOverReason.
+ * @return The name.
+ */
+const char *protocolReasonName(int reason) {
+    switch (reason) {
+        case OVER_A1_EATEN:
+            return "A1 eaten";
+        case OVER_RESIGNED:
+            return "resigned";
+        case OVER_ILLEGAL_MOVE:
+            return "illegal move";
+        case OVER_DISCONNECTED:
+            return "disconnected";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * Initializes a channel on a connected, blocking socket.
+ *
+ * @param channel The channel.
+ * @param fd The socket.
+ */
+void channelInit(Channel *channel, int fd) {
+    memset(channel, 0, sizeof(Channel));
+    channel->fd = fd;
+}
+
+/**
+ * Numbers a message and appends its frame to the output of a channel, without sending it: messages
+ * queued one after the other leave in a single send() with the next flush.
+ *
+ * @param channel The channel.
+ * @param msg The message; its version and sequence number are set.
+ * @return True on success, false if the type is unknown or a flush to make room failed.
+ */
+bool channelQueue(Channel *channel, Message *msg) {
+    if (channel->out_len + PROTOCOL_MAX_FRAME > sizeof(channel->out) && !channelFlush(channel)) {
+        return false;
+    }
+    msg->version = PROTOCOL_VERSION;
+    msg->seq = channel->next_seq;
+    int size = protocolEncode(msg, channel->out + channel->out_len, sizeof(channel->out) - channel->out_len);
+    if (size < 0) {
+        return false;
+    }
+    channel->next_seq++;
+    channel->out_len += size;
+    return true;
+}
+
+/**
+ * Sends the queued output of a channel.
+ *
+ * @param channel The channel.
+ * @return True if everything was sent, false if the connection failed.
+ */
+bool channelFlush(Channel *channel) {
+    size_t sent = 0;
+    while (sent < channel->out_len) {
+        ssize_t n = send(channel->fd, channel->out + sent, channel->out_len - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    channel->out_len = 0;
+    return true;
+}
+
+/**
+ * Queues a message, then sends it with the rest of the queued output.
+ *
+ * @param channel The channel.
+ * @param msg The message; its version and sequence number are set.
+ * @return True on success, false otherwise.
+ */
+bool channelSend(Channel *channel, Message *msg) {
+    return channelQueue(channel, msg) && channelFlush(channel);
+}
+
+/**
+ * Takes the first complete frame out of the input of a channel.
+ *
+ * @param channel The channel.
+ * @param msg Filled with the message.
+ * @return 1 if a message was taken, 0 if no frame is complete yet, -1 if the stream is malformed.
+ */
+static int channelTake(Channel *channel, Message *msg) {
+    int size = protocolDecode(channel->in, channel->in_len, msg);
+    if (size <= 0) {
+        return size;
+    }
+    memmove(channel->in, channel->in + size, channel->in_len - size);
+    channel->in_len -= size;
+    return 1;
+}
+
+/**
+ * Receives the bytes available on a channel, blocking until some arrive.
+ *
+ * @param channel The channel.
+ * @return True on success, false if the connection was closed or failed.
+ */
+static bool channelFill(Channel *channel) {
+    for (;;) {
+        ssize_t n = recv(channel->fd, channel->in + channel->in_len, sizeof(channel->in) - channel->in_len, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        channel->in_len += n;
+        return true;
+    }
+}
+
+/**
+ * Waits for the next message of a channel. Bytes received past the message are kept for the next call.
+ *
+ * @param channel The channel.
+ * @param msg Filled with the message.
+ * @return True on success, false if the connection was closed or the stream is malformed.
+ */
+bool channelReceive(Channel *channel, Message *msg) {
+    for (;;) {
+        int taken = channelTake(channel, msg);
+        if (taken != 0) {
+            return taken > 0;
+        }
+        if (!channelFill(channel)) {
+            return false;
+        }
+    }
+}
+
+/**
+ * Waits until another file descriptor becomes readable, such as the eventfd of the AI service, while
+ * answering the peer's pings. Acks and hellos are skipped; any other message ends the wait, since
+ * the peer has nothing else to send while it waits for our move.
+ *
+ * @param channel The channel.
+ * @param fd The file descriptor to wait for.
+ * @param msg Filled with the message that ended the wait, if any.
+ * @return 0 once fd is readable, the type of the message that ended the wait, or -1 if the connection
+ *         was closed or broken.
+ */
+int channelWaitFor(Channel *channel, int fd, Message *msg) {
+    for (;;) {
+        int taken;
+        while ((taken = channelTake(channel, msg)) > 0) {
+            if (msg->type == MSG_PING) {
+                if (!channelAck(channel, msg->seq) || !channelFlush(channel)) {
+                    return -1;
+                }
+            } else if (msg->type != MSG_ACK && msg->type != MSG_HELLO) {
+                return msg->type;
+            }
+        }
+        if (taken < 0) {
+            return -1;
+        }
+
+        struct pollfd fds[2] = {{.fd = fd, .events = POLLIN}, {.fd = channel->fd, .events = POLLIN}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (fds[0].revents & POLLIN) {
+            return 0;
+        }
+        if (fds[1].revents != 0 && !channelFill(channel)) {
+            return -1;
+        }
+    }
+}
+
+/**
+ * Sends a hello with the board size: a client asks for PROTOCOL_ANY_SEAT, the server answers with the seat.
+ *
+ * @param channel The channel.
+ * @param seat The seat, 0 to move first, 1 to move second.
+ * @return True on success, false otherwise.
+ */
+bool channelSendHello(Channel *channel, int seat) {
+    Message msg = {.type = MSG_HELLO, .hello = {(uint8_t) seat, ROWS, COLS}};
+    return channelSend(channel, &msg);
+}
+
+/**
+ * Sends a move, with any message queued before it (such as the ack of the opponent's move).
+ *
+ * @param channel The channel.
+ * @param row The row index of the move.
+ * @param col The column index of the move.
+ * @return True on success, false otherwise.
+ */
+bool channelSendMove(Channel *channel, int row, int col) {
+    Message msg = {.type = MSG_MOVE, .move = {(uint8_t) row, (uint8_t) col}};
+    return channelSend(channel, &msg);
+}
+
+/**
+ * Sends the end of a game.
+ *
+ * @param channel The channel.
+ * @param loser The seat of the loser.
+ * @param reason A GameOverReason.
+ * @return True on success, false otherwise.
+ */
+bool channelSendGameOver(Channel *channel, int loser, int reason) {
+    Message msg = {.type = MSG_GAME_OVER, .over = {(uint8_t) loser, (uint8_t) reason}};
+    return channelSend(channel, &msg);
+}
+
+/**
+ * Queues the ack of a received message. It leaves with the next message sent, or the next flush.
+ *
+ * @param channel The channel.
+ * @param seq The sequence number of the received message.
+ * @return True on success, false otherwise.
+ */
+bool channelAck(Channel *channel, uint32_t seq) {
+    Message msg = {.type = MSG_ACK, .ack = {seq}};
+    return channelQueue(channel, &msg);
+}
+
+/**
+ * Waits for the opponent's move. Acks and hellos received meanwhile are skipped and pings are answered.
+ * The caller checks the move and acks it with channelAck().
+ *
+ * @param channel The channel.
+ * @param row Set to the row index of a received move.
+ * @param col Set to the column index of a received move.
+ * @param msg Filled with the message that ended the wait.
+ * @return MSG_MOVE, MSG_RESIGN or MSG_GAME_OVER, or -1 if the connection was closed or broken.
+ */
+int channelReceiveMove(Channel *channel, int *row, int *col, Message *msg) {
+    while (channelReceive(channel, msg)) {
+        switch (msg->type) {
+            case MSG_MOVE:
+                *row = msg->move.row;
+                *col = msg->move.col;
+                return MSG_MOVE;
+            case MSG_RESIGN:
+            case MSG_GAME_OVER:
+                return msg->type;
+            case MSG_PING:
+                if (!channelAck(channel, msg->seq) || !channelFlush(channel)) {
+                    return -1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return -1;
+}
@@ -13,12 +13,15 @@
  * @param guiMode Boolean flag indicating whether the game should be played in graphical mode.
  * @param serverMode Boolean flag indicating if the server mode is active (unused here but passed to `mainGui`).
  * @param clientMode Boolean flag indicating if the client mode is active (unused here but passed to `mainGui`).
+ *
+ * The client says hello first and is told it moves first. The server acks the client's moves
+ * and tells it when the game is over. The AI searches on the AI service, so the server keeps
+ * answering the client during a long search.
  */
 void serverMain(int port, bool ai, bool guiMode, bool serverMode, bool clientMode) {
 
     // Server variables initialization
     int server_fd = 0;  // File descriptor for the server socket
-    int sock = 0;       // Unused in this function but passed to `mainGui`
 
     // Establish the server connection and accept a client
     int new_socket = initServer(port);  // Capture the new socket returned by initServer()
@@ -29,16 +32,31 @@ void serverMain(int port, bool ai, bool guiMode, bool serverMode, bool clientMod
     int row, col;                  // Row and column of the chosen square
     char col_char;                 // Column as a character (A-I)
     int player = 1;                // Player turn (1 = Client, 2 = Server)
-
-    char buffer[1024] = {0};       // Buffer for transferring data between client and server
-    int valread = 0;               // Value to check if the client has played a move
+    Channel channel;               // Frames exchanged with the client
+    Message msg;                   // Last message received from the client
+    AiService service;             // Searches the AI's moves while the server keeps answering the client
 
     // Initialize and display the game board
     initBoard(board);
+    channelInit(&channel, new_socket);
+
+    // The client says hello and moves first
+    if (!channelReceive(&channel, &msg) || msg.type != MSG_HELLO ||
+        msg.hello.rows != ROWS || msg.hello.cols != COLS || !channelSendHello(&channel, 0)) {
+        printf("The client did not say hello.\n");
+        close(new_socket);
+        return;
+    }
+    if (ai && !guiMode && !aiServiceInit(&service, 1, 1, aiHashBits())) {
+        printf("Could not start the AI service.\n");
+        close(new_socket);
+        return;
+    }
+    recordStartGame(ROWS, COLS);
 
     if (guiMode) {
         printf("Launching GUI...\n");
-        mainGui(ai, serverMode, clientMode, sock, new_socket);  // Launch GUI mode if selected
+        mainGui(ai, serverMode, clientMode, &channel);  // Launch GUI mode if selected
     }
     else {
         // Server loop - runs until the game is over
@@ -49,59 +67,47 @@ void serverMain(int port, bool ai, bool guiMode, bool serverMode, bool clientMod
                 printf("Client's turn\n");
 
                 // Wait for the client to send their move
-                read(new_socket, buffer, 1024);
-
-                // Check if the game is over
-                if (board[0][0] == 0) {
-                    printf("\nSERVER WINS!\n");
+                int type = channelReceiveMove(&channel, &row, &col, &msg);
+                if (type == MSG_RESIGN) {
+                    channelSendGameOver(&channel, 0, OVER_RESIGNED);
+                    recordEndGame(RECORD_FIRST_LOSES);
+                    printf("\nClient resigned. SERVER WINS!\n");
+                    break;
+                }
+                if (type != MSG_MOVE) {
+                    printf("The client closed the connection.\n");
                     break;
                 }
 
                 // Process the client's move
-                valread = strlen(buffer);
-
-                if (valread > 0) {
-                    // Client's move format is [Column][Row] (e.g., B3)
-                    printf("Client played: %c%c\n", buffer[0], buffer[1]);
-
-                    // Convert lowercase to uppercase if needed
-                    if (buffer[0] >= 'a' && buffer[0] <= 'i') {
-                        buffer[0] = toupper(buffer[0]);
-                    }
-
-                    // Validate move format (column between A-I, row between 1-7)
-                    if (strlen(buffer) == 2 &&
-                        buffer[0] >= 'A' && buffer[0] <= 'I' &&
-                        buffer[1] >= '1' && buffer[1] <= '7') {
-
-                        printf("Valid move from client.\n");
+                printf("Client played: %c%d\n", 'A' + col, row + 1);
 
-                        // Convert buffer value into matrix indices
-                        col = buffer[0] - 'A';  // 'A' = 0, 'I' = 8
-                        row = buffer[1] - '1';  // '1' = 0, '7' = 6
+                // Verify the move with the rules the multi-game server applies
+                if (bitboardIsLegalMove(boardToBitboard(board), row, col)) {
+                    printf("Valid move from client.\n");
 
-                        // Verify if the square can be destroyed
-                        if (canDestroy(board, row, col)) {
-                            // Destroy the square
-                            destroySquaresConsole(board, row, col, false);
+                    // Destroy the square, the ack leaves with the server's next message
+                    destroySquaresConsole(board, row, col, false);
+                    recordMove(row, col);
+                    channelAck(&channel, msg.seq);
 
-                            // Display the updated board
-                            displayBoard(board);
+                    // Display the updated board
+                    displayBoard(board);
 
-                            // End of client's turn, switch to server's turn
-                            player = 2;
+                    // End of client's turn, switch to server's turn
+                    player = 2;
 
-                            // Check if the game is over
-                            if (board[0][0] == 0) {
-                                printf("\nSERVER WINS!\n");
-                                break;
-                            }
-
-                            // Clear the buffer for the next turn
-                            memset(buffer, 0, sizeof(buffer));
-                            printf("Buffer cleared.\n");
-                        }
+                    // Check if the game is over
+                    if (board[0][0] == 0) {
+                        channelSendGameOver(&channel, 0, OVER_A1_EATEN);
+                        printf("\nSERVER WINS!\n");
+                        break;
                     }
+                } else {
+                    channelSendGameOver(&channel, 0, OVER_ILLEGAL_MOVE);
+                    recordEndGame(RECORD_FIRST_LOSES);
+                    printf("\nThe client played an invalid move. SERVER WINS!\n");
+                    break;
                 }
             }
 
@@ -120,50 +126,66 @@ void serverMain(int port, bool ai, bool guiMode, bool serverMode, bool clientMod
                     // Convert user's input into matrix indices
                     col = toupper(col_char) - 'A';  // Convert 'A' -> 0, 'B' -> 1, etc.
                     row -= 1;  // Adjust the row index to start from 0
-
-                    // Transfer the move data to the client via buffer
-                    buffer[0] = toupper(col_char);  // Store column letter as is
-                    buffer[1] = (row + 1) + '0';    // Convert row number to character
                 } else {
                     printf("AI is choosing a move...\n");
 
-                    // AI selects a move
-                    aiChooseMove(board, &row, &col);
+                    // AI selects a move on the AI service; pings from the client are answered meanwhile
+                    AiResult result;
+                    aiServiceSubmit(&service, boardToBitboard(board), aiTimeBudget(), NULL);
+                    int type = channelWaitFor(&channel, aiServiceFd(&service), &msg);
+                    if (type == MSG_RESIGN) {
+                        channelSendGameOver(&channel, 0, OVER_RESIGNED);
+                        recordEndGame(RECORD_FIRST_LOSES);
+                        printf("\nClient resigned. SERVER WINS!\n");
+                        break;
+                    }
+                    if (type == MSG_MOVE) {
+                        channelSendGameOver(&channel, 0, OVER_ILLEGAL_MOVE);
+                        recordEndGame(RECORD_FIRST_LOSES);
+                        printf("\nThe client played out of turn. SERVER WINS!\n");
+                        break;
+                    }
+                    if (type != 0) {
+                        printf("The client closed the connection.\n");
+                        break;
+                    }
+                    aiServiceCollect(&service, &result, 1);
+                    aiReportStats(&result.stats);
+                    row = result.row;
+                    col = result.col;
                     printf("AI chose col = %d and row = %d\n", col, row);
-
-                    // Format the move for the client
-                    buffer[0] = col + 'A';  // Convert 0 -> 'A', 1 -> 'B', etc.
-                    buffer[1] = row + '1';  // Convert 0 -> '1', 1 -> '2', etc.
                 }
 
-                // Validate the move format before sending it to the client
-                if (strlen(buffer) == 2 &&
-                    buffer[0] >= 'A' && buffer[0] <= 'I' &&
-                    buffer[1] >= '1' && buffer[1] <= '7') {
+                // Validate the move before sending it to the client
+                if (row >= 0 && row < ROWS && col >= 0 && col < COLS) {
 
-                    // Verify if the square can be destroyed
-                    if (canDestroy(board, row, col)) {
-                        // Destroy the square
+                    // Verify the move with the check the client applies to it, then destroy the squares
+                    if (bitboardIsLegalMove(boardToBitboard(board), row, col)) {
                         destroySquaresConsole(board, row, col, false);
+                        recordMove(row, col);
                         printf("Valid move. Sending to client...\n");
 
                         // Display the updated board
                         displayBoard(board);
 
-                        // Send the move to the client
-                        send(new_socket, buffer, strlen(buffer), 0);
+                        // Send the move to the client, with the ack of the client's last move
+                        if (!channelSendMove(&channel, row, col)) {
+                            printf("The client closed the connection.\n");
+                            break;
+                        }
 
                         // End of server's turn, switch to client's turn
                         player = 1;
 
                         // Check if the game is over
                         if (board[0][0] == 0) {
+                            channelSendGameOver(&channel, 1, OVER_A1_EATEN);
                             printf("\nCLIENT WINS!\n");
                             break;
                         }
                     } else {
-                        // Invalid move (square already destroyed)
-                        printf("Invalid move. Square already destroyed. Try again.\n");
+                        // Invalid move (square already destroyed, or too many squares)
+                        printf("Invalid move. Try again.\n");
                         continue;
                     }
 
@@ -177,6 +199,9 @@ void serverMain(int port, bool ai, bool guiMode, bool serverMode, bool clientMod
     }
 
     // Close the sockets at the end of the game
+    if (ai && !guiMode) {
+        aiServiceDestroy(&service);
+    }
     close(new_socket);
     close(server_fd);
 }
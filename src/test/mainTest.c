@@ -12,12 +12,92 @@ int main() {
     testEvaluateBoard();
     testMinimax();
     testAiChooseMove();
+    testAiChooseMoveTimed();
+    testParallelRootSearch();
+    testYbwcSearch();
+    testMoveOrdering();
+    testSeededSearch();
+    testSearchStats();
 
 //  GameLogic Test
     testCanDestroy();
     testCountSquares();
     testDestroySquaresConsole();
 
+//  Bitboard Test
+    testBoardToBitboard();
+    testBitboardCountSquares();
+    testBitboardDestroySquares();
+    testBitboardLegalMoves();
+
+//  Move Generator Test
+    testMoveGenLegalMoves();
+    testMoveGenMakeUnmake();
+    testPositionUndoStack();
+
+//  Random Generator Test
+    testRngSeed();
+    testRngBelow();
+
+//  Transposition Table Test
+    testZobristHash();
+    testTranspositionStoreProbe();
+    testTranspositionAging();
+    testTranspositionConcurrent();
+    testMinimaxWithTable();
+
+//  Staircase Test
+    testStaircaseRank();
+    testStaircaseBoardConversion();
+    testStaircaseDestroySquares();
+    testStaircaseLegalMoves();
+
+//  Solver Test
+    testSolveChomp();
+    testSolutionBestMove();
+    testSaveLoadSolution();
+
+//  Book Test
+    testBookPositions();
+    testSaveLoadBook();
+
+//  Batch Test
+    testBatchEvaluate();
+
+//  Game Record Test
+    testGameRecordRoundTrip();
+    testReplaySeek();
+
+//  Position Index Test
+    testPositionIndexBuild();
+    testSortMovesByPrior();
+
+//  Evaluator Test
+    testEvaluatorByName();
+    testWinLossMateDistance();
+    testStaircaseEndgames();
+
+//  Sized Board Test
+    testSizedBoardInit();
+    testSizedBoardDestroySquares();
+    testSizedBoardLegalMoves();
+    testSizedBoardSearch();
+
+//  AI Service Test
+    testAiServiceMoves();
+    testAiServiceBoundedQueue();
+    testAiServiceStats();
+
+//  Protocol Test
+    testProtocolRoundTrip();
+    testProtocolPartialFrames();
+    testProtocolRejectsMalformed();
+    testChannelBatching();
+
+//  Lobby Test
+    testLobbyPairsClients();
+    testLobbyAiOpponent();
+
     printf("All tests passed!\n");
     return 0;
 }
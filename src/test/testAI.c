@@ -70,3 +70,220 @@ void testAiChooseMove() {
 
     ASSERT_TRUE(best_row >= 0 && best_col >= 0);
 }
+
+void testAiChooseMoveTimed() {
+    printf("===== testAiChooseMoveTimed =====\n");
+    int board[ROWS][COLS];
+    initBoard(board);
+
+    int best_row, best_col;
+    aiChooseMoveTimed(board, 50, &best_row, &best_col);
+    ASSERT_TRUE(canDestroy(board, best_row, best_col));
+    ASSERT_TRUE(countSquares(board, best_row, best_col) <= MOVE_LIMIT);
+
+    SearchContext ctx;
+    int moves[2][2] = {{6, 8}, {6, 7}};
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    ASSERT_EQ(3, iterativeDeepening(&ctx, boardToBitboard(board), moves, 2, 3));
+}
+
+void testParallelRootSearch() {
+    printf("===== testParallelRootSearch =====\n");
+    Bitboard board = BB_FULL & ~bitboardQuadrant(5, 5) & ~bitboardQuadrant(3, 8);
+    int sequential[ROWS * COLS][2];
+    int parallel[ROWS * COLS][2];
+    int num_moves = 0;
+
+    Bitboard legal = bitboardLegalMoves(board);
+    while (legal) {
+        int cell = __builtin_ctzll(legal);
+        legal &= legal - 1;
+        sequential[num_moves][0] = parallel[num_moves][0] = cell / COLS;
+        sequential[num_moves][1] = parallel[num_moves][1] = cell % COLS;
+        num_moves++;
+    }
+
+    SearchContext ctx;
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    iterativeDeepening(&ctx, board, sequential, num_moves, 6);
+
+    ASSERT_TRUE(aiSetThreads(4));
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    iterativeDeepening(&ctx, board, parallel, num_moves, 6);
+    aiSetThreads(1);
+
+    // Same move whatever the number of threads
+    ASSERT_EQ(sequential[0][0], parallel[0][0]);
+    ASSERT_EQ(sequential[0][1], parallel[0][1]);
+
+    // The evaluator of the context, not the AI's, applies on every thread
+    memcpy(parallel, sequential, sizeof(parallel));
+    ttClear(aiTranspositionTable());
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    ctx.evaluator = evaluatorByName("material");
+    iterativeDeepening(&ctx, board, sequential, num_moves, 4);
+    int sequential_score = ctx.score;
+
+    ASSERT_TRUE(aiSetThreads(4));
+    ttClear(aiTranspositionTable());
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    ctx.evaluator = evaluatorByName("material");
+    iterativeDeepening(&ctx, board, parallel, num_moves, 4);
+    aiSetThreads(1);
+    ttClear(aiTranspositionTable());
+    ASSERT_EQ(sequential_score, ctx.score);
+}
+
+/**
+ * Test for the work-stealing search (Young Brothers Wait)
+ * Verifies that it returns the score of the sequential Minimax and makes the same root choice.
+ */
+void testYbwcSearch() {
+    printf("===== testYbwcSearch =====\n");
+    Bitboard board = BB_FULL & ~bitboardQuadrant(5, 5) & ~bitboardQuadrant(3, 8);
+    YbwcSearch search;
+
+    ASSERT_TRUE(ybwcInit(&search, 4, 16));
+    for (int depth = 1; depth <= 7; depth++) {
+        ASSERT_EQ(minimaxBitboard(board, depth, true, -INF, INF), ybwcMinimax(&search, board, depth, true, -INF, INF));
+    }
+    ybwcDestroy(&search);
+
+    int sequential[ROWS * COLS][2];
+    int parallel[ROWS * COLS][2];
+    int num_moves = 0;
+    Bitboard legal = bitboardLegalMoves(board);
+    while (legal) {
+        int cell = __builtin_ctzll(legal);
+        legal &= legal - 1;
+        sequential[num_moves][0] = parallel[num_moves][0] = cell / COLS;
+        sequential[num_moves][1] = parallel[num_moves][1] = cell % COLS;
+        num_moves++;
+    }
+
+    SearchContext ctx;
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    iterativeDeepening(&ctx, board, sequential, num_moves, 6);
+
+    ASSERT_TRUE(aiSetYbwcThreads(4));
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    iterativeDeepening(&ctx, board, parallel, num_moves, 6);
+    aiSetYbwcThreads(1);
+
+    ASSERT_EQ(sequential[0][0], parallel[0][0]);
+    ASSERT_EQ(sequential[0][1], parallel[0][1]);
+}
+
+/**
+ * Test for the move ordering statistics
+ * Verifies that cutoffs are counted, that killer moves are recorded, and that the ordering heuristics
+ * learned in one search do not change the score of the next one.
+ */
+void testMoveOrdering() {
+    printf("===== testMoveOrdering =====\n");
+    Bitboard board = BB_FULL & ~bitboardQuadrant(5, 5) & ~bitboardQuadrant(3, 8);
+    SearchContext ctx;
+
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    ASSERT_EQ(0, (int) ctx.cutoffs);
+    ASSERT_EQ(-1, ctx.killers[1][0]);
+
+    ttClear(ctx.table);
+    int first = minimaxContext(&ctx, board, 6, true, -INF, INF);
+    ASSERT_TRUE(ctx.cutoffs > 0);
+    ASSERT_TRUE(ctx.first_cutoffs <= ctx.cutoffs);
+    ASSERT_TRUE(ctx.killers[1][0] >= 0);
+    ASSERT_TRUE(searchFirstCutoffRate(&ctx) > 0.5);
+
+    // Same score with the killers and the history of the first search
+    ttClear(ctx.table);
+    ASSERT_EQ(first, minimaxContext(&ctx, board, 6, true, -INF, INF));
+}
+
+/**
+ * Test for the seeded search used by the self-play runner
+ * Verifies that the same seed shuffles the moves the same way, and that two searches with the same seed
+ * and depth choose the same move.
+ */
+void testSeededSearch() {
+    printf("===== testSeededSearch =====\n");
+    int first[ROWS * COLS][2], second[ROWS * COLS][2];
+    Rng rng_a, rng_b;
+    rngSeed(&rng_a, 42);
+    rngSeed(&rng_b, 42);
+    for (int i = 0; i < ROWS * COLS; i++) {
+        first[i][0] = second[i][0] = i / COLS;
+        first[i][1] = second[i][1] = i % COLS;
+    }
+    shuffleMovesSeeded(first, ROWS * COLS, &rng_a);
+    shuffleMovesSeeded(second, ROWS * COLS, &rng_b);
+    ASSERT_TRUE(memcmp(first, second, sizeof(first)) == 0);
+    ASSERT_TRUE(memcmp(&rng_a, &rng_b, sizeof(Rng)) == 0);
+
+    // The AI's own generator replays the same shuffle after being seeded again
+    memcpy(second, first, sizeof(first));
+    aiSetSeed(5);
+    shuffleMoves(first, ROWS * COLS);
+    aiSetSeed(5);
+    shuffleMoves(second, ROWS * COLS);
+    ASSERT_TRUE(memcmp(first, second, sizeof(first)) == 0);
+    ASSERT_TRUE(aiSeed() == 5);
+    aiSetSeed(AI_DEFAULT_SEED);
+
+    int rows[2], cols[2];
+    for (int run = 0; run < 2; run++) {
+        Rng rng;
+        rngSeed(&rng, 7);
+        SearchContext ctx;
+        initSearchContext(&ctx, aiTranspositionTable(), 0);
+        ttClear(ctx.table);
+        ctx.root_threads = false;
+        ctx.max_depth = 3;
+        ctx.rng = &rng;
+        aiSearchMove(&ctx, BB_FULL, &rows[run], &cols[run]);
+    }
+    ASSERT_EQ(rows[0], rows[1]);
+    ASSERT_EQ(cols[0], cols[1]);
+    ASSERT_TRUE(rows[0] != 0 || cols[0] != 0);
+}
+
+void testSearchStats() {
+    printf("===== testSearchStats =====\n");
+    SearchContext ctx;
+    SearchStats stats;
+    int row, col;
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    ttClear(ctx.table);
+    ctx.root_threads = false;
+    ctx.max_depth = 4;
+    int depth = aiSearchMove(&ctx, BB_FULL, &row, &col);
+    searchStatsFill(&ctx, depth, row, col, &stats);
+
+    ASSERT_TRUE(strcmp(stats.source, "search") == 0);
+    ASSERT_EQ(4, stats.depth);
+    ASSERT_EQ(4, stats.max_ply);
+    ASSERT_TRUE(stats.leaves > 0 && stats.leaves < stats.nodes);
+    ASSERT_TRUE(stats.tt_hits > 0 && stats.tt_hits <= stats.tt_probes);
+    ASSERT_TRUE(stats.branching > 1.0);
+    uint64_t cutoffs = 0;
+    for (int i = 0; i < ROWS * COLS; i++) {
+        cutoffs += stats.ply_cutoffs[i];
+    }
+    ASSERT_TRUE(cutoffs == stats.cutoffs);
+
+    // A single legal move is played without searching
+    Bitboard forced = BB_CELL(0, 0) | BB_CELL(0, 1);
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    depth = aiSearchMove(&ctx, forced, &row, &col);
+    searchStatsFill(&ctx, depth, row, col, &stats);
+    ASSERT_TRUE(strcmp(stats.source, "forced") == 0);
+    ASSERT_TRUE(stats.nodes == 0);
+
+    char line[1024];
+    FILE *file = tmpfile();
+    searchStatsPrintJson(&stats, file);
+    rewind(file);
+    ASSERT_TRUE(fgets(line, sizeof(line), file) != NULL);
+    fclose(file);
+    ASSERT_TRUE(strstr(line, "{\"move\": \"B1\", \"source\": \"forced\"") == line);
+}
@@ -0,0 +1,103 @@
+#include "../../includes/testAiService.h"
+
+// Waits until the service's eventfd is readable, at most timeout_ms
+static bool waitReadable(AiService *service, int timeout_ms) {
+    struct pollfd pfd = {.fd = aiServiceFd(service), .events = POLLIN};
+    return poll(&pfd, 1, timeout_ms) == 1;
+}
+
+void testAiServiceMoves() {
+    printf("===== testAiServiceMoves =====\n");
+    AiService service;
+    Bitboard boards[3] = {BB_FULL, BB_FULL & ~bitboardQuadrant(2, 3), BB_CELL(0, 0) | BB_CELL(0, 1)};
+    int tags[3] = {0, 1, 2};
+    bool answered[3] = {false, false, false};
+
+    ASSERT_TRUE(aiServiceInit(&service, 2, 8, TT_DEFAULT_BITS));
+
+    // The two threads share the memory of one table of the requested size
+    ASSERT_TRUE(service.tables[0].mask + 1 == ((uint64_t) 1 << (TT_DEFAULT_BITS - 1)) / TT_BUCKET_SLOTS);
+    ASSERT_TRUE(service.tables[1].mask == service.tables[0].mask);
+    ASSERT_FALSE(waitReadable(&service, 0));
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(aiServiceSubmit(&service, boards[i], 0, &tags[i]));
+    }
+
+    // Every request comes back once, with a legal move of its own position
+    int collected = 0;
+    while (collected < 3 && waitReadable(&service, 10000)) {
+        AiResult results[3];
+        int n = aiServiceCollect(&service, results, 3);
+        for (int i = 0; i < n; i++) {
+            int tag = *(int *) results[i].tag;
+            ASSERT_FALSE(answered[tag]);
+            answered[tag] = true;
+            ASSERT_TRUE((bitboardLegalMoves(boards[tag]) & BB_CELL(results[i].row, results[i].col)) != 0);
+        }
+        collected += n;
+    }
+    ASSERT_EQ(3, collected);
+    ASSERT_EQ(0, service.pending);
+    aiServiceDestroy(&service);
+}
+
+void testAiServiceBoundedQueue() {
+    printf("===== testAiServiceBoundedQueue =====\n");
+    AiService service;
+    int tag = 0;
+
+    ASSERT_TRUE(aiServiceInit(&service, 1, 2, TT_DEFAULT_BITS));
+    ASSERT_TRUE(service.tables[0].mask + 1 == ((uint64_t) 1 << TT_DEFAULT_BITS) / TT_BUCKET_SLOTS);
+    ASSERT_TRUE(aiServiceSubmit(&service, BB_FULL, 0, &tag));
+    ASSERT_TRUE(aiServiceSubmit(&service, BB_FULL, 0, &tag));
+
+    // A full queue refuses requests instead of blocking the caller
+    ASSERT_FALSE(aiServiceSubmit(&service, BB_FULL, 0, &tag));
+
+    // Collecting one result at a time keeps the eventfd readable while results are left
+    AiResult result;
+    int collected = 0;
+    while (collected < 2 && waitReadable(&service, 10000)) {
+        collected += aiServiceCollect(&service, &result, 1);
+    }
+    ASSERT_EQ(2, collected);
+    ASSERT_TRUE(aiServiceSubmit(&service, BB_FULL, 0, &tag));
+    aiServiceDestroy(&service);
+}
+
+void testAiServiceStats() {
+    printf("===== testAiServiceStats =====\n");
+    AiService service;
+    Bitboard boards[2] = {BB_FULL & ~bitboardQuadrant(2, 3), BB_CELL(0, 0) | BB_CELL(0, 1)};
+    int tags[2] = {0, 1};
+
+    ASSERT_TRUE(aiServiceInit(&service, 1, 2, TT_DEFAULT_BITS));
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TRUE(aiServiceSubmit(&service, boards[i], 0, &tags[i]));
+    }
+
+    // Each result carries the statistics of its own search, ready for aiReportStats()
+    int collected = 0;
+    while (collected < 2 && waitReadable(&service, 10000)) {
+        AiResult result;
+        if (aiServiceCollect(&service, &result, 1) == 0) {
+            continue;
+        }
+        collected++;
+        ASSERT_EQ(result.row, result.stats.row);
+        ASSERT_EQ(result.col, result.stats.col);
+        aiReportStats(&result.stats);
+        ASSERT_TRUE(result.stats.nodes == aiLastStats()->nodes);
+        if (*(int *) result.tag == 0) {
+            ASSERT_TRUE(strcmp(result.stats.source, "search") == 0);
+            ASSERT_TRUE(result.stats.depth > 0);
+            ASSERT_TRUE(result.stats.nodes > 0);
+            ASSERT_TRUE(result.stats.tt_probes > 0);
+        } else {
+            ASSERT_TRUE(strcmp(result.stats.source, "forced") == 0);
+            ASSERT_EQ(0, result.stats.depth);
+        }
+    }
+    ASSERT_EQ(2, collected);
+    aiServiceDestroy(&service);
+}
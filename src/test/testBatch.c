@@ -0,0 +1,41 @@
+#include "../../includes/testBatch.h"
+
+void testBatchEvaluate() {
+    printf("===== testBatchEvaluate =====\n");
+    Bitboard boards[] = {BB_FULL, BB_FULL & ~bitboardQuadrant(4, 5), BB_FULL & ~bitboardQuadrant(2, 7),
+                         BB_CELL(0, 0) | BB_CELL(0, 1), BB_CELL(0, 0)};
+    int count = (int) (sizeof(boards) / sizeof(boards[0]));
+    BatchPosition single[count], parallel[count];
+    for (int i = 0; i < count; i++) {
+        single[i] = (BatchPosition) {.board = boards[i]};
+        parallel[i] = (BatchPosition) {.board = boards[i]};
+    }
+
+    // The results do not depend on the number of threads
+    BatchEvaluator batch;
+    BatchOptions options = {1, 4, 0, NULL, 3};
+    ASSERT_TRUE(batchInit(&batch, &options));
+    batchEvaluate(&batch, single, count);
+    batchDestroy(&batch);
+    options.num_threads = 3;
+    ASSERT_TRUE(batchInit(&batch, &options));
+    batchEvaluate(&batch, parallel, count);
+    batchDestroy(&batch);
+
+    int mismatches = 0;
+    for (int i = 0; i < count; i++) {
+        if (single[i].row != parallel[i].row || single[i].col != parallel[i].col ||
+            single[i].score != parallel[i].score || single[i].nodes != parallel[i].nodes) {
+            mismatches++;
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+
+    ASSERT_EQ(4, single[0].depth);
+    ASSERT_TRUE(single[0].nodes > 0);
+    ASSERT_TRUE((bitboardLegalMoves(boards[1]) & BB_CELL(single[1].row, single[1].col)) != 0);
+    ASSERT_EQ(0, single[3].row);
+    ASSERT_EQ(1, single[3].col);
+    ASSERT_EQ(0, single[4].row);
+    ASSERT_EQ(0, single[4].col);
+}
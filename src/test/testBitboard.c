@@ -0,0 +1,80 @@
+#include "../../includes/testBitboard.h"
+
+void testBoardToBitboard() {
+    printf("===== testBoardToBitboard =====\n");
+    int board[ROWS][COLS];
+    int copy[ROWS][COLS];
+
+    initBoard(board);
+    Bitboard bb = boardToBitboard(board);
+    ASSERT_TRUE(bb == BB_FULL);
+    ASSERT_EQ(ROWS * COLS, bitboardCount(bb));
+
+    board[6][8] = 0;
+    board[6][7] = 0;
+    bb = boardToBitboard(board);
+    bitboardToBoard(bb, copy);
+    ASSERT_EQ(0, memcmp(board, copy, sizeof(board)));
+}
+
+void testBitboardCountSquares() {
+    printf("===== testBitboardCountSquares =====\n");
+    int board[ROWS][COLS] = {
+        {1, 1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 1, 1, 1, 1, 1, 1, 0, 0},
+        {1, 1, 1, 1, 1, 0, 0, 0, 0},
+        {1, 1, 1, 1, 0, 0, 0, 0, 0},
+        {1, 1, 0, 0, 0, 0, 0, 0, 0},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0}
+    };
+    Bitboard bb = boardToBitboard(board);
+    int mismatches = 0;
+
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            if (bitboardCountSquares(bb, i, j) != countSquares(board, i, j)) {
+                mismatches++;
+            }
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+    ASSERT_EQ(ROWS * COLS, bitboardCountSquares(BB_FULL, 0, 0));
+    ASSERT_EQ(1, bitboardCountSquares(BB_FULL, ROWS - 1, COLS - 1));
+}
+
+void testBitboardDestroySquares() {
+    printf("===== testBitboardDestroySquares =====\n");
+    Bitboard bb = BB_FULL;
+
+    ASSERT_FALSE(bitboardDestroySquares(&bb, 0, 0));
+    ASSERT_TRUE(bb == BB_FULL);
+
+    ASSERT_TRUE(bitboardDestroySquares(&bb, 5, 7));
+    ASSERT_EQ(ROWS * COLS - 4, bitboardCount(bb));
+    ASSERT_FALSE(bitboardCanDestroy(bb, 6, 8));
+    ASSERT_TRUE(bitboardCanDestroy(bb, 4, 8));
+    ASSERT_FALSE(bitboardCanDestroy(bb, ROWS, 0));
+
+    // A move received from the network: present, on the board and within the limit of squares
+    ASSERT_TRUE(bitboardIsLegalMove(bb, 4, 8));
+    ASSERT_FALSE(bitboardIsLegalMove(bb, 6, 8));
+    ASSERT_FALSE(bitboardIsLegalMove(bb, 4, 0));
+    ASSERT_FALSE(bitboardIsLegalMove(bb, -1, 0));
+    ASSERT_FALSE(bitboardIsLegalMove(bb, 0, COLS));
+}
+
+void testBitboardLegalMoves() {
+    printf("===== testBitboardLegalMoves =====\n");
+    Bitboard legal = bitboardLegalMoves(BB_FULL);
+
+    // On the full board only the bottom-right corner moves stay within the limit
+    ASSERT_TRUE((legal & BB_CELL(6, 8)) != 0);
+    ASSERT_TRUE((legal & BB_CELL(6, 4)) != 0);
+    ASSERT_TRUE((legal & BB_CELL(5, 7)) != 0);
+    ASSERT_FALSE((legal & BB_CELL(6, 3)) != 0);
+    ASSERT_FALSE((legal & BB_CELL(0, 0)) != 0);
+    ASSERT_TRUE((legal & BB_CELL(2, 8)) != 0);
+    ASSERT_FALSE((legal & BB_CELL(1, 8)) != 0);
+    ASSERT_EQ(10, bitboardCount(legal));
+}
@@ -0,0 +1,66 @@
+#include "../../includes/testBook.h"
+
+void testBookPositions() {
+    printf("===== testBookPositions =====\n");
+    Bitboard *positions;
+
+    ASSERT_EQ(1, bookPositions(1, &positions));
+    ASSERT_TRUE(positions[0] == BB_FULL);
+    free(positions);
+
+    // The start and one child per legal move, A1 excepted
+    int num_moves = bitboardCount(bitboardLegalMoves(BB_FULL) & ~BB_CELL(0, 0));
+    ASSERT_EQ(1 + num_moves, bookPositions(2, &positions));
+    free(positions);
+
+    // Positions reached by several move orders are listed once, in rank order
+    int count = bookPositions(4, &positions);
+    int unsorted = 0;
+    for (int i = 1; i < count; i++) {
+        if (staircaseRank(staircaseFromBitboard(positions[i - 1])) >= staircaseRank(staircaseFromBitboard(positions[i]))) {
+            unsorted++;
+        }
+    }
+    ASSERT_EQ(0, unsorted);
+    ASSERT_TRUE(count < 1 + num_moves * num_moves * num_moves);
+    free(positions);
+}
+
+void testSaveLoadBook() {
+    printf("===== testSaveLoadBook =====\n");
+    const char *path = "tests/test.book";
+    Bitboard child = BB_FULL & ~BB_CELL(ROWS - 1, COLS - 1);
+    uint32_t full = staircaseRank(staircaseFromBitboard(BB_FULL));
+    uint32_t rank = staircaseRank(staircaseFromBitboard(child));
+    BookEntry entries[] = {
+        {full, 10, BB_INDEX(ROWS - 1, COLS - 2), 0},
+        {full, 10, BB_INDEX(ROWS - 1, COLS - 1), 0},
+        {rank, -20, BB_INDEX(ROWS - 2, COLS - 1), 0},
+        {rank, 30, BB_INDEX(ROWS - 1, COLS - 2), 0},
+    };
+    OpeningBook book;
+    const BookEntry *first;
+    int row, col;
+
+    qsort(entries, 4, sizeof(BookEntry), compareBookEntries);
+    ASSERT_TRUE(saveBook(entries, 4, 2, 8, path));
+    ASSERT_TRUE(loadBook(&book, path));
+    ASSERT_EQ(4, (int) book.count);
+
+    ASSERT_EQ(2, bookLookup(&book, child, &first));
+    ASSERT_EQ(0, bookLookup(&book, child & ~BB_CELL(ROWS - 2, COLS - 1), &first));
+
+    // Best score first, then the first move in row-major order
+    ASSERT_TRUE(bookBestMove(&book, child, &row, &col));
+    ASSERT_EQ(ROWS - 1, row);
+    ASSERT_EQ(COLS - 2, col);
+    ASSERT_TRUE(bookBestMove(&book, BB_FULL, &row, &col));
+    ASSERT_EQ(COLS - 2, col);
+    freeBook(&book);
+    ASSERT_FALSE(bookBestMove(&book, BB_FULL, &row, &col));
+
+    // A truncated book is rejected
+    ASSERT_EQ(0, truncate(path, (off_t) (sizeof(BookHeader) + 3 * sizeof(BookEntry) + 1)));
+    ASSERT_FALSE(loadBook(&book, path));
+    remove(path);
+}
@@ -0,0 +1,64 @@
+#include "../../includes/testEvaluator.h"
+
+void testEvaluatorByName() {
+    printf("===== testEvaluatorByName =====\n");
+    ASSERT_TRUE(evaluatorByName("material") != NULL);
+    ASSERT_TRUE(evaluatorByName("winloss") != NULL);
+    ASSERT_TRUE(evaluatorByName("staircase") != NULL);
+    ASSERT_TRUE(evaluatorByName("unknown") == NULL);
+    ASSERT_TRUE(evaluatorAt(3) == NULL);
+
+    bool terminal;
+    ASSERT_EQ(8, evaluatorByName("material")->evaluate(BB_FULL & ~bitboardQuadrant(0, 5) & ~bitboardQuadrant(1, 3)
+                                                        & ~bitboardQuadrant(2, 0), true, 0, &terminal));
+    ASSERT_FALSE(terminal);
+
+    ASSERT_FALSE(aiSetEvaluator("unknown"));
+    ASSERT_TRUE(aiSetEvaluator("material"));
+    ASSERT_TRUE(aiEvaluator() == evaluatorByName("material"));
+    ASSERT_TRUE(aiSetEvaluator(EVAL_DEFAULT));
+}
+
+void testWinLossMateDistance() {
+    printf("===== testWinLossMateDistance =====\n");
+    const Evaluator *winloss = evaluatorByName("winloss");
+    bool terminal;
+
+    // The player to move on an empty board has won
+    ASSERT_EQ(EVAL_WIN - 3, winloss->evaluate(0, true, 3, &terminal));
+    ASSERT_TRUE(terminal);
+    ASSERT_EQ(3 - EVAL_WIN, winloss->evaluate(0, false, 3, &terminal));
+    ASSERT_EQ(0, winloss->evaluate(BB_FULL, true, 3, &terminal));
+    ASSERT_FALSE(terminal);
+
+    // Table scores do not depend on the ply the position was reached at
+    ASSERT_EQ(EVAL_WIN - 2, evalScoreToTable(EVAL_WIN - 5, 3));
+    ASSERT_EQ(EVAL_WIN - 7, evalScoreFromTable(evalScoreToTable(EVAL_WIN - 5, 3), 5));
+    ASSERT_EQ(12, evalScoreFromTable(evalScoreToTable(12, 3), 5));
+
+    // A1 and B1 left: taking B1 wins in two plies, taking A1 loses at once
+    aiSetEvaluator("winloss");
+    ASSERT_EQ(EVAL_WIN - 2, minimaxBitboard(BB_CELL(0, 0) | BB_CELL(0, 1), 4, true, -INF, INF));
+    aiSetEvaluator(EVAL_DEFAULT);
+}
+
+void testStaircaseEndgames() {
+    printf("===== testStaircaseEndgames =====\n");
+    const Evaluator *staircase = evaluatorByName("staircase");
+    SolutionTable table;
+    bool terminal, win;
+    int distance;
+
+    ASSERT_TRUE(solveChomp(&table));
+
+    // Every L-shaped position is scored with its exact outcome
+    for (int row_arm = 0; row_arm < COLS; row_arm++) {
+        for (int col_arm = 0; col_arm < ROWS; col_arm++) {
+            Bitboard board = (BB_FULL & ~bitboardQuadrant(0, row_arm + 1) & ~bitboardQuadrant(1, 0))
+                             | (BB_FULL & ~bitboardQuadrant(col_arm + 1, 0) & ~bitboardQuadrant(0, 1));
+            lookupSolution(&table, board, &win, &distance);
+            ASSERT_EQ(win ? EVAL_KNOWN : -EVAL_KNOWN, staircase->evaluate(board, true, 0, &terminal));
+        }
+    }
+    freeSolution(&table);
+}
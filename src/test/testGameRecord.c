@@ -0,0 +1,108 @@
+#include "../../includes/testGameRecord.h"
+
+void testGameRecordRoundTrip() {
+    printf("===== testGameRecordRoundTrip =====\n");
+    const char *path = "tests/test.chgr";
+    remove(path);
+
+    // A finished game through the single-game API, then a lobby game and a game cut short
+    ASSERT_TRUE(recordOpen(path));
+    recordStartGame(ROWS, COLS);
+    recordMove(3, 4);
+    recordMove(0, 1);
+    recordMove(1, 0);
+    recordMove(0, 0);
+    recordMove(0, 0);
+    GameRecord record;
+    gameRecordInit(&record, 10, 12);
+    ASSERT_TRUE(gameRecordAddMove(&record, 9, 11));
+    ASSERT_FALSE(gameRecordAddMove(&record, 10, 0));
+    ASSERT_TRUE(recordAppend(&record, RECORD_SECOND_LOSES));
+    recordStartGame(ROWS, COLS);
+    recordMove(6, 8);
+    recordClose();
+
+    // Appending to the file keeps its games
+    ASSERT_TRUE(recordOpen(path));
+    gameRecordInit(&record, 2, 2);
+    ASSERT_TRUE(recordAppend(&record, RECORD_UNFINISHED));
+    recordClose();
+
+    RecordFile file;
+    RecordGame game;
+    ASSERT_TRUE(loadRecords(&file, path));
+    ASSERT_EQ(4, (int) file.count);
+    ASSERT_TRUE(recordGameAt(&file, 0, &game));
+    ASSERT_EQ(ROWS, game.rows);
+    ASSERT_EQ(COLS, game.cols);
+    ASSERT_EQ(4, game.num_moves);
+    ASSERT_EQ(RECORD_SECOND_LOSES, game.loser);
+    ASSERT_EQ(3 * COLS + 4, (int) game.moves[0]);
+    ASSERT_EQ(0, (int) game.moves[3]);
+    ASSERT_TRUE(recordGameAt(&file, 1, &game));
+    ASSERT_EQ(10, game.rows);
+    ASSERT_EQ(1, game.num_moves);
+    ASSERT_EQ(119, (int) game.moves[0]);
+    ASSERT_TRUE(recordGameAt(&file, 2, &game));
+    ASSERT_EQ(RECORD_UNFINISHED, game.loser);
+    ASSERT_EQ(1, game.num_moves);
+    ASSERT_TRUE(recordGameAt(&file, 3, &game));
+    ASSERT_EQ(0, game.num_moves);
+    ASSERT_FALSE(recordGameAt(&file, 4, &game));
+    freeRecords(&file);
+
+    // A game cut short by the writer is skipped, the games before it are kept
+    FILE *out = fopen(path, "ab");
+    ASSERT_TRUE(out != NULL);
+    uint8_t partial[] = {ROWS, COLS, RECORD_UNFINISHED, 0, 5, 0, 1, 2};
+    fwrite(partial, 1, sizeof(partial), out);
+    fclose(out);
+    ASSERT_TRUE(loadRecords(&file, path));
+    ASSERT_EQ(4, (int) file.count);
+    freeRecords(&file);
+    remove(path);
+}
+
+void testReplaySeek() {
+    printf("===== testReplaySeek =====\n");
+    RecordGame game = {BOARD_MAX_ROWS, BOARD_MAX_COLS, RECORD_FIRST_LOSES, 0, NULL};
+    uint8_t moves[RECORD_MAX_MOVES];
+    SizedBoard board, seek;
+    Rng rng;
+    RecordReplay replay;
+
+    // A long random game on the largest board, eating one square at a time from the bottom-right corner
+    sizedBoardInit(&board, game.rows, game.cols);
+    rngSeed(&rng, 24);
+    while (sizedBoardSquares(&board) > 0) {
+        int row = (int) rngBelow(&rng, (uint64_t) game.rows);
+        if (board.lengths[row] == 0 || (row + 1 < game.rows && board.lengths[row + 1] == board.lengths[row])) {
+            continue;
+        }
+        int col = board.lengths[row] - 1;
+        moves[game.num_moves++] = (uint8_t) (row * game.cols + col);
+        sizedBoardDestroySquares(&board, row, col);
+    }
+    game.moves = moves;
+    ASSERT_EQ(RECORD_MAX_MOVES, game.num_moves);
+    ASSERT_TRUE(replayInit(&replay, &game));
+    ASSERT_EQ(RECORD_MAX_MOVES / RECORD_SNAPSHOT_INTERVAL + 1, replay.num_snapshots);
+
+    // Every ply matches the board played move by move
+    int mismatches = 0;
+    sizedBoardInit(&board, game.rows, game.cols);
+    for (int ply = 0; ply <= game.num_moves; ply++) {
+        if (!replaySeek(&replay, ply, &seek) || memcmp(&seek, &board, sizeof(SizedBoard)) != 0) {
+            mismatches++;
+        }
+        if (ply < game.num_moves) {
+            sizedBoardDestroySquares(&board, moves[ply] / game.cols, moves[ply] % game.cols);
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+    ASSERT_FALSE(replaySeek(&replay, game.num_moves + 1, &seek));
+
+    // A move on a square already eaten is rejected once, when the replay is built
+    moves[40] = moves[39];
+    ASSERT_FALSE(replayInit(&replay, &game));
+}
@@ -0,0 +1,142 @@
+#include "../../includes/testLobby.h"
+
+// Runs the event loop of a lobby on its own thread
+static void *runLobby(void *arg) {
+    lobbyRun((Lobby *) arg);
+    return NULL;
+}
+
+// Starts a lobby on a free port and returns the port
+static int startLobby(Lobby *lobby, bool ai_only, pthread_t *thread) {
+    struct sockaddr_in address;
+    socklen_t length = sizeof(address);
+
+    if (!lobbyInit(lobby, 0, ai_only)) {
+        return -1;
+    }
+    getsockname(lobby->listen_fd, (struct sockaddr *) &address, &length);
+    pthread_create(thread, NULL, runLobby, lobby);
+    return ntohs(address.sin_port);
+}
+
+static void stopLobby(Lobby *lobby, pthread_t thread) {
+    lobbyStop(lobby);
+    pthread_join(thread, NULL);
+    lobbyDestroy(lobby);
+}
+
+// Connects a client to a lobby and says hello
+static void connectClient(Channel *channel, int port) {
+    channelInit(channel, initClient("127.0.0.1", port));
+    ASSERT_TRUE(channel->fd >= 0);
+    ASSERT_TRUE(channelSendHello(channel, PROTOCOL_ANY_SEAT));
+}
+
+// Receives the next message, which must be of the given type
+static void expectMessage(Channel *channel, int type, Message *msg) {
+    ASSERT_TRUE(channelReceive(channel, msg));
+    ASSERT_EQ(type, msg->type);
+}
+
+void testLobbyPairsClients() {
+    printf("===== testLobbyPairsClients =====\n");
+    Lobby lobby;
+    pthread_t thread;
+    Channel first, second;
+    Message msg;
+    Message ping = {.type = MSG_PING};
+
+    int port = startLobby(&lobby, false, &thread);
+    ASSERT_TRUE(port > 0);
+
+    // The first client to say hello moves first; its ping is acked once the hello was handled
+    connectClient(&first, port);
+    ASSERT_TRUE(channelSend(&first, &ping));
+    expectMessage(&first, MSG_ACK, &msg);
+    ASSERT_EQ((int) ping.seq, (int) msg.ack.seq);
+    connectClient(&second, port);
+
+    expectMessage(&first, MSG_HELLO, &msg);
+    ASSERT_EQ(0, msg.hello.seat);
+    ASSERT_EQ(ROWS, msg.hello.rows);
+    ASSERT_EQ(COLS, msg.hello.cols);
+    expectMessage(&second, MSG_HELLO, &msg);
+    ASSERT_EQ(1, msg.hello.seat);
+
+    // Moves are acked to the mover and forwarded to the opponent
+    ASSERT_TRUE(channelSendMove(&first, 6, 8));
+    expectMessage(&first, MSG_ACK, &msg);
+    expectMessage(&second, MSG_MOVE, &msg);
+    ASSERT_EQ(6, msg.move.row);
+    ASSERT_EQ(8, msg.move.col);
+    ASSERT_TRUE(channelSendMove(&second, 6, 7));
+    expectMessage(&second, MSG_ACK, &msg);
+    expectMessage(&first, MSG_MOVE, &msg);
+    ASSERT_EQ(7, msg.move.col);
+
+    // An illegal move (too many squares) loses the game, then both clients are disconnected
+    ASSERT_TRUE(channelSendMove(&first, 0, 0));
+    expectMessage(&first, MSG_GAME_OVER, &msg);
+    ASSERT_EQ(0, msg.over.loser);
+    ASSERT_EQ(OVER_ILLEGAL_MOVE, msg.over.reason);
+    expectMessage(&second, MSG_GAME_OVER, &msg);
+    ASSERT_EQ(0, msg.over.loser);
+    ASSERT_FALSE(channelReceive(&first, &msg));
+    ASSERT_FALSE(channelReceive(&second, &msg));
+    close(first.fd);
+    close(second.fd);
+
+    stopLobby(&lobby, thread);
+    ASSERT_EQ(1, (int) lobby.games_started);
+    ASSERT_EQ(1, (int) lobby.games_finished);
+}
+
+void testLobbyAiOpponent() {
+    printf("===== testLobbyAiOpponent =====\n");
+    Lobby lobby;
+    pthread_t thread;
+    Message msg;
+
+    int port = startLobby(&lobby, true, &thread);
+    ASSERT_TRUE(port > 0);
+
+    // Several clients play the AI at the same time
+    Channel clients[3];
+    for (int i = 0; i < 3; i++) {
+        connectClient(&clients[i], port);
+        expectMessage(&clients[i], MSG_HELLO, &msg);
+        ASSERT_EQ(0, msg.hello.seat);
+    }
+
+    // A move and a ping batched in one send are acked in order; the AI answers once its search is done
+    for (int i = 0; i < 3; i++) {
+        Message move = {.type = MSG_MOVE, .move = {6, 8}};
+        Message ping = {.type = MSG_PING};
+        ASSERT_TRUE(channelQueue(&clients[i], &move));
+        ASSERT_TRUE(channelQueue(&clients[i], &ping));
+        ASSERT_TRUE(channelFlush(&clients[i]));
+    }
+    for (int i = 0; i < 3; i++) {
+        expectMessage(&clients[i], MSG_ACK, &msg);
+        ASSERT_EQ(1, (int) msg.ack.seq);
+        expectMessage(&clients[i], MSG_ACK, &msg);
+        ASSERT_EQ(2, (int) msg.ack.seq);
+        expectMessage(&clients[i], MSG_MOVE, &msg);
+        ASSERT_TRUE(msg.move.row < ROWS && msg.move.col < COLS);
+        ASSERT_FALSE(msg.move.row == 6 && msg.move.col == 8);
+    }
+
+    // Resigning ends the game
+    for (int i = 0; i < 3; i++) {
+        Message resign = {.type = MSG_RESIGN};
+        ASSERT_TRUE(channelSend(&clients[i], &resign));
+        expectMessage(&clients[i], MSG_GAME_OVER, &msg);
+        ASSERT_EQ(0, msg.over.loser);
+        ASSERT_EQ(OVER_RESIGNED, msg.over.reason);
+        close(clients[i].fd);
+    }
+
+    stopLobby(&lobby, thread);
+    ASSERT_EQ(3, (int) lobby.games_started);
+    ASSERT_EQ(3, (int) lobby.games_finished);
+}
@@ -0,0 +1,104 @@
+#include "../../includes/testMoveGen.h"
+
+/**
+ * Reference move generation: counts the squares covered by the move at every present square.
+ *
+ * @param bb The bitboard of the position.
+ * @return A bitboard with the bit of every legal move set.
+ */
+static Bitboard rescanLegalMoves(Bitboard bb) {
+    Bitboard legal = 0;
+    for (int cell = 0; cell < ROWS * COLS; cell++) {
+        if ((bb & (((Bitboard) 1) << cell)) && bitboardCountSquares(bb, cell / COLS, cell % COLS) <= MOVE_LIMIT) {
+            legal |= ((Bitboard) 1) << cell;
+        }
+    }
+    return legal;
+}
+
+void testMoveGenLegalMoves() {
+    printf("===== testMoveGenLegalMoves =====\n");
+    int mismatches = 0;
+
+    // The frontier gives the moves of a full rescan on every reachable position
+    for (uint32_t rank = 0; rank < staircaseCount(); rank++) {
+        Bitboard bb = staircaseToBitboard(staircaseUnrank(rank));
+        MoveGen gen;
+        moveGenInit(&gen, bb);
+        if (bitboardLegalMoves(bb) != rescanLegalMoves(bb) || gen.legal != rescanLegalMoves(bb)) {
+            mismatches++;
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+}
+
+void testMoveGenMakeUnmake() {
+    printf("===== testMoveGenMakeUnmake =====\n");
+    Rng rng;
+    rngSeed(&rng, 7);
+    int mismatches = 0;
+
+    for (int game = 0; game < 50; game++) {
+        MoveGen gen;
+        MoveUndo undo[ROWS * COLS];
+        Bitboard boards[ROWS * COLS];
+        int plies = 0;
+        moveGenInit(&gen, BB_FULL);
+
+        // Random games down to A1, the legal moves being kept up to date after every move
+        while (gen.board != 0) {
+            int cell;
+            do {
+                cell = (int) rngBelow(&rng, ROWS * COLS);
+            } while (!(gen.legal & (((Bitboard) 1) << cell)));
+            boards[plies] = gen.board;
+            moveGenMake(&gen, cell, &undo[plies++]);
+
+            MoveGen fresh;
+            moveGenInit(&fresh, gen.board);
+            if (gen.legal != rescanLegalMoves(gen.board) || memcmp(gen.lengths, fresh.lengths, ROWS) != 0) {
+                mismatches++;
+            }
+        }
+
+        // Taking every move back restores each position on the way
+        while (plies > 0) {
+            moveGenUnmake(&gen, &undo[--plies]);
+            MoveGen fresh;
+            moveGenInit(&fresh, boards[plies]);
+            if (gen.board != boards[plies] || gen.legal != fresh.legal ||
+                memcmp(gen.lengths, fresh.lengths, ROWS) != 0) {
+                mismatches++;
+            }
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+}
+
+void testPositionUndoStack() {
+    printf("===== testPositionUndoStack =====\n");
+    Position pos;
+    positionInit(&pos, BB_FULL, true);
+    uint64_t start_hash = pos.hash;
+    bool isMaximizing = true;
+    int mismatches = 0;
+
+    // Every move keeps the hash equal to the one computed from scratch
+    while (pos.gen.legal & ~BB_CELL(0, 0)) {
+        int cell = 63 - __builtin_clzll(pos.gen.legal);
+        makeMove(&pos, cell);
+        isMaximizing = !isMaximizing;
+        if (pos.hash != zobristHash(pos.gen.board, isMaximizing)) {
+            mismatches++;
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+    ASSERT_TRUE(pos.num_moves > 0);
+
+    while (pos.num_moves > 0) {
+        unmakeMove(&pos);
+    }
+    ASSERT_TRUE(pos.gen.board == BB_FULL);
+    ASSERT_TRUE(pos.hash == start_hash);
+    ASSERT_TRUE(pos.gen.legal == bitboardLegalMoves(BB_FULL));
+}
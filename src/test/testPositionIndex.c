@@ -0,0 +1,105 @@
+#include "../../includes/testPositionIndex.h"
+
+void testPositionIndexBuild() {
+    printf("===== testPositionIndexBuild =====\n");
+    const char *record_path = "tests/test.chgr";
+    const char *path = "tests/test.chpi";
+    remove(record_path);
+
+    // Two games through B1, won by the first player then by the second, and a game on another board
+    ASSERT_TRUE(recordOpen(record_path));
+    recordStartGame(ROWS, COLS);
+    recordMove(0, 1);
+    recordMove(1, 0);
+    recordMove(0, 0);
+    recordStartGame(ROWS, COLS);
+    recordMove(0, 1);
+    recordMove(2, 0);
+    recordMove(1, 0);
+    recordMove(0, 0);
+    recordStartGame(4, 4);
+    recordMove(0, 1);
+    recordClose();
+
+    // Any number of threads, even more than there are games, counts the same positions
+    RecordFile file;
+    ASSERT_TRUE(loadRecords(&file, record_path));
+    uint32_t ranks = staircaseCount();
+    PositionEntry *entries = calloc(ranks, sizeof(PositionEntry));
+    PositionEntry *single = calloc(ranks, sizeof(PositionEntry));
+    ASSERT_TRUE(entries != NULL && single != NULL);
+    uint64_t count = 0, single_count = 0;
+    uint32_t games = 0, single_games = 0;
+    ASSERT_TRUE(recordIndexPositions(&file, 1, 5, entries, &games, &count));
+    ASSERT_TRUE(recordIndexPositions(&file, 1, 1, single, &single_games, &single_count));
+    freeRecords(&file);
+    ASSERT_EQ(7, (int) count);
+    ASSERT_EQ(2, (int) games);
+    ASSERT_EQ(7, (int) single_count);
+    ASSERT_EQ(2, (int) single_games);
+    ASSERT_EQ(0, memcmp(entries, single, ranks * sizeof(PositionEntry)));
+
+    uint32_t num_entries = buildPositionIndex(entries);
+    ASSERT_EQ(4, (int) num_entries);
+    for (uint32_t i = 1; i < num_entries; i++) {
+        ASSERT_TRUE(entries[i - 1].rank < entries[i].rank);
+    }
+    ASSERT_TRUE(savePositionIndex(entries, num_entries, games, path));
+    free(entries);
+    free(single);
+
+    PositionIndex index;
+    ASSERT_TRUE(loadPositionIndex(&index, path));
+    ASSERT_EQ(2, (int) index.games);
+    const PositionEntry *start = positionIndexLookup(&index, BB_FULL);
+    ASSERT_TRUE(start != NULL);
+    ASSERT_EQ(2, (int) start->count);
+    ASSERT_EQ(1, (int) start->wins);
+    ASSERT_EQ(1, (int) start->losses);
+
+    // Only A1 left: the player to move lost both games
+    const PositionEntry *last = positionIndexLookup(&index, BB_CELL(0, 0));
+    ASSERT_TRUE(last != NULL);
+    ASSERT_EQ(2, (int) last->count);
+    ASSERT_EQ(2, (int) last->losses);
+    ASSERT_TRUE(positionIndexLookup(&index, BB_FULL & ~BB_CELL(ROWS - 1, COLS - 1)) == NULL);
+    freePositionIndex(&index);
+    ASSERT_TRUE(positionIndexLookup(&index, BB_FULL) == NULL);
+
+    // A truncated index is rejected
+    ASSERT_EQ(0, truncate(path, (off_t) (sizeof(PositionIndexHeader) + sizeof(PositionEntry) + 1)));
+    ASSERT_FALSE(loadPositionIndex(&index, path));
+    remove(path);
+    remove(record_path);
+}
+
+void testSortMovesByPrior() {
+    printf("===== testSortMovesByPrior =====\n");
+    const char *path = "tests/test.chpi";
+    Bitboard after_c1 = BB_FULL & ~bitboardQuadrant(0, 2);
+    Bitboard after_b2 = BB_FULL & ~bitboardQuadrant(1, 1);
+    uint32_t rank_c1 = staircaseRank(staircaseFromBitboard(after_c1));
+    uint32_t rank_b2 = staircaseRank(staircaseFromBitboard(after_b2));
+
+    // The opponent always lost after C1 and always won after B2
+    PositionEntry entries[2] = {{rank_c1, 10, 0, 10}, {rank_b2, 10, 10, 0}};
+    if (rank_b2 < rank_c1) {
+        PositionEntry swap = entries[0];
+        entries[0] = entries[1];
+        entries[1] = swap;
+    }
+    ASSERT_TRUE(savePositionIndex(entries, 2, 10, path));
+    PositionIndex index;
+    ASSERT_TRUE(loadPositionIndex(&index, path));
+
+    int moves[4][2] = {{1, 1}, {6, 8}, {0, 2}, {5, 8}};
+    sortMovesByPrior(&index, BB_FULL, moves, 4);
+    ASSERT_EQ(0, moves[0][0]);
+    ASSERT_EQ(2, moves[0][1]);
+    ASSERT_EQ(6, moves[1][0]);
+    ASSERT_EQ(5, moves[2][0]);
+    ASSERT_EQ(1, moves[3][0]);
+    ASSERT_EQ(1, moves[3][1]);
+    freePositionIndex(&index);
+    remove(path);
+}
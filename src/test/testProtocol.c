@@ -0,0 +1,137 @@
+#include "../../includes/testProtocol.h"
+
+void testProtocolRoundTrip() {
+    printf("===== testProtocolRoundTrip =====\n");
+    uint8_t frame[PROTOCOL_MAX_FRAME];
+    Message msg;
+
+    Message move = {.type = MSG_MOVE, .seq = 70000, .move = {6, 8}};
+    int size = protocolEncode(&move, frame, sizeof(frame));
+    ASSERT_EQ(PROTOCOL_HEADER_SIZE + 2, size);
+    ASSERT_EQ(0, frame[0]);
+    ASSERT_EQ(size - 2, frame[1]);
+    ASSERT_EQ(PROTOCOL_VERSION, frame[2]);
+    ASSERT_EQ(size, protocolDecode(frame, size, &msg));
+    ASSERT_EQ(MSG_MOVE, msg.type);
+    ASSERT_EQ(70000, (int) msg.seq);
+    ASSERT_EQ(6, msg.move.row);
+    ASSERT_EQ(8, msg.move.col);
+
+    Message hello = {.type = MSG_HELLO, .hello = {1, ROWS, COLS}};
+    size = protocolEncode(&hello, frame, sizeof(frame));
+    ASSERT_EQ(size, protocolDecode(frame, size, &msg));
+    ASSERT_EQ(1, msg.hello.seat);
+    ASSERT_EQ(COLS, msg.hello.cols);
+
+    Message ack = {.type = MSG_ACK, .ack = {0x01020304}};
+    size = protocolEncode(&ack, frame, sizeof(frame));
+    ASSERT_EQ(size, protocolDecode(frame, size, &msg));
+    ASSERT_EQ(0x01020304, (int) msg.ack.seq);
+
+    Message over = {.type = MSG_GAME_OVER, .over = {1, OVER_RESIGNED}};
+    size = protocolEncode(&over, frame, sizeof(frame));
+    ASSERT_EQ(size, protocolDecode(frame, size, &msg));
+    ASSERT_EQ(1, msg.over.loser);
+    ASSERT_EQ(OVER_RESIGNED, msg.over.reason);
+
+    Message ping = {.type = MSG_PING, .seq = 5};
+    ASSERT_EQ(PROTOCOL_HEADER_SIZE, protocolEncode(&ping, frame, sizeof(frame)));
+    ASSERT_EQ(PROTOCOL_HEADER_SIZE, protocolDecode(frame, PROTOCOL_HEADER_SIZE, &msg));
+    ASSERT_EQ(MSG_PING, msg.type);
+
+    // The buffer must hold the whole frame
+    ASSERT_EQ(-1, protocolEncode(&move, frame, PROTOCOL_HEADER_SIZE + 1));
+}
+
+void testProtocolPartialFrames() {
+    printf("===== testProtocolPartialFrames =====\n");
+    uint8_t stream[2 * PROTOCOL_MAX_FRAME];
+    Message msg;
+
+    Message move = {.type = MSG_MOVE, .seq = 1, .move = {2, 3}};
+    Message resign = {.type = MSG_RESIGN, .seq = 2};
+    int first = protocolEncode(&move, stream, sizeof(stream));
+    int second = protocolEncode(&resign, stream + first, sizeof(stream) - first);
+
+    // A frame split across reads is only decoded once complete
+    bool partial = true;
+    for (int length = 0; length < first; length++) {
+        partial = partial && protocolDecode(stream, length, &msg) == 0;
+    }
+    ASSERT_TRUE(partial);
+
+    // Two frames received together are decoded one after the other
+    ASSERT_EQ(first, protocolDecode(stream, first + second, &msg));
+    ASSERT_EQ(MSG_MOVE, msg.type);
+    ASSERT_EQ(second, protocolDecode(stream + first, second, &msg));
+    ASSERT_EQ(MSG_RESIGN, msg.type);
+    ASSERT_EQ(2, (int) msg.seq);
+}
+
+void testProtocolRejectsMalformed() {
+    printf("===== testProtocolRejectsMalformed =====\n");
+    uint8_t frame[PROTOCOL_MAX_FRAME];
+    Message msg;
+    Message move = {.type = MSG_MOVE, .move = {0, 1}};
+    int size = protocolEncode(&move, frame, sizeof(frame));
+
+    // Another version is rejected as soon as its byte arrives
+    frame[2] = PROTOCOL_VERSION + 1;
+    ASSERT_EQ(-1, protocolDecode(frame, 3, &msg));
+    frame[2] = PROTOCOL_VERSION;
+
+    // So are an unknown type and a length that does not match the type
+    frame[3] = 42;
+    ASSERT_EQ(-1, protocolDecode(frame, size, &msg));
+    frame[3] = MSG_MOVE;
+    frame[1]++;
+    ASSERT_EQ(-1, protocolDecode(frame, size, &msg));
+    frame[1]--;
+    ASSERT_EQ(size, protocolDecode(frame, size, &msg));
+
+    Message unknown = {.type = 0};
+    ASSERT_EQ(-1, protocolEncode(&unknown, frame, sizeof(frame)));
+}
+
+void testChannelBatching() {
+    printf("===== testChannelBatching =====\n");
+    int fds[2];
+    ASSERT_TRUE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    Channel sender, receiver;
+    channelInit(&sender, fds[0]);
+    channelInit(&receiver, fds[1]);
+    Message msg;
+    int row, col;
+
+    // Queued messages are numbered and leave in a single send
+    ASSERT_TRUE(channelAck(&sender, 9));
+    ASSERT_EQ(PROTOCOL_HEADER_SIZE + 4, (int) sender.out_len);
+    ASSERT_TRUE(channelSendMove(&sender, 4, 5));
+    ASSERT_EQ(0, (int) sender.out_len);
+    ASSERT_EQ(2, (int) sender.next_seq);
+
+    // Waiting for a move skips the ack
+    int type = channelReceiveMove(&receiver, &row, &col, &msg);
+    ASSERT_EQ(MSG_MOVE, type);
+    ASSERT_EQ(4, row);
+    ASSERT_EQ(5, col);
+    ASSERT_EQ(1, (int) msg.seq);
+
+    // A ping is answered while waiting for a move
+    Message ping = {.type = MSG_PING};
+    ASSERT_TRUE(channelSend(&sender, &ping));
+    ASSERT_TRUE(channelSendGameOver(&sender, 0, OVER_A1_EATEN));
+    type = channelReceiveMove(&receiver, &row, &col, &msg);
+    ASSERT_EQ(MSG_GAME_OVER, type);
+    ASSERT_EQ(OVER_A1_EATEN, msg.over.reason);
+    bool received = channelReceive(&sender, &msg);
+    ASSERT_TRUE(received);
+    ASSERT_EQ(MSG_ACK, msg.type);
+    ASSERT_EQ(2, (int) msg.ack.seq);
+
+    // A closed connection ends the wait
+    close(fds[0]);
+    type = channelReceiveMove(&receiver, &row, &col, &msg);
+    ASSERT_EQ(-1, type);
+    close(fds[1]);
+}
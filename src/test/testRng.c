@@ -0,0 +1,52 @@
+#include "../../includes/testRng.h"
+
+void testRngSeed() {
+    printf("===== testRngSeed =====\n");
+    Rng a, b, c;
+    rngSeed(&a, 12345);
+    rngSeed(&b, 12345);
+    rngSeed(&c, 12346);
+
+    int same = 0, different = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t x = rngNext(&a);
+        same += x == rngNext(&b);
+        different += x != rngNext(&c);
+    }
+    ASSERT_EQ(1000, same);
+    ASSERT_EQ(1000, different);
+
+    // Streams of the same seed differ from each other, and from a neighbouring seed's streams
+    rngSeedStream(&a, 1, 1);
+    rngSeedStream(&b, 1, 2);
+    rngSeedStream(&c, 2, 0);
+    uint64_t x = rngNext(&a);
+    ASSERT_TRUE(x != rngNext(&b));
+    ASSERT_TRUE(x != rngNext(&c));
+
+    // A zero seed still gives a working generator
+    rngSeed(&a, 0);
+    ASSERT_TRUE(rngNext(&a) != 0 || rngNext(&a) != 0);
+}
+
+void testRngBelow() {
+    printf("===== testRngBelow =====\n");
+    Rng rng;
+    int counts[6] = {0};
+    int out_of_range = 0;
+    rngSeed(&rng, 7);
+
+    for (int i = 0; i < 60000; i++) {
+        uint32_t value = rngBelow(&rng, 6);
+        if (value >= 6) {
+            out_of_range++;
+        } else {
+            counts[value]++;
+        }
+    }
+    ASSERT_EQ(0, out_of_range);
+    for (int i = 0; i < 6; i++) {
+        ASSERT_TRUE(counts[i] > 9500 && counts[i] < 10500);
+    }
+    ASSERT_EQ(0, (int) rngBelow(&rng, 1));
+}
@@ -0,0 +1,112 @@
+#include "../../includes/testSizedBoard.h"
+
+void testSizedBoardInit() {
+    printf("===== testSizedBoardInit =====\n");
+    SizedBoard board;
+    int rows, cols;
+
+    ASSERT_TRUE(sizedBoardInit(&board, 16, 16));
+    ASSERT_EQ(256, sizedBoardSquares(&board));
+    ASSERT_FALSE(sizedBoardIsDefault(&board));
+    ASSERT_FALSE(sizedBoardInit(&board, 17, 4));
+    ASSERT_FALSE(sizedBoardInit(&board, 4, 0));
+    ASSERT_EQ(256, sizedBoardSquares(&board));
+
+    ASSERT_TRUE(sizedBoardParseSize("10x12", &rows, &cols));
+    ASSERT_EQ(10, rows);
+    ASSERT_EQ(12, cols);
+    ASSERT_FALSE(sizedBoardParseSize("10x17", &rows, &cols));
+    ASSERT_FALSE(sizedBoardParseSize("10", &rows, &cols));
+    ASSERT_FALSE(sizedBoardParseSize("10x12x", &rows, &cols));
+
+    ASSERT_TRUE(sizedBoardInit(&board, ROWS, COLS));
+    ASSERT_TRUE(sizedBoardIsDefault(&board));
+    ASSERT_TRUE(staircaseToBitboard(sizedBoardToStaircase(&board)) == BB_FULL);
+}
+
+void testSizedBoardDestroySquares() {
+    printf("===== testSizedBoardDestroySquares =====\n");
+    SizedBoard board;
+    sizedBoardInit(&board, 12, 14);
+
+    ASSERT_TRUE(sizedBoardCanDestroy(&board, 11, 13));
+    ASSERT_FALSE(sizedBoardCanDestroy(&board, 12, 0));
+    ASSERT_FALSE(sizedBoardCanDestroy(&board, 0, 14));
+    ASSERT_EQ(4, sizedBoardCountSquares(&board, 10, 12));
+    ASSERT_FALSE(sizedBoardDestroySquares(&board, 9, 12));
+
+    ASSERT_TRUE(sizedBoardDestroySquares(&board, 10, 12));
+    ASSERT_EQ(12, board.lengths[10]);
+    ASSERT_EQ(12, board.lengths[11]);
+    ASSERT_EQ(14, board.lengths[9]);
+    ASSERT_FALSE(sizedBoardCanDestroy(&board, 11, 12));
+    ASSERT_EQ(12 * 14 - 4, sizedBoardSquares(&board));
+}
+
+void testSizedBoardLegalMoves() {
+    printf("===== testSizedBoardLegalMoves =====\n");
+    int moves[BOARD_MAX_ROWS * BOARD_MAX_COLS][2];
+    int expected[ROWS * COLS][2];
+    SizedBoard board;
+    sizedBoardInit(&board, ROWS, COLS);
+    sizedBoardDestroySquares(&board, ROWS - 1, COLS - 4);
+    sizedBoardDestroySquares(&board, ROWS - 3, COLS - 1);
+
+    // Same moves as the staircase of the default size
+    int num_moves = sizedBoardLegalMoves(&board, moves);
+    ASSERT_EQ(staircaseLegalMoves(sizedBoardToStaircase(&board), expected), num_moves);
+    ASSERT_EQ(0, memcmp(moves, expected, sizeof(int) * 2 * num_moves));
+
+    // On a full 16x16 board only the bottom-right corner can be taken
+    sizedBoardInit(&board, 16, 16);
+    num_moves = sizedBoardLegalMoves(&board, moves);
+    ASSERT_EQ(10, num_moves);
+    for (int i = 0; i < num_moves; i++) {
+        ASSERT_TRUE(sizedBoardCountSquares(&board, moves[i][0], moves[i][1]) <= MOVE_LIMIT);
+    }
+}
+
+void testSizedBoardSearch() {
+    printf("===== testSizedBoardSearch =====\n");
+    SizedBoard board;
+    SearchContext ctx;
+    int row, col;
+
+    // The packed search and the search on row lengths agree, on every size the packed one takes
+    int sizes[][2] = {{8, 8}, {8, 16}, {1, 12}, {3, 11}, {10, 5}, {16, 16}};
+    for (int s = 0; s < 6; s++) {
+        uint64_t nodes = 0, generic_nodes = 0;
+        sizedBoardInit(&board, sizes[s][0], sizes[s][1]);
+        sizedBoardDestroySquares(&board, sizes[s][0] - 1, sizes[s][1] - 2);
+        int score = sizedBoardNegamax(&board, 4, &nodes);
+        int generic_score = sizedBoardNegamaxGeneric(&board, 4, &generic_nodes);
+        ASSERT_EQ(score, generic_score);
+        ASSERT_TRUE(nodes == generic_nodes && nodes > 0);
+    }
+
+    // Known L-shaped endgame: arms of 3 and 1 squares, taking 2 from the long arm wins
+    sizedBoardInit(&board, 2, 4);
+    sizedBoardDestroySquares(&board, 1, 1);
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    sizedBoardSearchMove(&ctx, &board, &row, &col);
+    ASSERT_EQ(0, row);
+    ASSERT_EQ(2, col);
+
+    // A 16x16 board gives a legal move
+    sizedBoardInit(&board, 16, 16);
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    ctx.root_threads = false;
+    sizedBoardSearchMove(&ctx, &board, &row, &col);
+    ASSERT_TRUE(sizedBoardDestroySquares(&board, row, col));
+    ASSERT_TRUE(ctx.nodes > 0);
+    ASSERT_TRUE(strcmp(ctx.source, "search") == 0);
+
+    // The default size takes the bitboard search
+    sizedBoardInit(&board, ROWS, COLS);
+    ttClear(aiTranspositionTable());
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    ctx.root_threads = false;
+    ctx.max_depth = 3;
+    ASSERT_EQ(3, sizedBoardSearchMove(&ctx, &board, &row, &col));
+    ASSERT_TRUE(sizedBoardDestroySquares(&board, row, col));
+}
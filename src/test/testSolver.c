@@ -0,0 +1,109 @@
+#include "../../includes/testSolver.h"
+
+// Exhaustive reference: the player to move wins if some move leaves a lost position
+static bool referenceWins(Bitboard board) {
+    if (board == 0) {
+        return true;
+    }
+    Bitboard moves = bitboardLegalMoves(board);
+    while (moves) {
+        int cell = __builtin_ctzll(moves);
+        moves &= moves - 1;
+        if (!referenceWins(board & ~bitboardQuadrant(cell / COLS, cell % COLS))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static Bitboard staircase(const int lengths[ROWS]) {
+    Bitboard board = 0;
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < lengths[i]; j++) {
+            board |= BB_CELL(i, j);
+        }
+    }
+    return board;
+}
+
+void testSolveChomp() {
+    printf("===== testSolveChomp =====\n");
+    SolutionTable table;
+    ASSERT_TRUE(solveChomp(&table));
+
+    // Every staircase of the top-left 3x4 corner matches the exhaustive search
+    int mismatches = 0;
+    int lengths[ROWS] = {0};
+    for (lengths[0] = 0; lengths[0] <= 4; lengths[0]++) {
+        for (lengths[1] = 0; lengths[1] <= lengths[0]; lengths[1]++) {
+            for (lengths[2] = 0; lengths[2] <= lengths[1]; lengths[2]++) {
+                bool win;
+                int distance;
+                lookupSolution(&table, staircase(lengths), &win, &distance);
+                if (win != referenceWins(staircase(lengths))) {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+
+    // Only A1 left: the player to move has to eat it
+    bool win;
+    int distance;
+    lookupSolution(&table, BB_CELL(0, 0), &win, &distance);
+    ASSERT_FALSE(win);
+    ASSERT_EQ(1, distance);
+    freeSolution(&table);
+}
+
+void testSolutionBestMove() {
+    printf("===== testSolutionBestMove =====\n");
+    SolutionTable table;
+    solveChomp(&table);
+    int row = -1, col = -1;
+
+    // A1 and B1 left: eating B1 leaves A1 to the opponent
+    ASSERT_TRUE(solutionBestMove(&table, BB_CELL(0, 0) | BB_CELL(0, 1), &row, &col));
+    ASSERT_EQ(0, row);
+    ASSERT_EQ(1, col);
+
+    ASSERT_FALSE(solutionBestMove(&table, 0, &row, &col));
+    freeSolution(&table);
+}
+
+void testSaveLoadSolution() {
+    printf("===== testSaveLoadSolution =====\n");
+    SolutionTable solved, loaded;
+    const char *path = "tests/test.sol";
+
+    solveChomp(&solved);
+    ASSERT_TRUE(saveSolution(&solved, path));
+    ASSERT_TRUE(loadSolution(&loaded, path));
+    ASSERT_TRUE(loaded.map != NULL);
+    ASSERT_EQ((int) solved.count, (int) loaded.count);
+    ASSERT_EQ(0, memcmp(solved.results, loaded.results, solved.count));
+    ASSERT_TRUE(verifySolution(&loaded));
+    ASSERT_FALSE(verifySolution(&solved));
+    freeSolution(&loaded);
+
+    // A corrupted result fails the checksum and is rejected
+    FILE *file = fopen(path, "r+b");
+    fseek(file, (long) sizeof(SolutionHeader) + 100, SEEK_SET);
+    fputc(solved.results[100] ^ 1, file);
+    fclose(file);
+    ASSERT_FALSE(loadSolution(&loaded, path));
+
+    // Another version, or a truncated file, is rejected
+    file = fopen(path, "r+b");
+    fseek(file, (long) offsetof(SolutionHeader, version), SEEK_SET);
+    fputc(SOLUTION_VERSION + 1, file);
+    fclose(file);
+    ASSERT_FALSE(loadSolution(&loaded, path));
+    ASSERT_TRUE(saveSolution(&solved, path));
+    ASSERT_EQ(0, truncate(path, (off_t) (sizeof(SolutionHeader) + solved.count - 1)));
+    ASSERT_FALSE(loadSolution(&loaded, path));
+
+    remove(path);
+    freeSolution(&solved);
+}
@@ -0,0 +1,82 @@
+#include "../../includes/testStaircase.h"
+
+void testStaircaseRank() {
+    printf("===== testStaircaseRank =====\n");
+    int mismatches = 0;
+
+    ASSERT_EQ(11440, (int) staircaseCount());
+    ASSERT_EQ(0, (int) staircaseRank(staircaseFromBitboard(0)));
+    ASSERT_EQ((int) staircaseCount() - 1, (int) staircaseRank(staircaseFromBitboard(BB_FULL)));
+
+    for (uint32_t rank = 0; rank < staircaseCount(); rank++) {
+        StaircaseState state = staircaseUnrank(rank);
+        if (!staircaseIsValid(state) || staircaseRank(state) != rank) {
+            mismatches++;
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+}
+
+void testStaircaseBoardConversion() {
+    printf("===== testStaircaseBoardConversion =====\n");
+    int board[ROWS][COLS] = {
+        {1, 1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 1, 1, 1, 1, 1, 1, 0, 0},
+        {1, 1, 1, 1, 1, 0, 0, 0, 0},
+        {1, 1, 1, 1, 0, 0, 0, 0, 0},
+        {1, 1, 0, 0, 0, 0, 0, 0, 0},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0}
+    };
+    int copy[ROWS][COLS];
+
+    StaircaseState state = staircaseFromBoard(board);
+    ASSERT_EQ(7, state.lengths[1]);
+    ASSERT_EQ(0, state.lengths[6]);
+    ASSERT_EQ(28, staircaseSquares(state));
+
+    staircaseToBoard(state, copy);
+    ASSERT_EQ(0, memcmp(board, copy, sizeof(board)));
+    ASSERT_TRUE(staircaseToBitboard(state) == boardToBitboard(board));
+    ASSERT_EQ((int) staircaseRank(state), (int) staircaseRank(staircaseFromBitboard(boardToBitboard(board))));
+}
+
+void testStaircaseDestroySquares() {
+    printf("===== testStaircaseDestroySquares =====\n");
+    StaircaseState state = staircaseFromBitboard(BB_FULL);
+
+    ASSERT_TRUE(staircaseCanDestroy(state, 6, 8));
+    ASSERT_FALSE(staircaseCanDestroy(state, 7, 0));
+    ASSERT_FALSE(staircaseDestroySquares(&state, 0, 0));
+    ASSERT_TRUE(staircaseDestroySquares(&state, 5, 7));
+    ASSERT_EQ(7, state.lengths[5]);
+    ASSERT_EQ(7, state.lengths[6]);
+    ASSERT_EQ(9, state.lengths[4]);
+    ASSERT_FALSE(staircaseCanDestroy(state, 6, 7));
+}
+
+void testStaircaseLegalMoves() {
+    printf("===== testStaircaseLegalMoves =====\n");
+    int moves[ROWS * COLS][2];
+    int mismatches = 0;
+
+    // The moves generated on the encoding are the moves of the bitboard, in the same order
+    for (uint32_t rank = 0; rank < staircaseCount(); rank += 97) {
+        StaircaseState state = staircaseUnrank(rank);
+        Bitboard legal = bitboardLegalMoves(staircaseToBitboard(state));
+        int num_moves = staircaseLegalMoves(state, moves);
+
+        if (num_moves != bitboardCount(legal)) {
+            mismatches++;
+            continue;
+        }
+        for (int i = 0; i < num_moves; i++) {
+            int cell = __builtin_ctzll(legal);
+            legal &= legal - 1;
+            if (BB_INDEX(moves[i][0], moves[i][1]) != cell) {
+                mismatches++;
+            }
+        }
+    }
+    ASSERT_EQ(0, mismatches);
+}
@@ -0,0 +1,144 @@
+#include "../../includes/testTransposition.h"
+
+void testZobristHash() {
+    printf("===== testZobristHash =====\n");
+    Bitboard board = BB_FULL;
+    Bitboard removed = board & bitboardQuadrant(5, 7);
+    uint64_t incremental = zobristHash(board, true) ^ zobristSquares(removed) ^ zobristSide();
+
+    ASSERT_TRUE(incremental == zobristHash(board & ~removed, false));
+    ASSERT_TRUE(zobristHash(board, true) != zobristHash(board, false));
+}
+
+void testTranspositionStoreProbe() {
+    printf("===== testTranspositionStoreProbe =====\n");
+    TranspositionTable table;
+    TTEntry entry;
+
+    ASSERT_TRUE(ttInit(&table, 4));
+    ASSERT_FALSE(ttProbe(&table, 42, &entry));
+
+    ttStore(&table, 42, 3, TT_LOWER, -17, 12);
+    ASSERT_TRUE(ttProbe(&table, 42, &entry));
+    ASSERT_EQ(3, entry.depth);
+    ASSERT_EQ(TT_LOWER, entry.bound);
+    ASSERT_EQ(-17, entry.score);
+    ASSERT_EQ(12, entry.best_move);
+
+    // Same bucket (4 buckets), different keys: the bucket holds TT_BUCKET_SLOTS positions
+    for (int i = 1; i < TT_BUCKET_SLOTS; i++) {
+        ttStore(&table, 42 + 4 * i, 2, TT_EXACT, i, -1);
+    }
+    ASSERT_TRUE(ttProbe(&table, 42, &entry));
+    for (int i = 1; i < TT_BUCKET_SLOTS; i++) {
+        ASSERT_TRUE(ttProbe(&table, 42 + 4 * i, &entry));
+    }
+
+    // A full bucket: the shallowest position is replaced
+    ttStore(&table, 42 + 4 * TT_BUCKET_SLOTS, 1, TT_EXACT, 5, -1);
+    ASSERT_TRUE(ttProbe(&table, 42, &entry));
+    ASSERT_FALSE(ttProbe(&table, 42 + 4, &entry));
+    ASSERT_TRUE(ttProbe(&table, 42 + 4 * TT_BUCKET_SLOTS, &entry));
+    ASSERT_EQ(5, entry.score);
+
+    ttClear(&table);
+    ASSERT_FALSE(ttProbe(&table, 42, &entry));
+    ttFree(&table);
+}
+
+void testTranspositionAging() {
+    printf("===== testTranspositionAging =====\n");
+    TranspositionTable table;
+    TTEntry entry;
+
+    ASSERT_TRUE(ttInit(&table, 2));
+    ASSERT_EQ(ttBitsForSize(16), TT_DEFAULT_BITS);
+    for (int i = 0; i < TT_BUCKET_SLOTS; i++) {
+        ttStore(&table, 100 + i, 6, TT_EXACT, i, -1);
+    }
+
+    // After a new search, shallow entries of the current search are kept over deep entries of the previous one
+    ttNewSearch(&table);
+    ttStore(&table, 200, 1, TT_LOWER, 7, 3);
+    ttStore(&table, 201, 1, TT_LOWER, 8, 4);
+    ASSERT_TRUE(ttProbe(&table, 200, &entry));
+    ASSERT_EQ(1, entry.generation);
+    ASSERT_EQ(3, entry.best_move);
+    ASSERT_TRUE(ttProbe(&table, 201, &entry));
+    ASSERT_FALSE(ttProbe(&table, 100, &entry));
+    ASSERT_FALSE(ttProbe(&table, 101, &entry));
+    ASSERT_TRUE(ttProbe(&table, 102, &entry));
+    ASSERT_EQ(0, entry.generation);
+    ttFree(&table);
+}
+
+// Keys stored and probed by one thread of testTranspositionConcurrent()
+typedef struct {
+    TranspositionTable *table;
+    uint64_t seed;
+    int mismatches;
+    int hits;
+} TableWorker;
+
+/**
+ * Stores and probes keys whose fields are derived from the key itself, and counts the probed entries
+ * whose fields do not match their key.
+ *
+ * @param arg A pointer to the TableWorker.
+ * @return Always NULL.
+ */
+static void *tableWorker(void *arg) {
+    TableWorker *worker = (TableWorker *) arg;
+    uint64_t x = worker->seed;
+    TTEntry entry;
+    for (int i = 0; i < 200000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        uint64_t key = x & 0xFFFFFFF;
+        ttStore(worker->table, key, (int) (key % 40), (BoundType) (key % 3), (int) (key % 900) - 450, (int) (key % 63));
+        uint64_t probe = (x >> 28) & 0xFFFFFFF;
+        if (ttProbe(worker->table, probe, &entry)) {
+            worker->hits++;
+            if (entry.depth != (int) (probe % 40) || entry.bound != probe % 3 ||
+                entry.score != (int) (probe % 900) - 450 || entry.best_move != (int) (probe % 63)) {
+                worker->mismatches++;
+            }
+        }
+    }
+    return NULL;
+}
+
+void testTranspositionConcurrent() {
+    printf("===== testTranspositionConcurrent =====\n");
+    TranspositionTable table;
+    TableWorker workers[4];
+    pthread_t threads[4];
+
+    // A small table shared by 4 threads: slots are written concurrently, a torn slot must never be returned
+    ASSERT_TRUE(ttInit(&table, 8));
+    for (int t = 0; t < 4; t++) {
+        workers[t] = (TableWorker) {&table, 0x9E3779B97F4A7C15ULL * (t + 1), 0, 0};
+        pthread_create(&threads[t], NULL, tableWorker, &workers[t]);
+    }
+    int mismatches = 0;
+    for (int t = 0; t < 4; t++) {
+        pthread_join(threads[t], NULL);
+        mismatches += workers[t].mismatches;
+    }
+    ASSERT_EQ(0, mismatches);
+    ttFree(&table);
+}
+
+void testMinimaxWithTable() {
+    printf("===== testMinimaxWithTable =====\n");
+    Bitboard board = BB_FULL & ~bitboardQuadrant(4, 5) & ~bitboardQuadrant(2, 7);
+
+    ttClear(aiTranspositionTable());
+    int cold = minimaxBitboard(board, 4, true, -INF, INF);
+    int warm = minimaxBitboard(board, 4, true, -INF, INF);
+    ASSERT_EQ(cold, warm);
+    TTEntry entry;
+    ASSERT_TRUE(ttProbe(aiTranspositionTable(), zobristHash(board, true), &entry));
+    ttPrintStats(aiTranspositionTable());
+}
@@ -0,0 +1,141 @@
+#include "../../includes/batchMain.h"
+
+/**
+ * Reads a position written as its row lengths, top row first, separated by spaces or commas.
+ * Missing rows are empty.
+ *
+ * @param line The line to parse.
+ * @param board Receives the bitboard of the position.
+ * @return True if the line is a staircase position of this board, false otherwise.
+ */
+static bool parsePosition(const char *line, Bitboard *board) {
+    StaircaseState state = {0};
+    const char *p = line;
+    int rows = 0;
+
+    while (*p != '\0') {
+        char *end;
+        long length = strtol(p, &end, 10);
+        if (end == p) {
+            if (*p != ' ' && *p != ',' && *p != '\t' && *p != '\r' && *p != '\n') {
+                return false;
+            }
+            p++;
+            continue;
+        }
+        if (rows == ROWS || length < 0 || length > COLS) {
+            return false;
+        }
+        state.lengths[rows++] = (uint8_t) length;
+        p = end;
+    }
+    if (rows == 0 || !staircaseIsValid(state)) {
+        return false;
+    }
+    *board = staircaseToBitboard(state);
+    return true;
+}
+
+/**
+ * Writes the result of a position as one line: the row lengths, the move (or '-' if there is none),
+ * the score, the depth completed and the positions visited.
+ *
+ * @param position The position and its result.
+ */
+static void printResult(const BatchPosition *position) {
+    StaircaseState state = staircaseFromBitboard(position->board);
+    for (int i = 0; i < ROWS; i++) {
+        printf("%s%d", i > 0 ? "," : "", state.lengths[i]);
+    }
+    if (position->row >= 0) {
+        printf(" %c%d", position->col + 'A', position->row + 1);
+    } else {
+        printf(" -");
+    }
+    printf(" %d %d %llu\n", position->score, position->depth, (unsigned long long) position->nodes);
+}
+
+/**
+ * Prints the usage of the batch analyser.
+ *
+ * @param program The name of the program.
+ */
+static void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options] < positions > results\n", program);
+    fprintf(stderr, "  One position per line, as its row lengths from the top row (e.g. 9,9,9,9,9,7,4)\n");
+    fprintf(stderr, "  One result per line: row lengths, best move, score, depth and nodes\n");
+    fprintf(stderr, "  -depth <d>          Search every position to depth <d> (default: %d)\n", BATCH_DEPTH);
+    fprintf(stderr, "  -time <ms>          Search every position for <ms> instead\n");
+    fprintf(stderr, "  -threads <n>        Search positions on <n> threads (default: one per core)\n");
+    fprintf(stderr, "  -eval <name>        Evaluation of the searches (default: %s)\n", EVAL_DEFAULT);
+    fprintf(stderr, "  -seed <n>           Seed of the choice between equal moves (default: 1)\n");
+}
+
+/**
+ * Entry point of the batch analyser: reads positions from the standard input, searches them BATCH_CHUNK
+ * at a time on every core, and writes their results in the same order on the standard output.
+ * Lines that are not positions are reported on the standard error and skipped.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments, see printUsage().
+ * @return 0 on success, 1 on a bad option or if the threads could not be started.
+ */
+int main(int argc, char *argv[]) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    BatchOptions options = {cores > 0 ? (int) cores : 1, BATCH_DEPTH, 0, NULL, 1};
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (value != NULL && strcmp(argv[i], "-depth") == 0 && atoi(value) > 0 && atoi(value) < 64) {
+            options.depth = atoi(value);
+        } else if (value != NULL && strcmp(argv[i], "-time") == 0 && atoi(value) > 0) {
+            options.budget_ms = atoi(value);
+        } else if (value != NULL && strcmp(argv[i], "-threads") == 0 && atoi(value) > 0) {
+            options.num_threads = atoi(value);
+        } else if (value != NULL && strcmp(argv[i], "-eval") == 0 && evaluatorByName(value) != NULL) {
+            options.evaluator = evaluatorByName(value);
+        } else if (value != NULL && strcmp(argv[i], "-seed") == 0) {
+            options.seed = strtoull(value, NULL, 10);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    BatchEvaluator batch;
+    BatchPosition *positions = malloc(BATCH_CHUNK * sizeof(BatchPosition));
+    if (positions == NULL || !batchInit(&batch, &options)) {
+        fprintf(stderr, "Could not start the search threads.\n");
+        free(positions);
+        return 1;
+    }
+
+    char line[BATCH_LINE_SIZE];
+    long line_number = 0;
+    bool more = true;
+    while (more) {
+        int count = 0;
+        while (count < BATCH_CHUNK && (more = fgets(line, sizeof(line), stdin) != NULL)) {
+            line_number++;
+            if (line[strspn(line, " \t\r\n")] == '\0') {
+                continue;
+            }
+            if (!parsePosition(line, &positions[count].board)) {
+                fprintf(stderr, "Line %ld is not a position: %s", line_number, line);
+                continue;
+            }
+            count++;
+        }
+
+        batchEvaluate(&batch, positions, count);
+        for (int i = 0; i < count; i++) {
+            printResult(&positions[i]);
+        }
+        fflush(stdout);
+    }
+
+    batchDestroy(&batch);
+    free(positions);
+    return 0;
+}
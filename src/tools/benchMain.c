@@ -0,0 +1,418 @@
+#include "../../includes/benchMain.h"
+
+// Heap allocations made by the process, counted by the linker wrappers below (-Wl,--wrap=...)
+static atomic_uint_fast64_t allocations;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+/**
+ * Counting wrapper of malloc(), installed by the linker.
+ *
+ * @param size The number of bytes to allocate.
+ * @return The allocated memory.
+ */
+void *__wrap_malloc(size_t size) {
+    atomic_fetch_add(&allocations, 1);
+    return __real_malloc(size);
+}
+
+/**
+ * Counting wrapper of calloc(), installed by the linker.
+ *
+ * @param count The number of elements to allocate.
+ * @param size The size of one element.
+ * @return The allocated memory.
+ */
+void *__wrap_calloc(size_t count, size_t size) {
+    atomic_fetch_add(&allocations, 1);
+    return __real_calloc(count, size);
+}
+
+/**
+ * Counting wrapper of realloc(), installed by the linker.
+ *
+ * @param ptr The memory to resize.
+ * @param size The new size in bytes.
+ * @return The resized memory.
+ */
+void *__wrap_realloc(void *ptr, size_t size) {
+    atomic_fetch_add(&allocations, 1);
+    return __real_realloc(ptr, size);
+}
+
+// A benchmarked operation: setup runs untimed before every call of run, which is then timed alone
+typedef struct {
+    void (*setup)(void *arg);
+    void (*run)(void *arg);
+    void *arg;
+} BenchOp;
+
+// Arguments of the board operations
+typedef struct {
+    int board[ROWS][COLS];
+    int work[ROWS][COLS];
+    int row;
+    int col;
+    int depth;
+} BoardArg;
+
+// Arguments of the runtime-size searches
+typedef struct {
+    SizedBoard board;
+    bool generic;               // Searches the row lengths even if the board fits in a packed word
+} SizedArg;
+
+// Seed positions, shared with build/parallelBench: the start, then after a few opening moves
+static const char *POSITION_NAMES[] = {"opening", "middle", "late"};
+static Bitboard positions[3];
+
+static volatile int sink;       // Keeps the compiler from removing the benchmarked calls
+static double clockOverheadNs;  // Time a clock read around a single call adds to it, see calibrateClock()
+static int devNull = -1;        // The AI prints its moves, which the benchmarks must not measure
+static int savedStdout = -1;
+
+/**
+ * Returns the current time in nanoseconds.
+ *
+ * @return The value of the monotonic clock in nanoseconds.
+ */
+static int64_t nowNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/**
+ * Silences or restores the standard output.
+ *
+ * @param quiet True to send stdout to /dev/null, false to restore it.
+ */
+static void quietStdout(bool quiet) {
+    fflush(stdout);
+    if (quiet) {
+        if (devNull < 0) {
+            devNull = open("/dev/null", O_WRONLY);
+        }
+        savedStdout = dup(STDOUT_FILENO);
+        dup2(devNull, STDOUT_FILENO);
+    } else {
+        dup2(savedStdout, STDOUT_FILENO);
+        close(savedStdout);
+    }
+}
+
+/**
+ * Compares two doubles, for qsort().
+ *
+ * @param a A pointer to the first double.
+ * @param b A pointer to the second double.
+ * @return A negative, zero or positive value, as strcmp().
+ */
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Times calls of an operation. Without a setup, the whole batch is timed by one pair of clock reads;
+ * with a setup, only the calls to run are timed, each by its own pair.
+ *
+ * @param op The operation to time.
+ * @param iterations The number of calls.
+ * @return The time taken by the calls, in nanoseconds.
+ */
+static int64_t timeCalls(BenchOp op, uint64_t iterations) {
+    if (op.setup == NULL) {
+        int64_t start = nowNs();
+        for (uint64_t i = 0; i < iterations; i++) {
+            op.run(op.arg);
+        }
+        return nowNs() - start;
+    }
+    int64_t elapsed = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        op.setup(op.arg);
+        int64_t start = nowNs();
+        op.run(op.arg);
+        elapsed += nowNs() - start;
+    }
+    return elapsed;
+}
+
+/**
+ * Measures the time of an operation: each measurement doubles the number of calls until it lasts
+ * BENCH_MIN_NS, and the median of BENCH_REPEATS measurements is kept.
+ *
+ * @param op The operation to measure.
+ * @param iterations Receives the number of calls of the last measurement.
+ * @param allocs Receives the allocations of the last measurement.
+ * @return The median time of one call, in nanoseconds.
+ */
+static double medianNsPerOp(BenchOp op, uint64_t *iterations, uint64_t *allocs) {
+    double ns[BENCH_REPEATS];
+    *iterations = 1;
+
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        int64_t elapsed;
+        for (;;) {
+            uint64_t before = atomic_load(&allocations);
+            elapsed = timeCalls(op, *iterations);
+            *allocs = atomic_load(&allocations) - before;
+            if (elapsed >= BENCH_MIN_NS) {
+                break;
+            }
+            *iterations *= 2;
+        }
+        ns[r] = (double) elapsed / (double) *iterations;
+    }
+    qsort(ns, BENCH_REPEATS, sizeof(double), compareDoubles);
+    return ns[BENCH_REPEATS / 2];
+}
+
+/**
+ * Does nothing, the operation timed by calibrateClock().
+ *
+ * @param arg Unused.
+ */
+static void runNothing(void *arg) {
+    (void) arg;
+}
+
+/**
+ * Measures what timing a single call adds to it: the clock reads, and the call itself, of an empty
+ * operation with a setup. measure() subtracts it from the operations that have a setup.
+ */
+static void calibrateClock(void) {
+    uint64_t iterations, allocs;
+    clockOverheadNs = medianNsPerOp((BenchOp) {runNothing, runNothing, NULL}, &iterations, &allocs);
+    fprintf(stderr, "Timing a single call costs %.1f ns, subtracted from the operations with a setup\n",
+            clockOverheadNs);
+}
+
+/**
+ * Measures an operation with medianNsPerOp(), less the cost of the clock reads for an operation
+ * with a setup, and prints the result.
+ *
+ * @param name The name of the benchmark.
+ * @param op The operation to measure.
+ * @param nodes_per_op The positions searched by one call, 0 if the operation does not search.
+ * @param result Receives the measurement.
+ */
+static void measure(const char *name, BenchOp op, uint64_t nodes_per_op, BenchResult *result) {
+    uint64_t iterations, allocs;
+    double ns = medianNsPerOp(op, &iterations, &allocs);
+    if (op.setup != NULL) {
+        ns = ns > clockOverheadNs ? ns - clockOverheadNs : 0.0;
+    }
+
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->iterations = iterations;
+    result->ns_per_op = ns;
+    result->nodes_per_sec = ns > 0.0 ? nodes_per_op * 1e9 / ns : 0.0;
+    result->allocs_per_op = (double) allocs / (double) iterations;
+    fprintf(stderr, "%-36s %14.1f ns/op %14.0f nodes/s %8.2f allocs/op\n", result->name, result->ns_per_op,
+            result->nodes_per_sec, result->allocs_per_op);
+}
+
+/**
+ * Copies the benchmarked board into the working board, which destroySquares() modifies.
+ *
+ * @param arg A pointer to the BoardArg.
+ */
+static void copyBoard(void *arg) {
+    BoardArg *a = (BoardArg *) arg;
+    memcpy(a->work, a->board, sizeof(a->work));
+}
+
+/**
+ * Benchmarked call of destroySquares().
+ *
+ * @param arg A pointer to the BoardArg.
+ */
+static void runDestroySquares(void *arg) {
+    BoardArg *a = (BoardArg *) arg;
+    sink = destroySquares(a->work, a->row, a->col);
+}
+
+/**
+ * Benchmarked call of countSquares().
+ *
+ * @param arg A pointer to the BoardArg.
+ */
+static void runCountSquares(void *arg) {
+    BoardArg *a = (BoardArg *) arg;
+    sink = countSquares(a->board, a->row, a->col);
+}
+
+/**
+ * Benchmarked call of evaluateBoard().
+ *
+ * @param arg A pointer to the BoardArg.
+ */
+static void runEvaluateBoard(void *arg) {
+    BoardArg *a = (BoardArg *) arg;
+    sink = evaluateBoard(a->board);
+}
+
+/**
+ * Empties the AI's transposition table and reseeds the random generator, so every call searches
+ * the same tree as the first one.
+ *
+ * @param arg Unused.
+ */
+static void resetSearch(void *arg) {
+    (void) arg;
+    ttClear(aiTranspositionTable());
+    aiSetSeed(1);
+}
+
+/**
+ * Benchmarked call of minimax().
+ *
+ * @param arg A pointer to the BoardArg.
+ */
+static void runMinimax(void *arg) {
+    BoardArg *a = (BoardArg *) arg;
+    sink = minimax(a->board, a->depth, true, -INF, INF);
+}
+
+/**
+ * Benchmarked call of aiChooseMove().
+ *
+ * @param arg A pointer to the BoardArg.
+ */
+static void runAiChooseMove(void *arg) {
+    BoardArg *a = (BoardArg *) arg;
+    int row, col;
+    aiChooseMove(a->board, &row, &col);
+    sink = row * COLS + col;
+}
+
+/**
+ * Benchmarked call of sizedBoardNegamax() or sizedBoardNegamaxGeneric().
+ *
+ * @param arg A pointer to the SizedArg.
+ */
+static void runSizedNegamax(void *arg) {
+    SizedArg *a = (SizedArg *) arg;
+    uint64_t nodes = 0;
+    sink = a->generic ? sizedBoardNegamaxGeneric(&a->board, BENCH_SIZED_DEPTH, &nodes)
+                      : sizedBoardNegamax(&a->board, BENCH_SIZED_DEPTH, &nodes);
+}
+
+/**
+ * Counts the positions searched by minimax() from an empty table.
+ *
+ * @param board The bitboard of the position.
+ * @param depth The depth of the search.
+ * @return The number of positions visited.
+ */
+static uint64_t countNodes(Bitboard board, int depth) {
+    SearchContext ctx;
+    ttClear(aiTranspositionTable());
+    initSearchContext(&ctx, aiTranspositionTable(), 0);
+    minimaxContext(&ctx, board, depth, true, -INF, INF);
+    return ctx.nodes;
+}
+
+/**
+ * Writes the results as JSON, the input of scripts/benchCompare.py.
+ *
+ * @param path The output file, "-" for the standard output.
+ * @param results The benchmark results.
+ * @param count The number of results.
+ * @return True on success, false if the file could not be written.
+ */
+static bool writeJson(const char *path, BenchResult *results, int count) {
+    FILE *file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "{\n  \"board\": \"%dx%d\",\n  \"move_limit\": %d,\n  \"evaluator\": \"%s\",\n  \"benchmarks\": [\n",
+            ROWS, COLS, MOVE_LIMIT, aiEvaluator()->name);
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.1f, \"nodes_per_sec\": %.0f, "
+                      "\"allocs_per_op\": %.2f}%s\n",
+                results[i].name, (unsigned long long) results[i].iterations, results[i].ns_per_op,
+                results[i].nodes_per_sec, results[i].allocs_per_op, i + 1 < count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return file == stdout || fclose(file) == 0;
+}
+
+/**
+ * Entry point of the micro-benchmarks of the game core: destroySquares(), countSquares(), evaluateBoard(),
+ * minimax() at depths 1 to 8 and aiChooseMove(), on fixed seed positions, then the runtime-size search
+ * on 8x8 and 8x16 boards, packed into a word and on row lengths.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments, argv[1] being the JSON output path (default: bench.json).
+ * @return 0 on success, -1 if the results could not be written.
+ */
+int main(int argc, char *argv[]) {
+    const char *path = (argc >= 2) ? argv[1] : "bench.json";
+    BenchResult results[64];
+    int count = 0;
+    char name[64];
+    BoardArg arg;
+
+    positions[0] = BB_FULL;
+    positions[1] = BB_FULL & ~bitboardQuadrant(ROWS - 1, COLS - 3) & ~bitboardQuadrant(ROWS - 3, COLS - 1);
+    positions[2] = positions[1] & ~bitboardQuadrant(ROWS - 2, COLS - 5) & ~bitboardQuadrant(ROWS - 5, COLS - 2);
+    TranspositionTable *table = aiTranspositionTable();
+    ttFree(table);
+    ttInit(table, BENCH_TABLE_BITS);
+    calibrateClock();
+
+    for (int p = 0; p < 3; p++) {
+        bitboardToBoard(positions[p], arg.board);
+        Bitboard legal = bitboardLegalMoves(positions[p]) & ~BB_CELL(0, 0);
+        int cell = 63 - __builtin_clzll(legal);
+        arg.row = cell / COLS;
+        arg.col = cell % COLS;
+
+        snprintf(name, sizeof(name), "destroySquares/%s", POSITION_NAMES[p]);
+        measure(name, (BenchOp) {copyBoard, runDestroySquares, &arg}, 0, &results[count++]);
+        snprintf(name, sizeof(name), "countSquares/%s", POSITION_NAMES[p]);
+        measure(name, (BenchOp) {NULL, runCountSquares, &arg}, 0, &results[count++]);
+        snprintf(name, sizeof(name), "evaluateBoard/%s", POSITION_NAMES[p]);
+        measure(name, (BenchOp) {NULL, runEvaluateBoard, &arg}, 0, &results[count++]);
+
+        for (arg.depth = 1; arg.depth <= 8; arg.depth++) {
+            snprintf(name, sizeof(name), "minimax/depth=%d/%s", arg.depth, POSITION_NAMES[p]);
+            measure(name, (BenchOp) {resetSearch, runMinimax, &arg}, countNodes(positions[p], arg.depth),
+                    &results[count++]);
+        }
+
+        snprintf(name, sizeof(name), "aiChooseMove/%s", POSITION_NAMES[p]);
+        quietStdout(true);
+        resetSearch(NULL);
+        runAiChooseMove(&arg); // Once first, to know how many positions a call visits
+        measure(name, (BenchOp) {resetSearch, runAiChooseMove, &arg}, aiLastStats()->nodes, &results[count++]);
+        quietStdout(false);
+    }
+
+    // The packed search against the search on row lengths, which boards of more rows fall back to
+    int sizes[][2] = {{8, 8}, {8, 16}};
+    for (int s = 0; s < 2; s++) {
+        SizedArg sized = {.generic = false};
+        uint64_t nodes = 0;
+        sizedBoardInit(&sized.board, sizes[s][0], sizes[s][1]);
+        sizedBoardNegamax(&sized.board, BENCH_SIZED_DEPTH, &nodes);
+        for (int generic = 0; generic < 2; generic++) {
+            sized.generic = generic;
+            snprintf(name, sizeof(name), "sizedNegamax/%dx%d/%s", sizes[s][0], sizes[s][1], generic ? "generic" : "packed");
+            measure(name, (BenchOp) {NULL, runSizedNegamax, &sized}, nodes, &results[count++]);
+        }
+    }
+
+    if (!writeJson(path, results, count)) {
+        fprintf(stderr, "Could not write %s.\n", path);
+        return -1;
+    }
+    fprintf(stderr, "Results written to %s.\n", path);
+    return 0;
+}
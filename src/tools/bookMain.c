@@ -0,0 +1,152 @@
+#include "../../includes/bookMain.h"
+
+/**
+ * Scores every move of a position with a full-window search, and keeps the moves with the best score.
+ *
+ * @param ctx The search context of the thread.
+ * @param board The bitboard of the position.
+ * @param depth The depth of the search, the move included.
+ * @param entries Receives the best moves, at most BOOK_MAX_MOVES.
+ * @return The number of moves kept.
+ */
+static int searchPosition(SearchContext *ctx, Bitboard board, int depth, BookEntry *entries) {
+    uint32_t rank = staircaseRank(staircaseFromBitboard(board));
+    int best = -INF;
+    int count = 0;
+
+    Bitboard legal = bitboardLegalMoves(board) & ~BB_CELL(0, 0);
+    while (legal) {
+        int cell = __builtin_ctzll(legal);
+        legal &= legal - 1;
+        Bitboard child = board & ~bitboardQuadrant(cell / COLS, cell % COLS);
+        int value = minimaxContext(ctx, child, depth - 1, false, -INF, INF);
+        if (value > best) {
+            best = value;
+            count = 0;
+        }
+        if (value == best && count < BOOK_MAX_MOVES) {
+            entries[count++] = (BookEntry) {rank, (int16_t) value, (uint8_t) cell, 0};
+        }
+    }
+    return count;
+}
+
+/**
+ * Searches positions until none is left, taking the next one from the job.
+ *
+ * @param arg The BookJob.
+ * @return Always NULL.
+ */
+static void *bookWorker(void *arg) {
+    BookJob *job = (BookJob *) arg;
+    TranspositionTable table;
+    SearchContext ctx;
+
+    if (!ttInit(&table, BOOK_TABLE_BITS)) {
+        return NULL;
+    }
+    initSearchContext(&ctx, &table, 0);
+    for (int p = atomic_fetch_add(&job->next, 1); p < job->num_positions; p = atomic_fetch_add(&job->next, 1)) {
+        job->counts[p] = searchPosition(&ctx, job->positions[p], job->depth, &job->entries[p * BOOK_MAX_MOVES]);
+    }
+    ttFree(&table);
+    return NULL;
+}
+
+/**
+ * Prints the usage of the book generator.
+ *
+ * @param program The name of the program.
+ */
+static void printUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  -plies <k>          Cover the positions of the first <k> moves (default: %d)\n", BOOK_PLIES);
+    printf("  -depth <d>          Search every move to depth <d> (default: %d)\n", BOOK_DEPTH);
+    printf("  -threads <n>        Search positions on <n> threads (default: one per core)\n");
+    printf("  -eval <name>        Evaluation of the searches (default: %s)\n", EVAL_DEFAULT);
+    printf("  -out <path>         Output file (default: %s)\n", BOOK_OUT);
+}
+
+/**
+ * Entry point of the opening book generator: searches every position of the first moves deeply, and
+ * writes their best moves to the book that the game loads with the '-book' option.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments, see printUsage().
+ * @return 0 on success, 1 on a bad option or an output error.
+ */
+int main(int argc, char *argv[]) {
+    const char *path = BOOK_OUT;
+    int plies = BOOK_PLIES, depth = BOOK_DEPTH;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cores > 0 ? (int) cores : 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (value != NULL && strcmp(argv[i], "-plies") == 0 && atoi(value) > 0) {
+            plies = atoi(value);
+        } else if (value != NULL && strcmp(argv[i], "-depth") == 0 && atoi(value) > 0 && atoi(value) < 64) {
+            depth = atoi(value);
+        } else if (value != NULL && strcmp(argv[i], "-threads") == 0 && atoi(value) > 0) {
+            threads = atoi(value);
+        } else if (value != NULL && strcmp(argv[i], "-eval") == 0 && aiSetEvaluator(value)) {
+            // The threads' contexts take the AI's evaluator
+        } else if (value != NULL && strcmp(argv[i], "-out") == 0) {
+            path = value;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    BookJob job;
+    job.depth = depth;
+    job.num_positions = bookPositions(plies, &job.positions);
+    if (job.num_positions < 0) {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    job.entries = calloc((size_t) job.num_positions * BOOK_MAX_MOVES, sizeof(BookEntry));
+    job.counts = calloc(job.num_positions, sizeof(int));
+    pthread_t *workers = calloc(threads, sizeof(pthread_t));
+    if (job.entries == NULL || job.counts == NULL || workers == NULL) {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    atomic_init(&job.next, 0);
+
+    printf("Searching %d positions of the first %d moves to depth %d on %d threads...\n",
+           job.num_positions, plies, depth, threads);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&workers[t], NULL, bookWorker, &job);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    // Positions are already sorted by rank, and moves by cell within a position
+    uint32_t count = 0;
+    for (int p = 0; p < job.num_positions; p++) {
+        for (int i = 0; i < job.counts[p]; i++) {
+            job.entries[count++] = job.entries[p * BOOK_MAX_MOVES + i];
+        }
+    }
+    qsort(job.entries, count, sizeof(BookEntry), compareBookEntries);
+
+    bool ok = saveBook(job.entries, count, plies, depth, path);
+    if (ok) {
+        printf("%u moves of %d positions written to %s in %.1f s.\n", count, job.num_positions, path,
+               (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9);
+    } else {
+        printf("Could not write %s.\n", path);
+    }
+    free(workers);
+    free(job.counts);
+    free(job.entries);
+    free(job.positions);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#include "../../includes/indexMain.h"
+
+/**
+ * Prints the usage of the position indexer.
+ *
+ * @param program The name of the program.
+ */
+static void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options] <record file>...\n", program);
+    fprintf(stderr, "  Indexes every position of the %dx%d games of the record files written with -record\n", ROWS, COLS);
+    fprintf(stderr, "  -threads <n>        Replay the games on <n> threads (default: one per core)\n");
+    fprintf(stderr, "  -out <file>         Write the index to <file> (default: %s)\n", INDEX_DEFAULT_OUT);
+}
+
+/**
+ * Returns the time elapsed since a start time.
+ *
+ * @param start The start time, from CLOCK_MONOTONIC.
+ * @return The elapsed time in milliseconds.
+ */
+static double elapsedMs(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) * 1000.0 + (double) (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * Entry point of the position indexer: counts the positions of the recorded games by staircase rank on
+ * every core and writes one entry per distinct position, with its count and outcomes, for the game's '-index'.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments, see printUsage().
+ * @return 0 on success, 1 on a bad option, an unreadable record file or a failed write.
+ */
+int main(int argc, char *argv[]) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int num_threads = cores > 0 ? (int) cores : 1;
+    const char *out = INDEX_DEFAULT_OUT;
+    int first_file = 1;
+
+    while (first_file < argc && argv[first_file][0] == '-') {
+        const char *value = first_file + 1 < argc ? argv[first_file + 1] : NULL;
+        if (value != NULL && strcmp(argv[first_file], "-threads") == 0 && atoi(value) > 0) {
+            num_threads = atoi(value);
+        } else if (value != NULL && strcmp(argv[first_file], "-out") == 0) {
+            out = value;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        first_file += 2;
+    }
+    if (first_file == argc) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Map every record file
+    int num_files = argc - first_file;
+    RecordFile files[num_files];
+    for (int i = 0; i < num_files; i++) {
+        if (!loadRecords(&files[i], argv[first_file + i])) {
+            for (int j = 0; j < i; j++) {
+                freeRecords(&files[j]);
+            }
+            return 1;
+        }
+    }
+
+    // Count the positions by rank, one set of counts per thread whatever the number of games
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    PositionEntry *entries = calloc(staircaseCount(), sizeof(PositionEntry));
+    uint64_t count = 0;
+    uint32_t games = 0;
+    bool counted = entries != NULL && recordIndexPositions(files, num_files, num_threads, entries, &games, &count);
+    for (int i = 0; i < num_files; i++) {
+        freeRecords(&files[i]);
+    }
+    if (!counted) {
+        fprintf(stderr, "Not enough memory to count the positions on %d threads.\n", num_threads);
+        free(entries);
+        return 1;
+    }
+    uint32_t num_entries = buildPositionIndex(entries);
+
+    bool saved = savePositionIndex(entries, num_entries, games, out);
+    free(entries);
+    if (!saved) {
+        fprintf(stderr, "Could not write %s.\n", out);
+        return 1;
+    }
+    printf("Indexed %llu positions of %u games: %u distinct, written to %s in %.1f ms on %d threads\n",
+           (unsigned long long) count, games, num_entries, out, elapsedMs(&start), num_threads);
+    return 0;
+}
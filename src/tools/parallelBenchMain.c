@@ -0,0 +1,117 @@
+#include "../../includes/parallelBenchMain.h"
+
+// Thread counts compared with the sequential search
+static const int THREAD_COUNTS[] = {1, 2, 4, 8, 16};
+
+/**
+ * Returns the time elapsed since a starting point.
+ *
+ * @param start The starting point (CLOCK_MONOTONIC).
+ * @return The elapsed time in seconds.
+ */
+static double secondsSince(struct timespec start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start.tv_sec) + (double) (now.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/**
+ * Runs the sequential minimax from an empty transposition table.
+ *
+ * @param ctx The search context, counting the nodes.
+ * @param board The bitboard of the position.
+ * @param depth The depth of the search.
+ * @param time Receives the duration of the search in seconds.
+ * @return The score of the position.
+ */
+static int sequentialSearch(SearchContext *ctx, Bitboard board, int depth, double *time) {
+    struct timespec start;
+
+    initSearchContext(ctx, aiTranspositionTable(), 0);
+    ttClear(ctx->table);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int score = minimaxContext(ctx, board, depth, true, -INF, INF);
+    *time = secondsSince(start);
+    return score;
+}
+
+/**
+ * Benchmarks one position: the sequential minimax as reference, then the work-stealing search
+ * at every thread count, each starting from an empty transposition table.
+ *
+ * @param name The name of the position, printed in the report.
+ * @param board The bitboard of the position.
+ * @param depth The depth of the searches, 0 to deepen the sequential search one ply at a time until
+ *              it takes PARALLEL_BENCH_MIN_SECONDS (or searches to the end of the game), so that
+ *              starting the threads does not dominate the parallel searches.
+ * @return True if every parallel search returned the reference score, false otherwise.
+ */
+static bool benchPosition(const char *name, Bitboard board, int depth) {
+    SearchContext ctx;
+    struct timespec start;
+    double ref_time;
+    int reference;
+
+    if (depth > 0) {
+        reference = sequentialSearch(&ctx, board, depth, &ref_time);
+    } else {
+        int squares = __builtin_popcountll(board);
+        do {
+            depth++;
+            reference = sequentialSearch(&ctx, board, depth, &ref_time);
+        } while (ref_time < PARALLEL_BENCH_MIN_SECONDS && depth < squares);
+    }
+    printf("%-10s depth %d  sequential   score %4d  %10llu nodes  %8.3f s  %12.0f nodes/s\n",
+           name, depth, reference, (unsigned long long) ctx.nodes, ref_time, ctx.nodes / ref_time);
+
+    bool ok = true;
+    for (size_t t = 0; t < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); t++) {
+        YbwcSearch search;
+        if (!ybwcInit(&search, THREAD_COUNTS[t], TT_DEFAULT_BITS)) {
+            printf("Could not start %d threads.\n", THREAD_COUNTS[t]);
+            return false;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int score = ybwcMinimax(&search, board, depth, true, -INF, INF);
+        double time = secondsSince(start);
+        uint64_t nodes = ybwcNodes(&search);
+        uint64_t steals = 0;
+        for (int w = 0; w < search.num_workers; w++) {
+            steals += search.workers[w].steals;
+        }
+        ybwcDestroy(&search);
+
+        printf("%-10s depth %d  ybwc %2d thr  score %4d  %10llu nodes  %8.3f s  %12.0f nodes/s  speedup %5.2f  steals %llu%s\n",
+               name, depth, THREAD_COUNTS[t], score, (unsigned long long) nodes, time, nodes / time,
+               ref_time / time, (unsigned long long) steals, score == reference ? "" : "  MISMATCH");
+        ok = ok && score == reference;
+    }
+    return ok;
+}
+
+/**
+ * Entry point of the parallel benchmark: compares the sequential Minimax with the Young Brothers Wait
+ * work-stealing search on a few positions, reporting nodes per second and speedup per thread count.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments, argv[1] being the optional search depth (by default, each
+ *             position is searched deep enough for the sequential search to take PARALLEL_BENCH_MIN_SECONDS).
+ * @return 0 if every parallel score matched the sequential one, -1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+    int depth = (argc >= 2) ? atoi(argv[1]) : 0;
+    if (argc >= 2 && depth < 1) {
+        printf("Usage: %s [depth]\n", argv[0]);
+        return -1;
+    }
+
+    // Starting position, then two positions after a few opening moves
+    Bitboard opening = BB_FULL;
+    Bitboard middle = BB_FULL & ~bitboardQuadrant(ROWS - 1, COLS - 3) & ~bitboardQuadrant(ROWS - 3, COLS - 1);
+    Bitboard late = middle & ~bitboardQuadrant(ROWS - 2, COLS - 5) & ~bitboardQuadrant(ROWS - 5, COLS - 2);
+
+    bool ok = benchPosition("opening", opening, depth);
+    ok = benchPosition("middle", middle, depth) && ok;
+    ok = benchPosition("late", late, depth) && ok;
+    return ok ? 0 : -1;
+}
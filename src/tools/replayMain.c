@@ -0,0 +1,117 @@
+#include "../../includes/replayMain.h"
+
+/**
+ * Prints the usage of the replay tool.
+ *
+ * @param program The name of the program.
+ */
+static void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s <file> [<game> [<ply>]]\n", program);
+    fprintf(stderr, "  Without a game, checks every game of the record file and prints a summary\n");
+    fprintf(stderr, "  <game>   Print the moves of game <game>, from 0, and its board after the last move\n");
+    fprintf(stderr, "  <ply>    Print its board after <ply> moves instead\n");
+}
+
+/**
+ * Checks every game of a record file and prints how many there are, how they ended and how long
+ * replaying them took.
+ *
+ * @param file The record file.
+ * @return 0 if every game is valid, 1 otherwise.
+ */
+static int printSummary(const RecordFile *file) {
+    uint64_t moves = 0, invalid = 0, losses[2] = {0, 0};
+    RecordReplay replay;
+    RecordGame game;
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint64_t i = 0; i < file->count; i++) {
+        recordGameAt(file, i, &game);
+        if (!replayInit(&replay, &game)) {
+            printf("Game %llu is invalid.\n", (unsigned long long) i);
+            invalid++;
+            continue;
+        }
+        moves += (uint64_t) game.num_moves;
+        if (game.loser != RECORD_UNFINISHED) {
+            losses[game.loser]++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed_ms = (double) (end.tv_sec - start.tv_sec) * 1000.0 + (double) (end.tv_nsec - start.tv_nsec) / 1e6;
+
+    printf("%llu games, %llu moves, checked in %.1f ms\n", (unsigned long long) file->count,
+           (unsigned long long) moves, elapsed_ms);
+    printf("First player won %llu, second player won %llu, unfinished %llu, invalid %llu\n",
+           (unsigned long long) losses[RECORD_SECOND_LOSES], (unsigned long long) losses[RECORD_FIRST_LOSES],
+           (unsigned long long) (file->count - invalid - losses[0] - losses[1]), (unsigned long long) invalid);
+    return invalid > 0 ? 1 : 0;
+}
+
+/**
+ * Prints the moves of a game and its board after a number of moves.
+ *
+ * @param game The game.
+ * @param ply The number of moves played, -1 for the whole game.
+ * @return 0 on success, 1 if the game is invalid or shorter than 'ply'.
+ */
+static int printGame(const RecordGame *game, int ply) {
+    RecordReplay replay;
+    SizedBoard board;
+    if (!replayInit(&replay, game)) {
+        printf("The game is invalid.\n");
+        return 1;
+    }
+    if (ply < 0) {
+        ply = game->num_moves;
+    }
+    if (!replaySeek(&replay, ply, &board)) {
+        printf("The game only has %d moves.\n", game->num_moves);
+        return 1;
+    }
+
+    printf("%dx%d board, %d moves, %s\n", game->rows, game->cols, game->num_moves,
+           game->loser == RECORD_UNFINISHED ? "unfinished" :
+           game->loser == RECORD_FIRST_LOSES ? "second player won" : "first player won");
+    for (int i = 0; i < game->num_moves; i++) {
+        printf("%s%c%d", i > 0 ? " " : "", 'A' + game->moves[i] % game->cols, game->moves[i] / game->cols + 1);
+    }
+    printf("\n\nAfter %d moves:\n", ply);
+    sizedBoardDisplay(&board);
+    return 0;
+}
+
+/**
+ * Entry point of the replay tool: reads a record file written with the game's '-record' option
+ * and prints a summary of its games, or one game at any ply.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments, see printUsage().
+ * @return 0 on success, 1 on a bad argument or an invalid record file.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    RecordFile file;
+    if (!loadRecords(&file, argv[1])) {
+        return 1;
+    }
+
+    int status;
+    RecordGame game;
+    if (argc == 2) {
+        status = printSummary(&file);
+    } else if (recordGameAt(&file, strtoull(argv[2], NULL, 10), &game)) {
+        status = printGame(&game, argc == 4 ? atoi(argv[3]) : -1);
+    } else {
+        printf("The file has %llu games.\n", (unsigned long long) file.count);
+        status = 1;
+    }
+
+    freeRecords(&file);
+    return status;
+}
@@ -0,0 +1,265 @@
+#include "../../includes/selfplayMain.h"
+
+/**
+ * Returns the time elapsed since a starting point.
+ *
+ * @param start The starting point (CLOCK_MONOTONIC).
+ * @return The elapsed time in seconds.
+ */
+static double secondsSince(struct timespec start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start.tv_sec) + (double) (now.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/**
+ * Plays one AI-vs-AI game from the full board. Each side searches with its own depth, evaluator,
+ * seed and transposition table, through aiSearchMove() (the silent core of aiChooseMove()), and moves
+ * are played with destroySquares(). The side that eats A1 loses.
+ *
+ * @param tournament The tournament settings.
+ * @param game The number of the game, which picks the side moving first and the seeds.
+ * @param tables The transposition tables of sides A and B.
+ * @param result Filled with the result of the game.
+ */
+static void playGame(Tournament *tournament, int game, TranspositionTable tables[2], GameResult *result) {
+    int board[ROWS][COLS];
+    Rng rngs[2];
+
+    memset(result, 0, sizeof(GameResult));
+    result->first = game % 2;
+    for (int side = 0; side < 2; side++) {
+        ttClear(&tables[side]);
+        rngSeedStream(&rngs[side], tournament->sides[side].seed, (uint64_t) game);
+    }
+    initBoard(board);
+
+    int side = result->first;
+    while (board[0][0] == 1) {
+        SearchContext ctx;
+        struct timespec start;
+        int row, col;
+
+        initSearchContext(&ctx, &tables[side], 0);
+        ctx.root_threads = false;
+        ctx.evaluator = tournament->sides[side].evaluator;
+        ctx.max_depth = tournament->sides[side].depth;
+        ctx.rng = &rngs[side];
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        aiSearchMove(&ctx, boardToBitboard(board), &row, &col);
+        result->seconds[side] += secondsSince(start);
+        result->nodes[side] += ctx.nodes;
+        result->moves[side]++;
+        result->plies++;
+
+        if (row < 0 || !destroySquares(board, row, col)) {
+            // No legal move was found: the side loses, as if it had eaten A1
+            break;
+        }
+        if (board[0][0] == 1) {
+            side = 1 - side;
+        }
+    }
+    result->winner = 1 - side;
+}
+
+/**
+ * Plays games until none are left, taking the next game number from the tournament.
+ *
+ * @param arg The Tournament.
+ * @return Always NULL.
+ */
+static void *selfplayWorker(void *arg) {
+    Tournament *tournament = (Tournament *) arg;
+    TranspositionTable tables[2];
+
+    if (!ttInit(&tables[0], SELFPLAY_TABLE_BITS) || !ttInit(&tables[1], SELFPLAY_TABLE_BITS)) {
+        ttFree(&tables[0]);
+        return NULL;
+    }
+    for (int game = atomic_fetch_add(&tournament->next_game, 1); game < tournament->num_games;
+         game = atomic_fetch_add(&tournament->next_game, 1)) {
+        playGame(tournament, game, tables, &tournament->results[game]);
+    }
+    ttFree(&tables[0]);
+    ttFree(&tables[1]);
+    return NULL;
+}
+
+/**
+ * Writes one CSV row per game: who moved first and won, the length of the game, and the nodes
+ * searched and the time per move of each side.
+ *
+ * @param path The output path, "-" for the standard output.
+ * @param tournament The tournament, once played.
+ * @return True on success, false otherwise.
+ */
+static bool writeCsv(const char *path, Tournament *tournament) {
+    FILE *file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "game,first,winner,plies,moves_a,moves_b,nodes_a,nodes_b,ms_per_move_a,ms_per_move_b\n");
+    for (int game = 0; game < tournament->num_games; game++) {
+        GameResult *r = &tournament->results[game];
+        fprintf(file, "%d,%c,%c,%d,%d,%d,%llu,%llu,%.3f,%.3f\n", game, 'A' + r->first, 'A' + r->winner, r->plies,
+                r->moves[0], r->moves[1], (unsigned long long) r->nodes[0], (unsigned long long) r->nodes[1],
+                r->moves[0] > 0 ? 1000.0 * r->seconds[0] / r->moves[0] : 0.0,
+                r->moves[1] > 0 ? 1000.0 * r->seconds[1] / r->moves[1] : 0.0);
+    }
+    return file == stdout || fclose(file) == 0;
+}
+
+/**
+ * Prints the win rates, the average game length, and the nodes and time per move of each side.
+ *
+ * @param tournament The tournament, once played.
+ * @param seconds The wall-clock time of the tournament.
+ */
+static void printSummary(Tournament *tournament, double seconds) {
+    int wins[2] = {0, 0};
+    int first_wins = 0;
+    long plies = 0;
+    long moves[2] = {0, 0};
+    uint64_t nodes[2] = {0, 0};
+    double time[2] = {0, 0};
+
+    for (int game = 0; game < tournament->num_games; game++) {
+        GameResult *r = &tournament->results[game];
+        wins[r->winner]++;
+        first_wins += r->winner == r->first;
+        plies += r->plies;
+        for (int side = 0; side < 2; side++) {
+            moves[side] += r->moves[side];
+            nodes[side] += r->nodes[side];
+            time[side] += r->seconds[side];
+        }
+    }
+
+    int n = tournament->num_games;
+    printf("%d games in %.2f s (%.1f games/s), %.1f plies per game, first player wins %.1f%%\n",
+           n, seconds, n / seconds, (double) plies / n, 100.0 * first_wins / n);
+    for (int side = 0; side < 2; side++) {
+        SideConfig *config = &tournament->sides[side];
+        printf("  %c: depth %d, %-9s seed %-10llu wins %5.1f%%  %10.0f nodes/move  %8.3f ms/move\n",
+               'A' + side, config->depth, config->evaluator->name, (unsigned long long) config->seed,
+               100.0 * wins[side] / n,
+               moves[side] > 0 ? (double) nodes[side] / moves[side] : 0.0,
+               moves[side] > 0 ? 1000.0 * time[side] / moves[side] : 0.0);
+    }
+}
+
+/**
+ * Prints the usage of the self-play runner.
+ *
+ * @param program The name of the program.
+ */
+static void printUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  -games <n>          Number of games (default: %d)\n", SELFPLAY_GAMES);
+    printf("  -threads <n>        Games played at the same time (default: one per core)\n");
+    printf("  -depth <d>          Search depth of both sides (default: %d), or -depthA/-depthB per side\n", MAX_DEPTH);
+    printf("  -eval <name>        Evaluator of both sides (default: %s), or -evalA/-evalB per side\n", EVAL_DEFAULT);
+    printf("  -seed <s>           Base seed of both sides (default: 1 and 2), or -seedA/-seedB per side\n");
+    printf("  -out <path>         CSV output, '-' for the standard output (default: %s)\n", SELFPLAY_OUT);
+}
+
+/**
+ * Entry point of the self-play runner: plays AI-vs-AI games on every core without any console output
+ * from the games, then writes one CSV row per game and prints a summary. Sides alternate moving first.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments, see printUsage().
+ * @return 0 on success, 1 on a bad option or an output error.
+ */
+int main(int argc, char *argv[]) {
+    Tournament tournament;
+    const char *path = SELFPLAY_OUT;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cores > 0 ? (int) cores : 1;
+
+    memset(&tournament, 0, sizeof(Tournament));
+    tournament.num_games = SELFPLAY_GAMES;
+    for (int side = 0; side < 2; side++) {
+        tournament.sides[side] = (SideConfig) {MAX_DEPTH, evaluatorByName(EVAL_DEFAULT), (unsigned int) side + 1};
+    }
+
+    for (int i = 1; i < argc; i++) {
+        const char *option = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        size_t length = strlen(option);
+        char last = length > 0 ? option[length - 1] : 0;
+        // "-depthA" and "-depthB" set one side, "-depth" both
+        int first = 0, count = 2;
+        char name[16];
+        if (length < sizeof(name) && (last == 'A' || last == 'B')) {
+            first = last - 'A';
+            count = 1;
+            length--;
+        }
+        snprintf(name, sizeof(name), "%.*s", (int) length, option);
+        if (value == NULL) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;
+
+        for (int side = first; side < first + count; side++) {
+            SideConfig *config = &tournament.sides[side];
+            if (strcmp(name, "-depth") == 0 && atoi(value) > 0) {
+                config->depth = atoi(value);
+            } else if (strcmp(name, "-eval") == 0 && evaluatorByName(value) != NULL) {
+                config->evaluator = evaluatorByName(value);
+            } else if (strcmp(name, "-seed") == 0) {
+                config->seed = strtoull(value, NULL, 10);
+            } else if (count == 2 && strcmp(name, "-games") == 0 && atoi(value) > 0) {
+                tournament.num_games = atoi(value);
+            } else if (count == 2 && strcmp(name, "-threads") == 0 && atoi(value) > 0) {
+                threads = atoi(value);
+            } else if (count == 2 && strcmp(name, "-out") == 0) {
+                path = value;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    }
+
+    tournament.results = calloc(tournament.num_games, sizeof(GameResult));
+    pthread_t *workers = calloc(threads, sizeof(pthread_t));
+    if (tournament.results == NULL || workers == NULL) {
+        printf("Out of memory.\n");
+        return 1;
+    }
+    atomic_init(&tournament.next_game, 0);
+
+    // The games print nothing, but the stdout of the search code is silenced anyway
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    int dev_null = open("/dev/null", O_WRONLY);
+    dup2(dev_null, STDOUT_FILENO);
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&workers[t], NULL, selfplayWorker, &tournament);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    close(dev_null);
+    double seconds = secondsSince(start);
+
+    printSummary(&tournament, seconds);
+    bool ok = writeCsv(path, &tournament);
+    if (!ok) {
+        printf("Could not write %s.\n", path);
+    } else if (strcmp(path, "-") != 0) {
+        printf("Results written to %s\n", path);
+    }
+    free(workers);
+    free(tournament.results);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include "../../includes/solverMain.h"
+
+/**
+ * Maps a solution table and checks its header and its checksum.
+ *
+ * @param path The path of the solution table file.
+ * @return 0 if the table is valid for this board, -1 otherwise.
+ */
+static int verifyMain(const char *path) {
+    SolutionTable table;
+    if (!loadSolution(&table, path)) {
+        return -1;
+    }
+    bool ok = verifySolution(&table);
+    printf("%s: %u positions, checksum %s.\n", path, table.count, ok ? "OK" : "MISMATCH");
+    freeSolution(&table);
+    return ok ? 0 : -1;
+}
+
+/**
+ * Entry point of the solver: solves every position of the board and writes the solution table
+ * that the game loads with the '-solution' option, or checks an existing table with '-verify'.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The array of command-line arguments: the optional output path, or '-verify' and the path to check.
+ * @return 0 on success, -1 on failure.
+ */
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "-verify") == 0) {
+        return verifyMain(argv[2]);
+    }
+    const char *path = (argc >= 2) ? argv[1] : "chomp.sol";
+    SolutionTable table;
+
+    printf("Solving the %dx%d board (%u positions, at most %d squares per move)...\n",
+           ROWS, COLS, staircaseCount(), MOVE_LIMIT);
+    if (!solveChomp(&table)) {
+        printf("Not enough memory to solve the board.\n");
+        return -1;
+    }
+
+    bool win;
+    int distance;
+    lookupSolution(&table, BB_FULL, &win, &distance);
+    printf("Starting position: the first player %s in %d moves.\n", win ? "wins" : "loses", distance);
+
+    if (!saveSolution(&table, path)) {
+        printf("Could not write %s.\n", path);
+        freeSolution(&table);
+        return -1;
+    }
+    printf("Solution table written to %s.\n", path);
+    freeSolution(&table);
+    return 0;
+}